@@ -13,9 +13,12 @@ fi
 if [[ $(uname -m) == "arm64" ]]; then
     echo "✓ Detected Apple Silicon (M1/M2/M3)"
     ARCH_FLAG="-mcpu=apple-m1"
+    X86_SOURCES=""
 else
     echo "✓ Detected Intel Mac"
     ARCH_FLAG="-march=native"
+    # the BCSR kernels are AVX2 only, main.cpp calls them on x86_64
+    X86_SOURCES="sparse/bcsr.c sparse/tbcsr.c"
 fi
 
 # Function to check if command exists
@@ -76,7 +79,7 @@ echo "=== Configuring build ==="
 
 BASE_FLAGS="-O3 -ffast-math $ARCH_FLAG -std=c++17"
 INCLUDE_FLAGS="-I."
-SOURCE_FILES="main.cpp dense/dense.c sparse/tcsc.c"
+SOURCE_FILES="main.cpp dense/dense.c sparse/tcsc.c sparse/tcsc2.c sparse/tcsc_seg.c sparse/tbitmap.c sparse/tlut.c sparse/tcsc_parallel.c sparse/tpool.c sparse/tsched.c sparse/tcsc_fused.c sparse/tcsc_int.c sparse/tcsc_half.c sparse/tdense8.c sparse/tbitact.c sparse/tcsr.c sparse/tsell.c $X86_SOURCES"
 
 if [[ "$PAPI_AVAILABLE" == true ]]; then
     echo "✓ Building with PAPI support"
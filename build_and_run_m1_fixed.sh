@@ -13,9 +13,12 @@ fi
 if [[ $(uname -m) == "arm64" ]]; then
     echo "✓ Detected Apple Silicon (M1/M2/M3)"
     ARCH_FLAG="-mcpu=apple-m1"
+    X86_SOURCES=""
 else
     echo "✓ Detected Intel Mac"
     ARCH_FLAG="-march=native"
+    # the BCSR kernels are AVX2 only, main.cpp calls them on x86_64
+    X86_SOURCES="sparse/bcsr.c sparse/tbcsr.c"
 fi
 
 # Function to check if command exists
@@ -99,13 +102,14 @@ fi
 
 # Individual compilation commands
 COMPILE_DENSE_CMD="gcc $BASE_FLAGS_C $INCLUDE_FLAGS -c dense/dense.c -o dense/dense.o"
-COMPILE_TCSC_CMD="gcc $BASE_FLAGS_C $INCLUDE_FLAGS -c sparse/tcsc.c -o sparse/tcsc.o"
+SPARSE_SOURCES="sparse/tcsc.c sparse/tcsc2.c sparse/tcsc_seg.c sparse/tbitmap.c sparse/tlut.c sparse/tcsc_parallel.c sparse/tpool.c sparse/tsched.c sparse/tcsc_fused.c sparse/tcsc_int.c sparse/tcsc_half.c sparse/tdense8.c sparse/tbitact.c sparse/tcsr.c sparse/tsell.c $X86_SOURCES"
+SPARSE_OBJECTS="${SPARSE_SOURCES//.c/.o}"
 COMPILE_MAIN_CMD="g++ $BASE_FLAGS_CXX $INCLUDE_FLAGS -c main.cpp -o main.o"
-LINK_CMD="g++ $BASE_FLAGS_CXX main.o dense/dense.o sparse/tcsc.o $LINK_PAPI_LIBS -o tcsc_benchmark"
+LINK_CMD="g++ $BASE_FLAGS_CXX main.o dense/dense.o $SPARSE_OBJECTS $LINK_PAPI_LIBS -o tcsc_benchmark"
 
 echo "Compile commands:"
 echo "  Dense: $COMPILE_DENSE_CMD"
-echo "  TCSC:  $COMPILE_TCSC_CMD"
+echo "  Sparse: gcc $BASE_FLAGS_C $INCLUDE_FLAGS -c <src> for $SPARSE_SOURCES"
 echo "  PAPI:  $COMPILE_PAPI_CMD"
 echo "  Main:  $COMPILE_MAIN_CMD"
 echo "  Link:  $LINK_CMD"
@@ -127,13 +131,15 @@ else
     exit 1
 fi
 
-echo "Compiling tcsc.c..."
-if eval $COMPILE_TCSC_CMD; then
-    echo "✓ tcsc.c compiled successfully"
-else
-    echo "❌ Failed to compile tcsc.c"
-    exit 1
-fi
+for src in $SPARSE_SOURCES; do
+    echo "Compiling $src..."
+    if gcc $BASE_FLAGS_C $INCLUDE_FLAGS -c "$src" -o "${src%.c}.o"; then
+        echo "✓ $src compiled successfully"
+    else
+        echo "❌ Failed to compile $src"
+        exit 1
+    fi
+done
 
 echo "Compiling my_papi.c..."
 if eval $COMPILE_PAPI_CMD; then
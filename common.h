@@ -12,6 +12,12 @@ typedef void (*prelu_func)(
     const dense_t X, const void *W, const dense_t B, float a, dense_t Y,
     int M, int N, int K
 );
+// function pointer for gemm prelu computations with one slope per output
+// channel (alpha has N elements)
+typedef void (*prelu_channel_func)(
+    const dense_t X, const void *W, const dense_t B, const float *alpha, dense_t Y,
+    int M, int N, int K
+);
 
 template <typename FuncType>
 void add_func(FuncType f, std::string name);
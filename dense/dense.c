@@ -18,6 +18,22 @@ dense_t init_rand_dense(int rows, int cols) {
     return m;
 }
 
+/*
+ * Initialize elements uniformly at random in [-1, +1) with probability
+ * density and to exactly 0 otherwise, e.g. activations after a ReLU or
+ * one-hot inputs
+ */
+dense_t init_rand_dense_density(int rows, int cols, float density) {
+    dense_t m;
+    // Use posix_memalign for better macOS compatibility
+    if (posix_memalign((void**)&m, 32, rows * cols * sizeof(dense_elem_t)) != 0) {
+        perror("posix_memalign failed @ init_rand_dense_density()");
+        exit(EXIT_FAILURE);
+    }
+    rands_dense_density<dense_elem_t>(m, rows, cols, density);
+    return m;
+}
+
 /*
  * Initialize elements in {-1, 0, +1} with non-uniform probabilities 
  * as defined by parameter non_zero. Meaning
@@ -36,6 +52,22 @@ dense_t init_rand_sparse(int rows, int cols, int non_zero) {
     return m;
 }
 
+/*
+ * Initialize elements in {-1, 0, +1} like init_rand_sparse, with the
+ * density of every column drawn from a log-normal distribution of
+ * parameter skew (mean density stays 1 / non_zero)
+ */
+dense_t init_rand_sparse_skewed(int rows, int cols, int non_zero, float skew) {
+    dense_t m;
+    // Use posix_memalign for better macOS compatibility
+    if (posix_memalign((void**)&m, 32, rows * cols * sizeof(dense_elem_t)) != 0) {
+        perror("posix_memalign failed @ init_rand_sparse_skewed()");
+        exit(EXIT_FAILURE);
+    }
+    rands_sparse_skewed<dense_elem_t>(m, rows, cols, non_zero, skew);
+    return m;
+}
+
 /*
  * Comparison of two dense matrices
  */
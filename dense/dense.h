@@ -10,7 +10,9 @@ dense_t dense_random(int rows, int cols);
 bool compare(const dense_t result, const dense_t target, int rows, int cols);
 
 dense_t init_rand_dense(int rows, int cols);
+dense_t init_rand_dense_density(int rows, int cols, float density);
 dense_t init_rand_sparse(int rows, int cols, int non_zero);
+dense_t init_rand_sparse_skewed(int rows, int cols, int non_zero, float skew);
 
 // NOTE:
 //  dense_t* should be used to eventually make dense_t a struct in the future,
@@ -1,5 +1,6 @@
 #pragma once
 #include <random>
+#include <vector>
 #include <math.h>
 #include "dense.h"
 
@@ -15,6 +16,20 @@ void rands_dense(T *m, int rows, int cols) {
         m[i] = dist(gen);
 }
 
+/*
+ * Generate random numbers in [-1, +1) with probability density, 0 with
+ * probability 1 - density
+ */
+template<typename T>
+void rands_dense_density(T *m, int rows, int cols, float density) {
+    std::random_device rd;
+    std::mt19937 gen{rd()};
+    std::uniform_real_distribution<T> dist(-1.0, 1.0);
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+    for (size_t i = 0; i < (size_t) rows * cols; ++i)
+        m[i] = (uniform(gen) < density) ? dist(gen) : 0;
+}
+
 // TODO: OBSOLETE CODE TO BE DELETED
 // /*
 //  * Rounds float to n_digits-th digit after decimal point.
@@ -66,3 +81,41 @@ void rands_sparse(T *m, int rows, int cols, int non_zero) {
     for (size_t i = 0; i < rows * cols; ++i)
         m[i] = dist(gen) - 1.0; // subtract offset to get elements in -1, 0, +1
 }
+
+/*
+ * Same values as rands_sparse, but the density varies between columns:
+ * column n holds non-zeros with probability w_n / non_zero where the
+ * weights w_n are log-normal with parameter sigma = skew, normalized to a
+ * mean of 1 (and capped so that no probability exceeds 1). skew = 0 gives
+ * the uniform generator, skew around 1 a long tail of heavy columns.
+ */
+template<typename T>
+void rands_sparse_skewed(T *m, int rows, int cols, int non_zero, float skew) {
+    std::random_device rd;
+    std::mt19937 gen{rd()};
+
+    std::lognormal_distribution<float> weight_dist(0.0f, skew);
+    std::vector<float> p_col(cols);
+    double sum = 0.0;
+    for (int col = 0; col < cols; ++col) {
+        p_col[col] = weight_dist(gen);
+        sum += p_col[col];
+    }
+    for (int col = 0; col < cols; ++col) {
+        float p = (float) (p_col[col] * cols / sum) / non_zero;
+        p_col[col] = (p < 1.0f) ? p : 1.0f;
+    }
+
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            float u = uniform(gen);
+            // lower half of [0, p) gives +1, upper half -1
+            T val = 0;
+            if (u < p_col[col]) {
+                val = (u < 0.5f * p_col[col]) ? 1.0 : -1.0;
+            }
+            m[(size_t) row * cols + col] = val;
+        }
+    }
+}
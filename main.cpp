@@ -21,10 +21,30 @@
 #include <vector>
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
+#include <thread>
 
 #include "common.h"
 #include "dense/dense.h"
 #include "sparse/tcsc.h"
+#include "sparse/tcsc2.h"
+#include "sparse/tcsc_seg.h"
+#include "sparse/tbitmap.h"
+#include "sparse/tlut.h"
+#include "sparse/tcsc_parallel.h"
+#include "sparse/tpool.h"
+#include "sparse/tsched.h"
+#include "sparse/tcsc_fused.h"
+#include "sparse/tcsc_int.h"
+#include "sparse/tcsc_half.h"
+#include "sparse/tdense8.h"
+#include "sparse/tbitact.h"
+#include "sparse/tcsr.h"
+#include "sparse/tsell.h"
+#ifdef __x86_64__
+#include "sparse/bcsr.h"
+#include "sparse/tbcsr.h"
+#endif
 #include "measure.h"
 #include "progress_bar.h"
 #include <string>
@@ -174,6 +194,1099 @@ double measure_tcsc_prelu_cycles(void (*func)(const dense_t, const tcsc_t*, cons
     return cycles;
 }
 
+// Sweeps the density of W for one shape to find where the index-free
+// formats overtake the TCSC kernels
+void run_density_sweep(int M, int K, int N) {
+    cout << "\n[*] DENSITY SWEEP (M=" << M << ", K=" << K << ", N=" << N << "):\n";
+
+    const dense_t X = init_rand_dense(M, K);
+    const dense_t B = init_rand_dense(N, 1);
+    dense_elem_t *Y;
+    build_and_check(&Y, M, N);
+
+    // 1 until the format wins at the densest W, then the lowest density
+    // down to which it kept winning
+    int bitmap_wins_down_to = 1;
+    int lut_wins_down_to = 1;
+    for (int non_zero : {2, 4, 8, 16, 32}) {
+        const dense_t W_dense = init_rand_sparse(K, N, non_zero);
+        tcsc_t *W_tsparse = tcsc_from_dense(W_dense, K, N);
+        const tbitmap_t *W_bitmap = tbitmap_from_tcsc(W_tsparse);
+        const tlut_t *W_lut = tlut_from_tcsc(W_tsparse, tlut_preferred_group());
+        if (!W_lut) {
+            cout << "[ERROR] failed to build the LUT matrix\n";
+            exit(1);
+        }
+
+        double cycles_opt = measure_tcsc_cycles(tcsc_sgemm_optimized, X, W_tsparse, B, Y, M, N, K);
+        double cycles_gather = measure_tcsc_cycles(tcsc_sgemm_gather, X, W_tsparse, B, Y, M, N, K);
+        double cycles_bitmap = measure_cycles(tbitmap_sgemm, X, W_bitmap, B, Y, M, N, K);
+        double cycles_lut = measure_cycles(tlut_sgemm, X, W_lut, B, Y, M, N, K);
+
+        printf(
+            "SWEEP nonZero=%d TCSC_opt=%.0f TCSC_gather=%.0f TBITMAP=%.0f TLUT=%.0f\n",
+            non_zero, cycles_opt, cycles_gather, cycles_bitmap, cycles_lut
+        );
+        double cycles_tcsc = min(cycles_opt, cycles_gather);
+        if (cycles_bitmap < cycles_tcsc && bitmap_wins_down_to == non_zero / 2) {
+            bitmap_wins_down_to = non_zero;
+        }
+        if (cycles_lut < cycles_tcsc && lut_wins_down_to == non_zero / 2) {
+            lut_wins_down_to = non_zero;
+        }
+
+        free(W_dense);
+        tcsc_free(W_tsparse);
+        tbitmap_free((tbitmap_t*)W_bitmap);
+        tlut_free((tlut_t*)W_lut);
+    }
+
+    if (bitmap_wins_down_to > 1) {
+        cout << "  >>> Bitmap beats TCSC down to density 1/" << bitmap_wins_down_to << "\n";
+    } else {
+        cout << "  >>> Bitmap does not beat TCSC at any tested density\n";
+    }
+    if (lut_wins_down_to > 1) {
+        cout << "  >>> LUT beats TCSC down to density 1/" << lut_wins_down_to << "\n";
+    } else {
+        cout << "  >>> LUT does not beat TCSC at any tested density\n";
+    }
+
+    free(X); free(B); free(Y);
+}
+
+// Parallel TCSC forced into split-K mode, for measure_tcsc_cycles
+void tcsc_sgemm_parallel_split_k(const dense_t X, const tcsc_t* W, const dense_t B, dense_t Y,
+                                 int M, int N, int K) {
+    tcsc_sgemm_parallel_mode(X, W, B, Y, M, N, K, TCSC_PAR_SPLIT_K);
+}
+
+// Strong scaling of the parallel TCSC kernel from 1 thread to all threads
+// (powers of two plus the maximum), relative to the serial optimized kernel,
+// for the column partitioning and the split-K mode
+void run_strong_scaling(const dense_t X, const tcsc_t* W, const dense_t B, dense_t Y,
+                        int M, int N, int K, double cycles_serial) {
+    tcsc_parallel_set_threads(0);
+    int max_threads = tcsc_parallel_threads();
+
+    for (int threads = 1; ; threads = min(2 * threads, max_threads)) {
+        tcsc_parallel_set_threads(threads);
+        double cycles = measure_tcsc_cycles(tcsc_sgemm_parallel, X, W, B, Y, M, N, K);
+        double cycles_split_k = measure_tcsc_cycles(tcsc_sgemm_parallel_split_k, X, W, B, Y, M, N, K);
+        printf(
+            "SCALING M=%d K=%d N=%d threads=%d cycles=%.0f speedup=%.2fx splitk_cycles=%.0f splitk_speedup=%.2fx\n",
+            M, K, N, threads, cycles, cycles_serial / cycles, cycles_split_k, cycles_serial / cycles_split_k
+        );
+        if (threads == max_threads) break;
+    }
+    tcsc_parallel_set_threads(0);
+}
+
+// Times a few runs of a TCSC kernel without warm-up scaling, for shapes
+// where a single call already takes well over CYCLES_REQUIRED
+double measure_tcsc_cycles_large(void (*func)(const dense_t, const tcsc_t*, const dense_t, dense_t, int, int, int),
+                                 const dense_t X, const tcsc_t* W, const dense_t B, dense_t Y,
+                                 int M, int N, int K, int reps) {
+#ifdef __x86_64__
+    myInt64 start, end;
+#endif
+#ifdef __aarch64__
+    TIMESTAMP start, end;
+#endif
+    double best = 0.;
+    for (int j = 0; j < reps; j++) {
+#ifdef __x86_64__
+        start = start_tsc();
+#endif
+#ifdef __aarch64__
+        start = start_vct();
+#endif
+        func(X, W, B, Y, M, N, K);
+#ifdef __x86_64__
+        end = stop_tsc(start);
+#endif
+#ifdef __aarch64__
+        end = stop_vct(start);
+#endif
+        if (j == 0 || (double)end < best) best = (double)end;
+    }
+    return best;
+}
+
+// M, K, N of the large shapes of SparseGEMM.cpp (16000/64000 rows are left
+// out for run time)
+static const int large_shapes[][3] = {{1000, 2048, 512}, {4000, 4096, 1024}, {256, 4096, 16384}};
+
+// Compares the cache-blocked driver against the untiled kernel on the large
+// shapes
+void run_large_shapes(int non_zero) {
+    cout << "\n[*] LARGE SHAPES (nonZero=" << non_zero << "):\n";
+    for (const auto &shape : large_shapes) {
+        int M = shape[0], K = shape[1], N = shape[2];
+        const dense_t X = init_rand_dense(M, K);
+        const dense_t W_dense = init_rand_sparse(K, N, non_zero);
+        const dense_t B = init_rand_dense(N, 1);
+        dense_elem_t *Y, *refY;
+        build_and_check(&Y, M, N);
+        build_and_check(&refY, M, N);
+        tcsc_t *W_tsparse = tcsc_from_dense(W_dense, K, N);
+        tcsc_tiles_t tiles = tcsc_choose_tiles(M, N, K);
+
+        tcsc_sgemm_optimized(X, W_tsparse, B, refY, M, N, K);
+        tcsc_sgemm_tiled(X, W_tsparse, B, Y, M, N, K);
+        if (!compare(Y, refY, M, N)) {
+            cout << "[ERROR] TCSC tiled failed validation!!!\n";
+            exit(1);
+        }
+
+        double cycles_opt = measure_tcsc_cycles_large(tcsc_sgemm_optimized, X, W_tsparse, B, Y, M, N, K, 3);
+        double cycles_batched = measure_tcsc_cycles_large(tcsc_sgemm_batched, X, W_tsparse, B, Y, M, N, K, 3);
+        double cycles_tiled = measure_tcsc_cycles_large(tcsc_sgemm_tiled, X, W_tsparse, B, Y, M, N, K, 3);
+        printf(
+            "LARGE M=%d K=%d N=%d tiles=%dx%dx%d TCSC_opt=%.0f TCSC_batched=%.0f TCSC_tiled=%.0f "
+            "speedup_vs_opt=%.2fx speedup_vs_batched=%.2fx\n",
+            M, K, N, tiles.mb, tiles.nb, tiles.kb, cycles_opt, cycles_batched, cycles_tiled,
+            cycles_opt / cycles_tiled, cycles_batched / cycles_tiled
+        );
+
+        free(X); free(W_dense); free(B); free(Y); free(refY);
+        tcsc_free(W_tsparse);
+    }
+}
+
+// Median and 99th percentile cycles of single calls
+template <typename F>
+void measure_latency(F call, int calls, double *p50, double *p99) {
+#ifdef __x86_64__
+    myInt64 start, end;
+#endif
+#ifdef __aarch64__
+    TIMESTAMP start, end;
+#endif
+    vector<double> samples(calls);
+    for (int i = 0; i < calls / 10; i++) {
+        call();
+    }
+    for (int i = 0; i < calls; i++) {
+#ifdef __x86_64__
+        start = start_tsc();
+#endif
+#ifdef __aarch64__
+        start = start_vct();
+#endif
+        call();
+#ifdef __x86_64__
+        end = stop_tsc(start);
+#endif
+#ifdef __aarch64__
+        end = stop_vct(start);
+#endif
+        samples[i] = (double)end;
+    }
+    sort(samples.begin(), samples.end());
+    *p50 = samples[calls / 2];
+    *p99 = samples[calls * 99 / 100];
+}
+
+static void noop_task(void *, int) {}
+
+// Per-call overhead of the persistent pool against an OpenMP region for a
+// small GEMV, both empty and with the TCSC column kernel
+void run_pool_latency(int M, int K, int N) {
+    cout << "\n[*] DISPATCH LATENCY (M=" << M << ", K=" << K << ", N=" << N << "):\n";
+
+    const dense_t X = init_rand_dense(M, K);
+    const dense_t W_dense = init_rand_sparse(K, N, 4);
+    const dense_t B = init_rand_dense(N, 1);
+    dense_elem_t *Y;
+    build_and_check(&Y, M, N);
+    tcsc_t *W_tsparse = tcsc_from_dense(W_dense, K, N);
+
+    int max_threads = max(1, (int)std::thread::hardware_concurrency());
+    const int calls = 2000;
+    vector<int> thread_counts;
+    for (int threads : {1, 2, 4}) {
+        if (threads < max_threads) thread_counts.push_back(threads);
+    }
+    thread_counts.push_back(max_threads);
+
+    for (int threads : thread_counts) {
+        tpool_t *pool = tpool_create(threads, true);
+        if (!pool) {
+            cout << "[ERROR] failed to create the thread pool\n";
+            exit(1);
+        }
+        tcsc_parallel_set_threads(threads);
+
+        double pool_empty50, pool_empty99, omp_empty50, omp_empty99;
+        double pool_call50, pool_call99, omp_call50, omp_call99;
+        measure_latency([&] { tpool_run(pool, noop_task, NULL, threads); }, calls, &pool_empty50, &pool_empty99);
+        measure_latency([&] {
+            #pragma omp parallel num_threads(threads)
+            {
+                __asm__ __volatile__("" ::: "memory");
+            }
+        }, calls, &omp_empty50, &omp_empty99);
+        measure_latency([&] { tcsc_sgemm_pool(pool, X, W_tsparse, B, Y, M, N, K); }, calls, &pool_call50, &pool_call99);
+        measure_latency([&] { tcsc_sgemm_parallel_mode(X, W_tsparse, B, Y, M, N, K, TCSC_PAR_COLUMNS); }, calls, &omp_call50, &omp_call99);
+
+        printf(
+            "LATENCY threads=%d pool_empty p50=%.0f p99=%.0f omp_empty p50=%.0f p99=%.0f "
+            "pool_call p50=%.0f p99=%.0f omp_call p50=%.0f p99=%.0f\n",
+            threads, pool_empty50, pool_empty99, omp_empty50, omp_empty99,
+            pool_call50, pool_call99, omp_call50, omp_call99
+        );
+        tpool_free(pool);
+    }
+    tcsc_parallel_set_threads(0);
+
+    free(X); free(W_dense); free(B); free(Y);
+    tcsc_free(W_tsparse);
+}
+
+// Prints the per-thread busy time of one scheduled run and max/mean
+void print_busy(const char *matrix, const char *kernel, const char *mode,
+                double p50, const vector<double> &busy_ns) {
+    double sum = 0., most = 0.;
+    printf("SCHED matrix=%s kernel=%s mode=%s p50=%.0f busy_us=", matrix, kernel, mode, p50);
+    for (size_t t = 0; t < busy_ns.size(); t++) {
+        printf("%s%.1f", t ? "/" : "", busy_ns[t] / 1e3);
+        sum += busy_ns[t];
+        most = max(most, busy_ns[t]);
+    }
+    printf(" imbalance=%.2f\n", sum > 0. ? most * busy_ns.size() / sum : 1.);
+}
+
+// Static nnz partitioning against work stealing on the tile scheduler, on
+// a uniform and a column-skewed matrix, for the TCSC and BCSR executors
+void run_scheduler_comparison(int M, int K, int N, int calls) {
+    cout << "\n[*] TILE SCHEDULER (M=" << M << ", K=" << K << ", N=" << N << "):\n";
+
+    tpool_t *pool = tpool_create(0, true);
+    if (!pool) {
+        cout << "[ERROR] failed to create the thread pool\n";
+        exit(1);
+    }
+    int threads = tpool_threads(pool);
+    vector<double> busy_ns(threads);
+
+    const dense_t X = init_rand_dense(M, K);
+    const dense_t B = init_rand_dense(N, 1);
+    dense_elem_t *Y, *refY;
+    build_and_check(&Y, M, N);
+    build_and_check(&refY, M, N);
+
+    for (int skewed = 0; skewed <= 1; skewed++) {
+        const char *matrix = skewed ? "skewed" : "uniform";
+        const dense_t W_dense = skewed ? init_rand_sparse_skewed(K, N, 4, 1.5f) : init_rand_sparse(K, N, 4);
+        tcsc_t *W_tsparse = tcsc_from_dense(W_dense, K, N);
+        tcsc_sgemm_optimized(X, W_tsparse, B, refY, M, N, K);
+#ifdef __x86_64__
+        bcsr_t *W_bcsr = bcsr_from_dense(W_dense, K, N, 1, 8);
+#endif
+
+        for (tsched_mode_t mode : {TSCHED_STATIC, TSCHED_STEAL}) {
+            const char *mode_name = (mode == TSCHED_STATIC) ? "static" : "steal";
+            double p50, p99;
+
+            tcsc_sgemm_sched(pool, X, W_tsparse, B, Y, M, N, K, mode, busy_ns.data());
+            if (!compare(Y, refY, M, N)) {
+                cout << "[ERROR] scheduled TCSC failed validation!!!\n";
+                exit(1);
+            }
+            measure_latency([&] { tcsc_sgemm_sched(pool, X, W_tsparse, B, Y, M, N, K, mode, NULL); }, calls, &p50, &p99);
+            print_busy(matrix, "TCSC", mode_name, p50, busy_ns);
+
+#ifdef __x86_64__
+            bcsr_sgemm_sched(pool, X, *W_bcsr, B, Y, M, N, K, mode, busy_ns.data());
+            if (!compare(Y, refY, M, N)) {
+                cout << "[ERROR] scheduled BCSR failed validation!!!\n";
+                exit(1);
+            }
+            measure_latency([&] { bcsr_sgemm_sched(pool, X, *W_bcsr, B, Y, M, N, K, mode, NULL); }, calls, &p50, &p99);
+            print_busy(matrix, "BCSR", mode_name, p50, busy_ns);
+#endif
+        }
+
+        free(W_dense);
+        tcsc_free(W_tsparse);
+#ifdef __x86_64__
+        free(W_bcsr->b_values); free(W_bcsr->b_row_start); free(W_bcsr->b_col_idx); free(W_bcsr);
+#endif
+    }
+
+    free(X); free(B); free(Y); free(refY);
+    tpool_free(pool);
+}
+
+// Per-channel PReLU on a column-scaled ternary layer, fused into the TCSC
+// kernel against the unscaled kernel followed by a pass over Y, and with
+// group scales instead of column scales
+void run_channel_scales(int M, int K, int N, int calls) {
+    cout << "\n[*] CHANNEL SCALES (M=" << M << ", K=" << K << ", N=" << N << "):\n";
+
+    const dense_t X = init_rand_dense(M, K);
+    const dense_t W_dense = init_rand_sparse(K, N, 4);
+    const dense_t B = init_rand_dense(N, 1);
+    const dense_t alpha = init_rand_dense(N, 1);
+    const dense_t col_scale = init_rand_dense(N, 1);
+    const int group_size = 128;
+    const dense_t group_scale = init_rand_dense(N * ((K + group_size - 1) / group_size), 1);
+    dense_elem_t *Y, *refY, *zero;
+    build_and_check(&Y, M, N);
+    build_and_check(&refY, M, N);
+    build_and_check(&zero, N, 1);
+    fill(zero, zero + N, 0.0f);
+    tcsc_t *W_tsparse = tcsc_from_dense(W_dense, K, N);
+
+    auto unfused = [&] {
+        tcsc_sgemm_optimized(X, W_tsparse, zero, refY, M, N, K);
+        for (int m = 0; m < M; m++) {
+            for (int n = 0; n < N; n++) {
+                float y = refY[m * N + n] * col_scale[n] + B[n];
+                refY[m * N + n] = (y < 0.0f) ? alpha[n] * y : y;
+            }
+        }
+    };
+
+    if (tcsc_set_col_scale(W_tsparse, col_scale) != 0) {
+        cout << "[ERROR] failed to set the column scales\n";
+        exit(1);
+    }
+    unfused();
+    tcsc_sgemm_prelu_channel(X, W_tsparse, B, alpha, Y, M, N, K);
+    if (!compare(Y, refY, M, N)) {
+        cout << "[ERROR] per-channel PReLU failed validation!!!\n";
+        exit(1);
+    }
+
+    double fused50, fused99, unfused50, unfused99, group50, group99;
+    measure_latency([&] { tcsc_sgemm_prelu_channel(X, W_tsparse, B, alpha, Y, M, N, K); }, calls, &fused50, &fused99);
+    measure_latency(unfused, calls, &unfused50, &unfused99);
+    if (tcsc_set_group_scale(W_tsparse, group_size, group_scale) != 0) {
+        cout << "[ERROR] failed to set the group scales\n";
+        exit(1);
+    }
+    measure_latency([&] { tcsc_sgemm_prelu_channel(X, W_tsparse, B, alpha, Y, M, N, K); }, calls, &group50, &group99);
+
+    printf(
+        "CHANNEL col_scale_fused p50=%.0f unfused p50=%.0f group%d_fused p50=%.0f\n",
+        fused50, unfused50, group_size, group50
+    );
+    cout << "  >>> Fused scale+PReLU vs separate pass: "
+         << fixed << setprecision(2) << unfused50 / fused50 << "x faster\n";
+
+    free(X); free(W_dense); free(B); free(alpha); free(col_scale); free(group_scale);
+    free(Y); free(refY); free(zero);
+    tcsc_free(W_tsparse);
+}
+
+// Fully ternary layer: bitplane activations and weights with popcounts
+// against the float kernels on the same {-1, 0, +1} X, and the fused
+// threshold epilogue that emits the next layer's bitplanes
+void run_bitwise_activations(int M, int K, int N, int calls) {
+    cout << "\n[*] TERNARY ACTIVATIONS (M=" << M << ", K=" << K << ", N=" << N
+         << ", isa=" << tbitact_isa() << "):\n";
+
+    const dense_t X = init_rand_sparse(M, K, 2);
+    const dense_t W_dense = init_rand_sparse(K, N, 4);
+    const dense_t B = init_rand_dense(N, 1);
+    dense_elem_t *Y, *refY;
+    build_and_check(&Y, M, N);
+    build_and_check(&refY, M, N);
+    tcsc_t *W_tsparse = tcsc_from_dense(W_dense, K, N);
+    tbitmap_t *W_bitmap = tbitmap_from_tcsc(W_tsparse);
+    tbitact_t *X_bits = tbitact_from_dense(X, M, K, 0.5f);
+    tbitact_t *Z = tbitact_create(M, N);
+    if (!X_bits || !Z) {
+        cout << "[ERROR] failed to allocate the activation bitplanes\n";
+        exit(1);
+    }
+
+    tcsc_sgemm_batched(X, W_tsparse, B, refY, M, N, K);
+    tbitact_sgemm(X_bits, W_bitmap, B, Y, M, N, K);
+    if (!compare(Y, refY, M, N)) {
+        cout << "[ERROR] bitwise ternary GEMM failed validation!!!\n";
+        exit(1);
+    }
+
+    double tcsc50, bitmap50, bits50, fused50, p99;
+    measure_latency([&] { tcsc_sgemm_batched(X, W_tsparse, B, Y, M, N, K); }, calls, &tcsc50, &p99);
+    measure_latency([&] { tbitmap_sgemm(X, W_bitmap, B, Y, M, N, K); }, calls, &bitmap50, &p99);
+    measure_latency([&] { tbitact_sgemm(X_bits, W_bitmap, B, Y, M, N, K); }, calls, &bits50, &p99);
+    measure_latency([&] { tbitact_gemm_ternary(X_bits, W_bitmap, B, 1.0f, Z, M, N, K); }, calls, &fused50, &p99);
+
+    printf(
+        "TERNARY TCSC_batched p50=%.0f TBITMAP p50=%.0f TBITACT p50=%.0f TBITACT_ternary_out p50=%.0f\n",
+        tcsc50, bitmap50, bits50, fused50
+    );
+    cout << "  >>> Bitwise vs best float kernel: "
+         << fixed << setprecision(2) << min(tcsc50, bitmap50) / bits50 << "x faster\n";
+
+    free(X); free(W_dense); free(B); free(Y); free(refY);
+    tcsc_free(W_tsparse);
+    tbitmap_free(W_bitmap);
+    tbitact_free(X_bits);
+    tbitact_free(Z);
+}
+
+// Activation sparsity: the row-wise TCSR kernel, which only visits the
+// non-zeros of X, against the batched TCSC kernel from dense X down to 1%
+// non-zeros. The highest density at which TCSR still wins becomes the
+// crossover used by tcsr_sgemm_auto.
+void run_x_sparsity(int M, int K, int N, int calls) {
+    cout << "\n[*] ACTIVATION SPARSITY (M=" << M << ", K=" << K << ", N=" << N << "):\n";
+
+    const dense_t W_dense = init_rand_sparse(K, N, 4);
+    const dense_t B = init_rand_dense(N, 1);
+    dense_elem_t *Y, *refY;
+    build_and_check(&Y, M, N);
+    build_and_check(&refY, M, N);
+    tcsc_t *W_tsparse = tcsc_from_dense(W_dense, K, N);
+    tcsr_t *W_tcsr = tcsr_from_tcsc(W_tsparse);
+    if (!W_tcsr) {
+        cout << "[ERROR] failed to build the TCSR matrix\n";
+        exit(1);
+    }
+
+    float tcsr_wins_up_to = 0.0f;
+    for (float density : {1.0f, 0.5f, 0.25f, 0.1f, 0.05f, 0.01f}) {
+        const dense_t X = init_rand_dense_density(M, K, density);
+
+        tcsc_sgemm_batched(X, W_tsparse, B, refY, M, N, K);
+        tcsr_sgemm_sparse_x(X, W_tcsr, B, Y, M, N, K);
+        if (!compare(Y, refY, M, N)) {
+            cout << "[ERROR] sparse-X TCSR failed validation!!!\n";
+            exit(1);
+        }
+
+        double tcsc50, tcsc99, tcsr50, tcsr99;
+        measure_latency([&] { tcsc_sgemm_batched(X, W_tsparse, B, Y, M, N, K); }, calls, &tcsc50, &tcsc99);
+        measure_latency([&] { tcsr_sgemm_sparse_x(X, W_tcsr, B, Y, M, N, K); }, calls, &tcsr50, &tcsr99);
+        printf(
+            "XSPARSE density=%.2f measured=%.3f TCSC_batched p50=%.0f TCSR_sparse_x p50=%.0f\n",
+            density, tcsr_x_density(X, M, K), tcsc50, tcsr50
+        );
+        if (tcsr50 < tcsc50 && tcsr_wins_up_to == 0.0f) {
+            tcsr_wins_up_to = density;
+        }
+        free(X);
+    }
+
+    if (tcsr_wins_up_to > 0.0f) {
+        // strictly below the threshold selects TCSR
+        tcsr_set_x_density_threshold(nextafterf(tcsr_wins_up_to, 1.0f));
+        cout << "  >>> TCSR beats TCSC up to X density "
+             << fixed << setprecision(2) << tcsr_wins_up_to << "\n";
+    } else {
+        tcsr_set_x_density_threshold(0.0f);
+        cout << "  >>> TCSR does not beat TCSC at any tested X density\n";
+    }
+
+    free(W_dense); free(B); free(Y); free(refY);
+    tcsc_free(W_tsparse);
+    tcsr_free(W_tcsr);
+}
+
+// Checks Y = XW + B and Y_prelu = prelu(XW + B, a) against a double
+// precision sum over the TCSC indices of W. Float kernels sum in different
+// orders and their rounding grows with the terms summed, so the tolerance
+// is relative to sum |x| over the column entries on top of compare()'s
+// absolute 1e-4.
+static bool compare_f64_reference(
+    const dense_t Y, const dense_t Y_prelu, const dense_t X, const tcsc_t *W, const dense_t B, float a,
+    int M, int N, int K
+) {
+    const double rel = 1e-6;
+    for (int m = 0; m < M; m++) {
+        const float *x = X + (size_t) m * K;
+        for (int n = 0; n < N; n++) {
+            double y = B[n], mass = fabs(B[n]);
+            for (int k = W->col_start_pos[n]; k < W->col_start_pos[n + 1]; k++) {
+                y += x[W->row_index_pos[k]];
+                mass += fabs(x[W->row_index_pos[k]]);
+            }
+            for (int k = W->col_start_neg[n]; k < W->col_start_neg[n + 1]; k++) {
+                y -= x[W->row_index_neg[k]];
+                mass += fabs(x[W->row_index_neg[k]]);
+            }
+            double y_prelu = (y < 0.0) ? a * y : y;
+            double tol = 1e-4 + rel * mass;
+            size_t ij = (size_t) m * N + n;
+            if (fabs(Y[ij] - y) > tol || fabs(Y_prelu[ij] - y_prelu) > tol) {
+                printf(
+                    "Error at (row, col) = (%d, %d): expected=%f/%f got=%f/%f\n",
+                    m, n, y, y_prelu, Y[ij], Y_prelu[ij]
+                );
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Output-stationary TCSC against the input-stationary TCSR outer product,
+// plain and with PReLU fused, on the GEMV-like and the large shapes so the
+// dataflow can be chosen per layer shape
+void run_dataflow_comparison(int non_zero) {
+    cout << "\n[*] DATAFLOW TCSC vs TCSR (nonZero=" << non_zero << "):\n";
+    const float a = 0.2f;
+    const int shapes[][3] = {
+        {1, 1024, 4096}, {16, 1024, 4096}, {64, 1024, 4096},
+        {large_shapes[0][0], large_shapes[0][1], large_shapes[0][2]},
+        {large_shapes[1][0], large_shapes[1][1], large_shapes[1][2]},
+        {large_shapes[2][0], large_shapes[2][1], large_shapes[2][2]},
+    };
+    for (const auto &shape : shapes) {
+        int M = shape[0], K = shape[1], N = shape[2];
+        // about 1e9 multiply-adds of dense work per shape
+        int calls = max(3, (int)min(200.0, 1e9 / ((double)M * K * N)));
+        const dense_t X = init_rand_dense(M, K);
+        const dense_t W_dense = init_rand_sparse(K, N, non_zero);
+        const dense_t B = init_rand_dense(N, 1);
+        dense_elem_t *Y, *refY;
+        build_and_check(&Y, M, N);
+        build_and_check(&refY, M, N);
+        tcsc_t *W_tsparse = tcsc_from_dense(W_dense, K, N);
+        tcsr_t *W_tcsr = tcsr_from_tcsc(W_tsparse);
+        if (!W_tcsr) {
+            cout << "[ERROR] failed to build the TCSR matrix\n";
+            exit(1);
+        }
+
+        // TCSC sums the +1 rows before the -1 rows and TCSR sums in k
+        // order, at K=4096 the two drift apart by more than compare()'s
+        // tolerance, so both TCSR kernels are checked against a double
+        // precision reference instead
+        tcsr_sgemm(X, W_tcsr, B, Y, M, N, K);
+        tcsr_sgemm_prelu(X, W_tcsr, B, a, refY, M, N, K);
+        if (!compare_f64_reference(Y, refY, X, W_tsparse, B, a, M, N, K)) {
+            cout << "[ERROR] TCSR outer product or PReLU failed validation!!!\n";
+            exit(1);
+        }
+
+        double tcsc50, tcsr50, tcsc_prelu50, tcsr_prelu50, p99;
+        measure_latency([&] { tcsc_sgemm_batched(X, W_tsparse, B, Y, M, N, K); }, calls, &tcsc50, &p99);
+        measure_latency([&] { tcsr_sgemm(X, W_tcsr, B, Y, M, N, K); }, calls, &tcsr50, &p99);
+        measure_latency([&] { tcsc_sgemm_prelu_tiled(X, W_tsparse, B, a, Y, M, N, K); }, calls, &tcsc_prelu50, &p99);
+        measure_latency([&] { tcsr_sgemm_prelu(X, W_tcsr, B, a, Y, M, N, K); }, calls, &tcsr_prelu50, &p99);
+
+        printf(
+            "DATAFLOW M=%d K=%d N=%d isa=%s TCSC_batched p50=%.0f TCSR p50=%.0f TCSC_prelu_tiled p50=%.0f TCSR_prelu p50=%.0f\n",
+            M, K, N, tcsr_isa(M), tcsc50, tcsr50, tcsc_prelu50, tcsr_prelu50
+        );
+        cout << "  >>> " << (tcsr50 < tcsc50 ? "TCSR" : "TCSC") << " wins by "
+             << fixed << setprecision(2) << max(tcsc50, tcsr50) / min(tcsc50, tcsr50) << "x\n";
+
+        free(X); free(W_dense); free(B); free(Y); free(refY);
+        tcsc_free(W_tsparse);
+        tcsr_free(W_tcsr);
+    }
+}
+
+// SELL-C-sigma against the per-column TCSC kernels on uniform and
+// column-skewed weights: without sorting (sigma = C), with sorted windows
+// and with all columns sorted, reporting the padding each one stores
+void run_sell_comparison(int M, int K, int N, int calls) {
+    cout << "\n[*] SELL-C-SIGMA (M=" << M << ", K=" << K << ", N=" << N << "):\n";
+
+    const dense_t X = init_rand_dense(M, K);
+    const dense_t B = init_rand_dense(N, 1);
+    dense_elem_t *Y, *refY;
+    build_and_check(&Y, M, N);
+    build_and_check(&refY, M, N);
+#ifdef __x86_64__
+    const int C = __builtin_cpu_supports("avx512f") ? 16 : 8;
+#else
+    const int C = 8;
+#endif
+
+    for (float skew : {0.0f, 0.5f, 1.5f}) {
+        const dense_t W_dense = (skew > 0.0f) ? init_rand_sparse_skewed(K, N, 4, skew) : init_rand_sparse(K, N, 4);
+        tcsc_t *W_tsparse = tcsc_from_dense(W_dense, K, N);
+
+        tcsc_sgemm_optimized(X, W_tsparse, B, refY, M, N, K);
+        double opt50, gather50, p99;
+        measure_latency([&] { tcsc_sgemm_optimized(X, W_tsparse, B, Y, M, N, K); }, calls, &opt50, &p99);
+        measure_latency([&] { tcsc_sgemm_gather(X, W_tsparse, B, Y, M, N, K); }, calls, &gather50, &p99);
+        printf("SELL skew=%.1f TCSC_opt p50=%.0f TCSC_gather p50=%.0f\n", skew, opt50, gather50);
+
+        double best50 = 0.0;
+        for (int sigma : {C, 256, N}) {
+            tsell_t *W_sell = tsell_from_tcsc(W_tsparse, C, sigma);
+            if (!W_sell) {
+                cout << "[ERROR] failed to build the SELL matrix\n";
+                exit(1);
+            }
+            tsell_sgemm(X, W_sell, B, Y, M, N, K);
+            if (!compare(Y, refY, M, N)) {
+                cout << "[ERROR] SELL-C-sigma failed validation!!!\n";
+                exit(1);
+            }
+            double sell50;
+            measure_latency([&] { tsell_sgemm(X, W_sell, B, Y, M, N, K); }, calls, &sell50, &p99);
+            printf(
+                "SELL skew=%.1f C=%d sigma=%d isa=%s padding=%.1f%% bytes=%zu TSELL p50=%.0f\n",
+                skew, C, W_sell->sigma, tsell_isa(W_sell), 100.0f * tsell_padding_overhead(W_sell),
+                tsell_bytes(W_sell), sell50
+            );
+            if (best50 == 0.0 || sell50 < best50) best50 = sell50;
+            tsell_free(W_sell);
+        }
+        cout << "  >>> Best SELL vs best TCSC at skew " << fixed << setprecision(1) << skew << ": "
+             << setprecision(2) << min(opt50, gather50) / best50 << "x faster\n";
+
+        free(W_dense);
+        tcsc_free(W_tsparse);
+    }
+
+    free(X); free(B); free(Y); free(refY);
+}
+
+#ifdef __x86_64__
+// Specialized BCSR micro-kernels for every instantiated block shape
+// against the hand-written 8x8 AVX2 kernel, with the fill ratio (non-zeros
+// over stored block elements) each shape gets on the same weights
+void run_bcsr_shapes(int M, int K, int N, int non_zero, int calls) {
+    cout << "\n[*] BCSR BLOCK SHAPES (M=" << M << ", K=" << K << ", N=" << N
+         << ", nonZero=" << non_zero << "):\n";
+
+    const dense_t X = init_rand_dense(M, K);
+    const dense_t W_dense = init_rand_sparse(K, N, non_zero);
+    const dense_t B = init_rand_dense(N, 1);
+    dense_elem_t *Y, *refY;
+    build_and_check(&Y, M, N);
+    build_and_check(&refY, M, N);
+    gemm_basic(X, W_dense, B, refY, M, N, K);
+    long nnz = 0;
+    for (long i = 0; i < (long)K * N; i++) nnz += (W_dense[i] != 0.0f);
+
+    double base50 = 0.0, best50 = 0.0, p99;
+    int best_r = 0, best_c = 0;
+    for (int r : {1, 2, 4, 8}) {
+        for (int c : {8, 16, 32}) {
+            bcsr_t *W_bcsr = bcsr_from_dense(W_dense, K, N, r, c);
+            bcsr_sgemm(X, *W_bcsr, B, Y, M, N, K);
+            if (!compare(Y, refY, M, N)) {
+                cout << "[ERROR] BCSR " << r << "x" << c << " failed validation!!!\n";
+                exit(1);
+            }
+            double p50;
+            measure_latency([&] { bcsr_sgemm(X, *W_bcsr, B, Y, M, N, K); }, calls, &p50, &p99);
+            if (r == 8 && c == 8) {
+                measure_latency([&] { bcsr_sgemm_avx2(X, *W_bcsr, B, Y, M, N, K); }, calls, &base50, &p99);
+            }
+            printf(
+                "BCSR r=%d c=%d blocks=%d fill=%.3f BCSR_specialized p50=%.0f\n",
+                r, c, W_bcsr->k, (double)nnz / ((double)W_bcsr->k * r * c), p50
+            );
+            if (best50 == 0.0 || p50 < best50) {
+                best50 = p50;
+                best_r = r;
+                best_c = c;
+            }
+            free(W_bcsr->b_values); free(W_bcsr->b_row_start); free(W_bcsr->b_col_idx); free(W_bcsr);
+        }
+    }
+    printf("BCSR r=8 c=8 BCSR_avx2 p50=%.0f\n", base50);
+    cout << "  >>> Best block shape " << best_r << "x" << best_c << " vs 8x8 AVX2: "
+         << fixed << setprecision(2) << base50 / best50 << "x faster\n";
+
+    free(X); free(W_dense); free(B); free(Y); free(refY);
+}
+#endif
+
+#ifdef __x86_64__
+// Block-row BCSR kernels, which load and store Y once per block, against
+// the block-column traversal that keeps strips of Y in registers, plain and
+// with PReLU, on block shapes with c = 8 (the AVX kernels) and one wider
+void run_bcsc_traversal(int K, int N, int non_zero) {
+    cout << "\n[*] BCSR ROW vs BCSC COLUMN TRAVERSAL (K=" << K << ", N=" << N
+         << ", nonZero=" << non_zero << "):\n";
+    const float a = 0.2f;
+    const dense_t W_dense = init_rand_sparse(K, N, non_zero);
+    const dense_t B = init_rand_dense(N, 1);
+
+    for (int M : {1, 16, 64}) {
+        int calls = (M == 1) ? 200 : 20;
+        const dense_t X = init_rand_dense(M, K);
+        dense_elem_t *Y, *refY;
+        build_and_check(&Y, M, N);
+        build_and_check(&refY, M, N);
+
+        for (const auto &shape : {make_pair(1, 8), make_pair(4, 8), make_pair(4, 16)}) {
+            int r = shape.first, c = shape.second;
+            bcsr_t *W_bcsr = bcsr_from_dense(W_dense, K, N, r, c);
+            bcsc_t *W_bcsc = bcsc_from_bcsr(W_bcsr);
+            if (!W_bcsc) {
+                cout << "[ERROR] failed to build the BCSC view\n";
+                exit(1);
+            }
+
+            bcsr_sgemm(X, *W_bcsr, B, refY, M, N, K);
+            bcsc_sgemm(X, W_bcsc, B, Y, M, N, K);
+            if (!compare(Y, refY, M, N)) {
+                cout << "[ERROR] BCSC traversal failed validation!!!\n";
+                exit(1);
+            }
+            bcsr_sgemm_prelu_basic(X, *W_bcsr, B, a, refY, M, N, K);
+            bcsc_sgemm_prelu(X, W_bcsc, B, a, Y, M, N, K);
+            if (!compare(Y, refY, M, N)) {
+                cout << "[ERROR] BCSC PReLU failed validation!!!\n";
+                exit(1);
+            }
+
+            double row50, col50, col_prelu50, avx50 = 0.0, avx_prelu50 = 0.0, p99;
+            measure_latency([&] { bcsr_sgemm(X, *W_bcsr, B, Y, M, N, K); }, calls, &row50, &p99);
+            measure_latency([&] { bcsc_sgemm(X, W_bcsc, B, Y, M, N, K); }, calls, &col50, &p99);
+            measure_latency([&] { bcsc_sgemm_prelu(X, W_bcsc, B, a, Y, M, N, K); }, calls, &col_prelu50, &p99);
+            if (c == 8) {
+                measure_latency([&] { bcsr_sgemm_avx(X, *W_bcsr, B, Y, M, N, K); }, calls, &avx50, &p99);
+                measure_latency([&] { bcsr_sgemm_prelu_avx(X, *W_bcsr, B, a, Y, M, N, K); }, calls, &avx_prelu50, &p99);
+            }
+            printf(
+                "BCSC M=%d r=%d c=%d BCSR_avx p50=%.0f BCSR_specialized p50=%.0f BCSC p50=%.0f "
+                "BCSR_prelu_avx p50=%.0f BCSC_prelu p50=%.0f\n",
+                M, r, c, avx50, row50, col50, avx_prelu50, col_prelu50
+            );
+            cout << "  >>> BCSC vs best block-row kernel: " << fixed << setprecision(2)
+                 << ((avx50 > 0.0) ? min(avx50, row50) : row50) / col50 << "x faster\n";
+
+            bcsc_free(W_bcsc);
+            free(W_bcsr->b_values); free(W_bcsr->b_row_start); free(W_bcsr->b_col_idx); free(W_bcsr);
+        }
+        free(X); free(Y); free(refY);
+    }
+    free(W_dense); free(B);
+}
+#endif
+
+#ifdef __x86_64__
+// Ternary BCSR with bitmask payloads against float BCSR on the same block
+// structure: bytes of W streamed per product and latency
+void run_ternary_bcsr(int M, int K, int N, int non_zero, int calls) {
+    cout << "\n[*] TERNARY BCSR (M=" << M << ", K=" << K << ", N=" << N
+         << ", nonZero=" << non_zero << "):\n";
+
+    const dense_t X = init_rand_dense(M, K);
+    const dense_t W_dense = init_rand_sparse(K, N, non_zero);
+    const dense_t B = init_rand_dense(N, 1);
+    dense_elem_t *Y, *refY;
+    build_and_check(&Y, M, N);
+    build_and_check(&refY, M, N);
+    gemm_basic(X, W_dense, B, refY, M, N, K);
+
+    for (const auto &shape : {make_pair(1, 8), make_pair(4, 16), make_pair(8, 32)}) {
+        int r = shape.first, c = shape.second;
+        bcsr_t *W_bcsr = bcsr_from_dense(W_dense, K, N, r, c);
+        tbcsr_t *W_tbcsr = tbcsr_from_bcsr(W_bcsr);
+        if (!W_tbcsr) {
+            cout << "[ERROR] failed to build ternary BCSR\n";
+            exit(1);
+        }
+
+        tbcsr_sgemm(X, W_tbcsr, B, Y, M, N, K);
+        if (!compare(Y, refY, M, N)) {
+            cout << "[ERROR] Ternary BCSR " << r << "x" << c << " failed validation!!!\n";
+            exit(1);
+        }
+
+        double float50, ternary50, p99;
+        measure_latency([&] { bcsr_sgemm(X, *W_bcsr, B, Y, M, N, K); }, calls, &float50, &p99);
+        measure_latency([&] { tbcsr_sgemm(X, W_tbcsr, B, Y, M, N, K); }, calls, &ternary50, &p99);
+        printf(
+            "TBCSR r=%d c=%d isa=%s BCSR bytes=%zu p50=%.0f TBCSR bytes=%zu p50=%.0f\n",
+            r, c, tbcsr_isa(W_tbcsr), bcsr_bytes(W_bcsr), float50, tbcsr_bytes(W_tbcsr), ternary50
+        );
+        cout << "  >>> Ternary vs float BCSR " << r << "x" << c << ": " << fixed << setprecision(2)
+             << (double)bcsr_bytes(W_bcsr) / tbcsr_bytes(W_tbcsr) << "x fewer bytes, "
+             << float50 / ternary50 << "x faster\n";
+
+        tbcsr_free(W_tbcsr);
+        free(W_bcsr->b_values); free(W_bcsr->b_row_start); free(W_bcsr->b_col_idx); free(W_bcsr);
+    }
+
+    free(X); free(W_dense); free(B); free(Y); free(refY);
+}
+#endif
+
+#ifdef __x86_64__
+// Block shape picked by bcsr_analyze against every shape measured, on
+// uniform weights and on weights made of whole 4 x 16 blocks
+void run_bcsr_auto_shape(int M, int K, int N, int calls) {
+    cout << "\n[*] BCSR AUTOMATIC BLOCK SHAPE (M=" << M << ", K=" << K << ", N=" << N << "):\n";
+
+    const dense_t X = init_rand_dense(M, K);
+    const dense_t B = init_rand_dense(N, 1);
+    dense_elem_t *Y, *refY;
+    build_and_check(&Y, M, N);
+    build_and_check(&refY, M, N);
+
+    for (int kind = 0; kind < 3; kind++) {
+        const char *name = (kind == 0) ? "uniform 1/16" : ((kind == 1) ? "uniform 1/2" : "4x16 blocks");
+        dense_t W_dense = init_rand_sparse(K, N, (kind == 1) ? 2 : 16);
+        if (kind == 2) {
+            // keep the non-zeros of every 8th 4 x 16 block and fill it up
+            for (int i = 0; i < K; i++) {
+                for (int j = 0; j < N; j++) {
+                    bool in_block = ((i / 4) * 7 + (j / 16) * 3) % 8 == 0;
+                    float w = W_dense[(size_t)i * N + j];
+                    W_dense[(size_t)i * N + j] = in_block ? ((w < 0.0f) ? -1.0f : 1.0f) : 0.0f;
+                }
+            }
+        }
+        gemm_basic(X, W_dense, B, refY, M, N, K);
+
+        bcsr_analysis_t stats;
+        bcsr_t *W_auto = bcsr_from_dense_auto(W_dense, K, N, &stats);
+        bcsr_sgemm(X, *W_auto, B, Y, M, N, K);
+        if (!compare(Y, refY, M, N)) {
+            cout << "[ERROR] BCSR with the analyzed shape failed validation!!!\n";
+            exit(1);
+        }
+
+        printf("BCSR_auto weights=%s sampled_rows=%d nnz=%ld\n", name, stats.sampled_rows, stats.nnz);
+        double auto50 = 0.0, best50 = 0.0, base50 = 0.0, p99;
+        for (int i = 0; i < BCSR_N_SHAPES; i++) {
+            const bcsr_shape_stats_t *shape = &stats.shapes[i];
+            bcsr_t *W_bcsr = bcsr_from_dense(W_dense, K, N, shape->r, shape->c);
+            double p50;
+            measure_latency([&] { bcsr_sgemm(X, *W_bcsr, B, Y, M, N, K); }, calls, &p50, &p99);
+            printf(
+                "BCSR_auto r=%d c=%d blocks=%ld fill=%.3f bytes=%zu predicted=%.0f p50=%.0f%s\n",
+                shape->r, shape->c, shape->blocks, shape->fill, shape->bytes, shape->cycles * M, p50,
+                (i == stats.best) ? " <- picked" : ""
+            );
+            if (i == stats.best) auto50 = p50;
+            if (shape->r == 1 && shape->c == 8) base50 = p50;
+            if (best50 == 0.0 || p50 < best50) best50 = p50;
+            free(W_bcsr->b_values); free(W_bcsr->b_row_start); free(W_bcsr->b_col_idx); free(W_bcsr);
+        }
+        cout << "  >>> Picked " << W_auto->r << "x" << W_auto->c << " on " << name << ": "
+             << fixed << setprecision(2) << base50 / auto50 << "x faster than 1x8, "
+             << best50 / auto50 << "x of the best measured shape\n";
+
+        free(W_auto->b_values); free(W_auto->b_row_start); free(W_auto->b_col_idx); free(W_auto);
+        free(W_dense);
+    }
+
+    free(X); free(B); free(Y); free(refY);
+}
+#endif
+
+#ifdef __x86_64__
+// Parallel BCSR engine against the single-threaded specialized kernel and
+// the equal-column pool kernel, for GEMV and a large batch, on a wide W
+// (split by block columns) and a narrow one (split by block rows)
+void run_bcsr_parallel(int K, int N, int non_zero) {
+    cout << "\n[*] PARALLEL BCSR ENGINE (K=" << K << ", N=" << N << ", nonZero=" << non_zero << "):\n";
+
+    tpool_t *pool = tpool_create(0, true);
+    if (!pool) {
+        cout << "[ERROR] failed to create the thread pool\n";
+        exit(1);
+    }
+    int threads = tpool_threads(pool);
+
+    for (int M : {1, 256}) {
+        int calls = (M == 1) ? 200 : 5;
+        const dense_t X = init_rand_dense(M, K);
+
+        for (int narrow = 0; narrow <= 1; narrow++) {
+            int n = narrow ? 64 : N, r = narrow ? 4 : 1, c = narrow ? 32 : 8;
+            const dense_t W_dense = init_rand_sparse(K, n, non_zero);
+            const dense_t B = init_rand_dense(n, 1);
+            dense_elem_t *Y, *refY;
+            build_and_check(&Y, M, n);
+            build_and_check(&refY, M, n);
+            bcsr_t *W_bcsr = bcsr_from_dense(W_dense, K, n, r, c);
+            bcsr_par_t *P = bcsr_par_create(W_bcsr, pool);
+            if (!P) {
+                cout << "[ERROR] failed to create the parallel BCSR plan\n";
+                exit(1);
+            }
+
+            bcsr_sgemm(X, *W_bcsr, B, refY, M, n, K);
+            bcsr_sgemm_par(pool, P, X, B, Y, M, n, K);
+            if (!compare(Y, refY, M, n)) {
+                cout << "[ERROR] parallel BCSR failed validation!!!\n";
+                exit(1);
+            }
+
+            double single50, pool50, par50, p99;
+            measure_latency([&] { bcsr_sgemm(X, *W_bcsr, B, Y, M, n, K); }, calls, &single50, &p99);
+            measure_latency([&] { bcsr_sgemm_pool(pool, X, *W_bcsr, B, Y, M, n, K); }, calls, &pool50, &p99);
+            measure_latency([&] { bcsr_sgemm_par(pool, P, X, B, Y, M, n, K); }, calls, &par50, &p99);
+            printf(
+                "BCSR_par M=%d N=%d r=%d c=%d threads=%d mode=%s imbalance=%.2f "
+                "BCSR_specialized p50=%.0f BCSR_pool p50=%.0f BCSR_par p50=%.0f\n",
+                M, n, r, c, threads, (P->mode == BCSR_PAR_COLUMNS) ? "columns" : "rows", P->imbalance,
+                single50, pool50, par50
+            );
+            cout << "  >>> Parallel engine on " << threads << " threads: " << fixed << setprecision(2)
+                 << single50 / par50 << "x over one thread, " << pool50 / par50 << "x over BCSR_pool\n";
+
+            bcsr_par_free(P);
+            free(W_bcsr->b_values); free(W_bcsr->b_row_start); free(W_bcsr->b_col_idx); free(W_bcsr);
+            free(W_dense); free(B); free(Y); free(refY);
+        }
+        free(X);
+    }
+    tpool_free(pool);
+}
+#endif
+
+// Dense int8 dot-product kernel against the int8 TCSC kernel from density
+// 1/2 downwards. The lowest density at which the dense kernel still wins
+// becomes the crossover used by tdense8_preferred.
+void run_dense8_crossover(int M, int K, int N, int calls) {
+    cout << "\n[*] DENSE INT8 CROSSOVER (M=" << M << ", K=" << K << ", N=" << N
+         << ", isa=" << tdense8_isa() << "):\n";
+
+    const dense_t X = init_rand_dense(M, K);
+    const dense_t B = init_rand_dense(N, 1);
+    dense_elem_t *Y, *refY;
+    build_and_check(&Y, M, N);
+    build_and_check(&refY, M, N);
+    vector<int8_t> X8((size_t)M * K);
+    tcsc_qparams_t xq = tcsc_quant_params(X, (size_t)M * K, 8);
+    tcsc_quantize_s8(X, (size_t)M * K, xq, X8.data());
+
+    int dense_wins_down_to = 0;
+    for (int non_zero : {2, 3, 4, 8, 16}) {
+        const dense_t W_dense = init_rand_sparse(K, N, non_zero);
+        tcsc_t *W_tsparse = tcsc_from_dense(W_dense, K, N);
+        tdense8_t *W_dense8 = tdense8_from_dense(W_dense, K, N);
+
+        tcsc_gemm_s8(X8.data(), xq, W_tsparse, B, refY, M, N, K);
+        tdense8_gemm_s8(X8.data(), xq, W_dense8, B, Y, M, N, K);
+        if (!compare(Y, refY, M, N)) {
+            cout << "[ERROR] dense int8 failed validation!!!\n";
+            exit(1);
+        }
+
+        double tcsc50, tcsc99, dense50, dense99;
+        measure_latency([&] { tcsc_gemm_s8(X8.data(), xq, W_tsparse, B, Y, M, N, K); }, calls, &tcsc50, &tcsc99);
+        measure_latency([&] { tdense8_gemm_s8(X8.data(), xq, W_dense8, B, Y, M, N, K); }, calls, &dense50, &dense99);
+        printf("DENSE8 nonZero=%d TCSC_s8 p50=%.0f TDENSE8 p50=%.0f\n", non_zero, tcsc50, dense50);
+        if (dense50 < tcsc50 && (dense_wins_down_to == 0 || dense_wins_down_to < non_zero)) {
+            dense_wins_down_to = non_zero;
+        }
+
+        free(W_dense);
+        tcsc_free(W_tsparse);
+        tdense8_free(W_dense8);
+    }
+
+    if (dense_wins_down_to > 0) {
+        tdense8_set_min_density(1.0f / dense_wins_down_to);
+        cout << "  >>> Dense int8 beats TCSC down to density 1/" << dense_wins_down_to << "\n";
+    } else {
+        tdense8_set_min_density(1.0f);
+        cout << "  >>> Dense int8 does not beat TCSC at any tested density\n";
+    }
+
+    free(X); free(B); free(Y); free(refY);
+}
+
+// fp16/bf16 activations (and Y) against the float batched kernel on the
+// large shapes, where the X panels no longer fit in L2
+void run_half_activations(int non_zero) {
+    cout << "\n[*] HALF-PRECISION ACTIVATIONS (nonZero=" << non_zero << "):\n";
+    for (const auto &shape : large_shapes) {
+        int M = shape[0], K = shape[1], N = shape[2];
+        const dense_t X = init_rand_dense(M, K);
+        const dense_t W_dense = init_rand_sparse(K, N, non_zero);
+        const dense_t B = init_rand_dense(N, 1);
+        dense_elem_t *Y, *refY, *X_round;
+        build_and_check(&Y, M, N);
+        build_and_check(&refY, M, N);
+        build_and_check(&X_round, M, K);
+        vector<uint16_t> Xh((size_t)M * K), Yh((size_t)M * N);
+        tcsc_t *W_tsparse = tcsc_from_dense(W_dense, K, N);
+
+        double cycles_f32 = measure_tcsc_cycles_large(tcsc_sgemm_batched, X, W_tsparse, B, Y, M, N, K, 3);
+        double cycles_half[2], cycles_half_out[2], p99;
+        for (tcsc_half_t fmt : {TCSC_FP16, TCSC_BF16}) {
+            tcsc_to_half(X, (size_t)M * K, fmt, Xh.data());
+            tcsc_from_half(Xh.data(), (size_t)M * K, fmt, X_round);
+            tcsc_sgemm_batched(X_round, W_tsparse, B, refY, M, N, K);
+            tcsc_sgemm_half(Xh.data(), fmt, W_tsparse, B, Y, M, N, K);
+            if (!compare(Y, refY, M, N)) {
+                cout << "[ERROR] half-precision TCSC failed validation!!!\n";
+                exit(1);
+            }
+            measure_latency([&] { tcsc_sgemm_half(Xh.data(), fmt, W_tsparse, B, Y, M, N, K); }, 3, &cycles_half[fmt], &p99);
+            measure_latency([&] { tcsc_sgemm_half_out(Xh.data(), fmt, W_tsparse, B, Yh.data(), M, N, K); }, 3, &cycles_half_out[fmt], &p99);
+        }
+
+        size_t x_bytes = (size_t)M * K * sizeof(float), y_bytes = (size_t)M * N * sizeof(float);
+        printf(
+            "HALF M=%d K=%d N=%d f32=%.0f fp16=%.0f fp16_out=%.0f bf16=%.0f bf16_out=%.0f "
+            "bytes f32=%zu half=%zu half_out=%zu\n",
+            M, K, N, cycles_f32, cycles_half[TCSC_FP16], cycles_half_out[TCSC_FP16],
+            cycles_half[TCSC_BF16], cycles_half_out[TCSC_BF16],
+            x_bytes + y_bytes, x_bytes / 2 + y_bytes, (x_bytes + y_bytes) / 2
+        );
+
+        free(X); free(W_dense); free(B); free(Y); free(refY); free(X_round);
+        tcsc_free(W_tsparse);
+    }
+}
+
+// Quantized int8/int16 activations against the float batched kernel. The
+// float reference runs on the dequantized X so that all three see the
+// same values.
+void run_int_activations(int M, int K, int N, int calls) {
+    cout << "\n[*] INTEGER ACTIVATIONS (M=" << M << ", K=" << K << ", N=" << N << "):\n";
+
+    const dense_t X = init_rand_dense(M, K);
+    const dense_t W_dense = init_rand_sparse(K, N, 4);
+    const dense_t B = init_rand_dense(N, 1);
+    dense_elem_t *Y, *refY, *X_deq;
+    build_and_check(&Y, M, N);
+    build_and_check(&refY, M, N);
+    build_and_check(&X_deq, M, K);
+    vector<int8_t> X8((size_t)M * K);
+    vector<int16_t> X16((size_t)M * K);
+    tcsc_t *W_tsparse = tcsc_from_dense(W_dense, K, N);
+
+    tcsc_qparams_t q8 = tcsc_quant_params(X, (size_t)M * K, 8);
+    tcsc_qparams_t q16 = tcsc_quant_params(X, (size_t)M * K, 16);
+    tcsc_quantize_s8(X, (size_t)M * K, q8, X8.data());
+    tcsc_quantize_s16(X, (size_t)M * K, q16, X16.data());
+
+    for (int i = 0; i < M * K; i++) X_deq[i] = q8.scale * (X8[i] - q8.zero_point);
+    tcsc_sgemm_batched(X_deq, W_tsparse, B, refY, M, N, K);
+    tcsc_gemm_s8(X8.data(), q8, W_tsparse, B, Y, M, N, K);
+    if (!compare(Y, refY, M, N)) {
+        cout << "[ERROR] int8 TCSC failed validation!!!\n";
+        exit(1);
+    }
+    for (int i = 0; i < M * K; i++) X_deq[i] = q16.scale * (X16[i] - q16.zero_point);
+    tcsc_sgemm_batched(X_deq, W_tsparse, B, refY, M, N, K);
+    tcsc_gemm_s16(X16.data(), q16, W_tsparse, B, Y, M, N, K);
+    if (!compare(Y, refY, M, N)) {
+        cout << "[ERROR] int16 TCSC failed validation!!!\n";
+        exit(1);
+    }
+
+    double f32_50, f32_99, s8_50, s8_99, s16_50, s16_99;
+    measure_latency([&] { tcsc_sgemm_batched(X, W_tsparse, B, Y, M, N, K); }, calls, &f32_50, &f32_99);
+    measure_latency([&] { tcsc_gemm_s8(X8.data(), q8, W_tsparse, B, Y, M, N, K); }, calls, &s8_50, &s8_99);
+    measure_latency([&] { tcsc_gemm_s16(X16.data(), q16, W_tsparse, B, Y, M, N, K); }, calls, &s16_50, &s16_99);
+
+    printf(
+        "INT f32 p50=%.0f s16 p50=%.0f s8 p50=%.0f X_bytes f32=%zu s16=%zu s8=%zu\n",
+        f32_50, s16_50, s8_50, (size_t)M * K * sizeof(float), (size_t)M * K * sizeof(int16_t), (size_t)M * K
+    );
+    cout << "  >>> int8 vs float activations: "
+         << fixed << setprecision(2) << f32_50 / s8_50 << "x faster\n";
+
+    free(X); free(W_dense); free(B); free(Y); free(refY); free(X_deq);
+    tcsc_free(W_tsparse);
+}
+
 void print_fancy_header() {
     cout << "\n";
     cout << "████████╗ ██████╗███████╗ ██████╗    ██████╗ ███████╗███╗   ██╗ ██████╗██╗  ██╗\n";
@@ -288,6 +1401,15 @@ int main(int argc, char **argv) {
 
         ProgressBar::show_thinking_animation("Converting to TCSC sparse format", 800);
         tcsc_t *W_tsparse = tcsc_from_dense(W_dense, K_LEN, N_COL);
+        const tcsc2_t *W_tcsc2 = tcsc2_from_tcsc(W_tsparse);
+        const tcsc_seg_t *W_seg8 = tcsc_seg_from_tcsc(W_tsparse, TCSC_SEG_ROWS_U8);
+        const tcsc_seg_t *W_seg16 = tcsc_seg_from_tcsc(W_tsparse, TCSC_SEG_ROWS_U16);
+        const tbitmap_t *W_bitmap = tbitmap_from_tcsc(W_tsparse);
+        const tlut_t *W_lut = tlut_from_tcsc(W_tsparse, tlut_preferred_group());
+        if (!W_lut) {
+            cout << "[ERROR] failed to build the LUT matrix\n";
+            exit(1);
+        }
 
         // Calculate FLOP counts
         long long flops_gemm_basic = 2LL * M_ROW * N_COL * K_LEN + M_ROW * N_COL;
@@ -332,6 +1454,111 @@ int main(int argc, char **argv) {
             exit(1);
         }
 
+        build_and_check(&Y, M_ROW, N_COL);
+        start_flop_count();
+#ifdef DISABLE_PAPI
+        set_flop_count(flops_sparse);
+#endif
+        tcsc_sgemm_gather(X, W_tsparse, B, Y, M_ROW, N_COL, K_LEN);
+        long long measured_flops_gather = stop_flop_count();
+
+        if (!compare(Y, refY, M_ROW, N_COL)) {
+            cout << "[ERROR] gather_tcsc (" << tcsc_gather_isa() << ") failed validation!!!" << endl;
+            exit(1);
+        }
+
+        build_and_check(&Y, M_ROW, N_COL);
+        start_flop_count();
+#ifdef DISABLE_PAPI
+        set_flop_count(flops_sparse);
+#endif
+        tcsc_sgemm_batched(X, W_tsparse, B, Y, M_ROW, N_COL, K_LEN);
+        long long measured_flops_batched = stop_flop_count();
+
+        if (!compare(Y, refY, M_ROW, N_COL)) {
+            cout << "[ERROR] batched_tcsc failed validation!!!" << endl;
+            exit(1);
+        }
+
+        build_and_check(&Y, M_ROW, N_COL);
+        start_flop_count();
+#ifdef DISABLE_PAPI
+        set_flop_count(flops_sparse);
+#endif
+        tcsc2_sgemm(X, W_tcsc2, B, Y, M_ROW, N_COL, K_LEN);
+        long long measured_flops_tcsc2 = stop_flop_count();
+
+        if (!compare(Y, refY, M_ROW, N_COL)) {
+            cout << "[ERROR] single-stream tcsc2 failed validation!!!" << endl;
+            exit(1);
+        }
+
+        build_and_check(&Y, M_ROW, N_COL);
+        start_flop_count();
+#ifdef DISABLE_PAPI
+        set_flop_count(flops_sparse);
+#endif
+        tcsc_seg_sgemm(X, W_seg8, B, Y, M_ROW, N_COL, K_LEN);
+        long long measured_flops_seg8 = stop_flop_count();
+
+        if (!compare(Y, refY, M_ROW, N_COL)) {
+            cout << "[ERROR] segmented tcsc (8-bit) failed validation!!!" << endl;
+            exit(1);
+        }
+
+        build_and_check(&Y, M_ROW, N_COL);
+        start_flop_count();
+#ifdef DISABLE_PAPI
+        set_flop_count(flops_sparse);
+#endif
+        tcsc_seg_sgemm(X, W_seg16, B, Y, M_ROW, N_COL, K_LEN);
+        long long measured_flops_seg16 = stop_flop_count();
+
+        if (!compare(Y, refY, M_ROW, N_COL)) {
+            cout << "[ERROR] segmented tcsc (16-bit) failed validation!!!" << endl;
+            exit(1);
+        }
+
+        build_and_check(&Y, M_ROW, N_COL);
+        start_flop_count();
+#ifdef DISABLE_PAPI
+        set_flop_count(flops_sparse);
+#endif
+        tbitmap_sgemm(X, W_bitmap, B, Y, M_ROW, N_COL, K_LEN);
+        long long measured_flops_bitmap = stop_flop_count();
+
+        if (!compare(Y, refY, M_ROW, N_COL)) {
+            cout << "[ERROR] bitmap failed validation!!!" << endl;
+            exit(1);
+        }
+
+        build_and_check(&Y, M_ROW, N_COL);
+        start_flop_count();
+#ifdef DISABLE_PAPI
+        set_flop_count(flops_sparse);
+#endif
+        tlut_sgemm(X, W_lut, B, Y, M_ROW, N_COL, K_LEN);
+        long long measured_flops_lut = stop_flop_count();
+
+        if (!compare(Y, refY, M_ROW, N_COL)) {
+            cout << "[ERROR] lookup-table kernel failed validation!!!" << endl;
+            exit(1);
+        }
+
+        build_and_check(&Y, M_ROW, N_COL);
+        tcsc_sgemm_parallel(X, W_tsparse, B, Y, M_ROW, N_COL, K_LEN);
+        if (!compare(Y, refY, M_ROW, N_COL)) {
+            cout << "[ERROR] parallel TCSC failed validation!!!" << endl;
+            exit(1);
+        }
+
+        build_and_check(&Y, M_ROW, N_COL);
+        tcsc_sgemm_parallel_split_k(X, W_tsparse, B, Y, M_ROW, N_COL, K_LEN);
+        if (!compare(Y, refY, M_ROW, N_COL)) {
+            cout << "[ERROR] split-K parallel TCSC failed validation!!!" << endl;
+            exit(1);
+        }
+
         // Test PReLU functions
         start_flop_count();
 #ifdef DISABLE_PAPI
@@ -354,17 +1581,36 @@ int main(int argc, char **argv) {
         tcsc_sgemm_prelu_optimized_onthego(X, W_tsparse, B, prelu_alpha, Y_prelu_otg, M_ROW, N_COL, K_LEN);
         long long measured_flops_prelu_otg = stop_flop_count();
 
-        // Validate PReLU versions against each other
-        if (!compare(Y_prelu, Y_prelu_sep, M_ROW, N_COL)) {
+        // Validate PReLU versions against the dense GEMM followed by PReLU
+        for (int i = 0; i < M_ROW * N_COL; ++i) {
+            refY_prelu[i] = (refY[i] < 0.0f) ? prelu_alpha * refY[i] : refY[i];
+        }
+
+        if (!compare(Y_prelu, refY_prelu, M_ROW, N_COL)) {
+            cout << "[ERROR] PReLU basic failed validation!!!" << endl;
+            exit(1);
+        }
+
+        if (!compare(Y_prelu_sep, refY_prelu, M_ROW, N_COL)) {
             cout << "[ERROR] PReLU separate failed validation!!!" << endl;
             exit(1);
         }
         
-        if (!compare(Y_prelu, Y_prelu_otg, M_ROW, N_COL)) {
+        if (!compare(Y_prelu_otg, refY_prelu, M_ROW, N_COL)) {
             cout << "[ERROR] PReLU on-the-go failed validation!!!" << endl;
             exit(1);
         }
 
+        // the fused epilogue entry point is the kernel the on-the-go
+        // version runs, it is validated here and timed as PReLU OnTheGo
+        build_and_check(&Y, M_ROW, N_COL);
+        tcsc_sgemm_fused_bias_prelu(X, W_tsparse, B, prelu_alpha, Y, M_ROW, N_COL, K_LEN);
+
+        if (!compare(Y, refY_prelu, M_ROW, N_COL)) {
+            cout << "[ERROR] PReLU fused epilogue failed validation!!!" << endl;
+            exit(1);
+        }
+
         cout << "[OK] All validation tests passed!\n";
 
         // Performance measurements
@@ -381,6 +1627,27 @@ int main(int argc, char **argv) {
         build_and_check(&Y, M_ROW, N_COL);
         double cycles_tsgemm_opt = measure_tcsc_cycles(tcsc_sgemm_optimized, X, W_tsparse, B, Y, M_ROW, N_COL, K_LEN);
 
+        build_and_check(&Y, M_ROW, N_COL);
+        double cycles_tsgemm_gather = measure_tcsc_cycles(tcsc_sgemm_gather, X, W_tsparse, B, Y, M_ROW, N_COL, K_LEN);
+
+        build_and_check(&Y, M_ROW, N_COL);
+        double cycles_tsgemm_batched = measure_tcsc_cycles(tcsc_sgemm_batched, X, W_tsparse, B, Y, M_ROW, N_COL, K_LEN);
+
+        build_and_check(&Y, M_ROW, N_COL);
+        double cycles_tcsc2 = measure_cycles(tcsc2_sgemm, X, W_tcsc2, B, Y, M_ROW, N_COL, K_LEN);
+
+        build_and_check(&Y, M_ROW, N_COL);
+        double cycles_seg8 = measure_cycles(tcsc_seg_sgemm, X, W_seg8, B, Y, M_ROW, N_COL, K_LEN);
+
+        build_and_check(&Y, M_ROW, N_COL);
+        double cycles_seg16 = measure_cycles(tcsc_seg_sgemm, X, W_seg16, B, Y, M_ROW, N_COL, K_LEN);
+
+        build_and_check(&Y, M_ROW, N_COL);
+        double cycles_bitmap = measure_cycles(tbitmap_sgemm, X, W_bitmap, B, Y, M_ROW, N_COL, K_LEN);
+
+        build_and_check(&Y, M_ROW, N_COL);
+        double cycles_lut = measure_cycles(tlut_sgemm, X, W_lut, B, Y, M_ROW, N_COL, K_LEN);
+
         build_and_check(&Y_prelu, M_ROW, N_COL);
         double cycles_prelu_basic = measure_tcsc_prelu_cycles(tcsc_sgemm_prelu_basic, X, W_tsparse, B, prelu_alpha, Y_prelu, M_ROW, N_COL, K_LEN);
         
@@ -394,6 +1661,21 @@ int main(int argc, char **argv) {
         double perf_gemm = (double)measured_flops_gemm / cycles_gemm_basic;
         double perf_basic = (double)measured_flops_basic / cycles_tsgemm_basic;
         double perf_opt = (double)measured_flops_opt / cycles_tsgemm_opt;
+        double perf_gather = (double)measured_flops_gather / cycles_tsgemm_gather;
+        double perf_batched = (double)measured_flops_batched / cycles_tsgemm_batched;
+        double perf_tcsc2 = (double)measured_flops_tcsc2 / cycles_tcsc2;
+        double perf_seg8 = (double)measured_flops_seg8 / cycles_seg8;
+        double perf_seg16 = (double)measured_flops_seg16 / cycles_seg16;
+        double perf_bitmap = (double)measured_flops_bitmap / cycles_bitmap;
+        double perf_lut = (double)measured_flops_lut / cycles_lut;
+
+        // Weight bytes (offsets + indices) per non-zero element
+        double nnz = (double)(W_tsparse->n_elem_pos + W_tsparse->n_elem_neg);
+        double bpn_tcsc = tcsc_bytes(W_tsparse) / nnz;
+        double bpn_seg8 = tcsc_seg_bytes(W_seg8) / nnz;
+        double bpn_seg16 = tcsc_seg_bytes(W_seg16) / nnz;
+        double bpn_bitmap = tbitmap_bytes(W_bitmap) / nnz;
+        double bpn_lut = tlut_bytes(W_lut) / nnz;
         double perf_prelu_basic = (double)measured_flops_prelu_basic / cycles_prelu_basic;
         double perf_prelu_sep = (double)measured_flops_prelu_sep / cycles_prelu_sep;
         double perf_prelu_otg = (double)measured_flops_prelu_otg / cycles_prelu_otg;
@@ -405,6 +1687,23 @@ int main(int argc, char **argv) {
                            cycles_prelu_sep, measured_flops_prelu_sep, perf_prelu_sep,
                            cycles_prelu_otg, measured_flops_prelu_otg, perf_prelu_otg);
 
+        cout << "  [6] TCSC Gather (" << tcsc_gather_isa() << ") vs Optimized: "
+             << fixed << setprecision(2) << cycles_tsgemm_opt / cycles_tsgemm_gather << "x faster\n";
+        cout << "  [7] TCSC Batched vs Optimized:   "
+             << fixed << setprecision(2) << cycles_tsgemm_opt / cycles_tsgemm_batched << "x faster\n";
+        cout << "  [8] TCSC2 Single-Stream vs Gather: "
+             << fixed << setprecision(2) << cycles_tsgemm_gather / cycles_tcsc2 << "x faster\n";
+        cout << "  [9] TCSC Segmented u8 vs Optimized: "
+             << fixed << setprecision(2) << cycles_tsgemm_opt / cycles_seg8 << "x faster ("
+             << bpn_seg8 << " vs " << bpn_tcsc << " bytes/nnz)\n";
+        cout << "  [10] Bitmap vs Optimized:        "
+             << fixed << setprecision(2) << cycles_tsgemm_opt / cycles_bitmap << "x faster ("
+             << bpn_bitmap << " vs " << bpn_tcsc << " bytes/nnz)\n";
+        cout << "  [11] LUT (g=" << W_lut->g << ") vs Optimized:     "
+             << fixed << setprecision(2) << cycles_tsgemm_opt / cycles_lut << "x faster ("
+             << bpn_lut << " vs " << bpn_tcsc << " bytes/nnz, "
+             << tlut_bits_per_weight(W_lut) << " bits/weight)\n";
+
         // Legacy output for compatibility
         printf(
             "GEMM         cycles=%.0f, flops=%lld, performance=%.4f\n",
@@ -418,6 +1717,47 @@ int main(int argc, char **argv) {
             "TCSC_opt     cycles=%.0f, flops=%lld, performance=%.4f\n", 
             cycles_tsgemm_opt, measured_flops_opt, perf_opt
         );
+        printf(
+            "TCSC_gather  cycles=%.0f, flops=%lld, performance=%.4f\n", 
+            cycles_tsgemm_gather, measured_flops_gather, perf_gather
+        );
+        printf(
+            "TCSC_batched cycles=%.0f, flops=%lld, performance=%.4f\n", 
+            cycles_tsgemm_batched, measured_flops_batched, perf_batched
+        );
+        printf(
+            "TCSC2        cycles=%.0f, flops=%lld, performance=%.4f\n", 
+            cycles_tcsc2, measured_flops_tcsc2, perf_tcsc2
+        );
+        printf(
+            "TCSC_seg8    cycles=%.0f, flops=%lld, performance=%.4f, bytes_per_nnz=%.2f\n", 
+            cycles_seg8, measured_flops_seg8, perf_seg8, bpn_seg8
+        );
+        printf(
+            "TCSC_seg16   cycles=%.0f, flops=%lld, performance=%.4f, bytes_per_nnz=%.2f\n", 
+            cycles_seg16, measured_flops_seg16, perf_seg16, bpn_seg16
+        );
+        printf(
+            "TBITMAP      cycles=%.0f, flops=%lld, performance=%.4f, bytes_per_nnz=%.2f\n", 
+            cycles_bitmap, measured_flops_bitmap, perf_bitmap, bpn_bitmap
+        );
+        printf(
+            "TLUT         cycles=%.0f, flops=%lld, performance=%.4f, bytes_per_nnz=%.2f\n", 
+            cycles_lut, measured_flops_lut, perf_lut, bpn_lut
+        );
+        // one code byte per group, the storage per weight depends on g
+        for (int g = TLUT_MIN_GROUP; g <= TLUT_MAX_GROUP; ++g) {
+            tlut_t *W_lut_g = tlut_from_tcsc(W_tsparse, g);
+            if (!W_lut_g) {
+                cout << "[ERROR] failed to build the LUT matrix\n";
+                exit(1);
+            }
+            printf(
+                "TLUT_g%d      bits_per_weight=%.2f, bytes_per_nnz=%.2f\n",
+                g, tlut_bits_per_weight(W_lut_g), tlut_bytes(W_lut_g) / nnz
+            );
+            tlut_free(W_lut_g);
+        }
         printf(
             "TCSC_PReLU_basic cycles=%.0f, flops=%lld, performance=%.4f\n", 
             cycles_prelu_basic, measured_flops_prelu_basic, perf_prelu_basic
@@ -431,11 +1771,18 @@ int main(int argc, char **argv) {
             cycles_prelu_otg, measured_flops_prelu_otg, perf_prelu_otg
         );
 
+        run_strong_scaling(X, W_tsparse, B, Y, M_ROW, N_COL, K_LEN, cycles_tsgemm_opt);
+
         // Cleanup
         free(Y); free(refY); free(Y_prelu); free(refY_prelu); 
         free(Y_prelu_sep); free(Y_prelu_otg);
         free(W_dense); free(X); free(B);
         tcsc_free(W_tsparse);
+        tcsc2_free((tcsc2_t*)W_tcsc2);
+        tcsc_seg_free((tcsc_seg_t*)W_seg8);
+        tcsc_seg_free((tcsc_seg_t*)W_seg16);
+        tbitmap_free((tbitmap_t*)W_bitmap);
+        tlut_free((tlut_t*)W_lut);
         
         overall_progress.update(test_idx + 1);
         
@@ -445,6 +1792,30 @@ int main(int argc, char **argv) {
     }
     
     overall_progress.finish();
+
+    run_density_sweep(1, 1024, 4096);
+    run_large_shapes(16);
+    run_pool_latency(1, 512, 2048);
+    run_scheduler_comparison(1, 1024, 4096, 500);
+    run_scheduler_comparison(256, 1024, 4096, 20);
+    run_channel_scales(16, 1024, 4096, 50);
+    run_int_activations(64, 1024, 4096, 20);
+    run_half_activations(16);
+    run_dense8_crossover(16, 1024, 4096, 20);
+    run_bitwise_activations(16, 1024, 4096, 20);
+    run_x_sparsity(16, 1024, 4096, 20);
+    run_dataflow_comparison(4);
+    run_sell_comparison(1, 1024, 4096, 200);
+    run_sell_comparison(16, 1024, 4096, 20);
+#ifdef __x86_64__
+    run_bcsr_shapes(16, 1024, 4096, 16, 20);
+    run_bcsc_traversal(1024, 4096, 16);
+    run_ternary_bcsr(1, 1024, 4096, 16, 200);
+    run_ternary_bcsr(16, 1024, 4096, 16, 20);
+    run_bcsr_auto_shape(1, 1024, 4096, 200);
+    run_bcsr_auto_shape(16, 1024, 4096, 20);
+    run_bcsr_parallel(1024, 4096, 16);
+#endif
     
     cout << "\n*** ALL BENCHMARKS COMPLETED! ***\n";
     cout << "[*] Detailed results saved in out.txt\n";
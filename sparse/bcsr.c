@@ -9,19 +9,21 @@
 
 #include "../dense/dense.h"
 #include "bcsr.h"
+#include "epilogue.h"
 #include <immintrin.h>
 
 template<typename T>
 void build(T **a, int m, int n){
-    *a = static_cast<T *>(aligned_alloc(32, m * n * sizeof(T)));
+    // aligned_alloc wants the size to be a multiple of the alignment
+    size_t bytes = ((size_t) m * n * sizeof(T) + 31) / 32 * 32;
+    *a = static_cast<T *>(aligned_alloc(32, bytes));
 }
 
 bcsr_t *bcsr_from_dense(dense_t dense, int rows, int cols, int r, int c) {
-    //assertm(rows % r == 0, "rows not divisible by r")
-    //assertm(cols % c == 0, "cols not divisible by c")
-
-    int br = rows / r;
-    int bc = cols / c;
+    // the last block row/column is padded with zeros if r or c does not
+    // divide the matrix
+    int br = (rows + r - 1) / r;
+    int bc = (cols + c - 1) / c;
 
     /*
      * COUNT THE SHIT
@@ -56,6 +58,7 @@ bcsr_t *bcsr_from_dense(dense_t dense, int rows, int cols, int r, int c) {
                     // index into dense matrix
                     int i = brow * r + row;
                     int j = bcol * c + col;
+                    if (i >= rows || j >= cols) continue;
                     int ij = i * cols + j;
 
                     dense_elem_t val = dense[ij];
@@ -87,20 +90,23 @@ bcsr_t *bcsr_from_dense(dense_t dense, int rows, int cols, int r, int c) {
     matrix->br = br;
     matrix->bc = bc;
     
-    build(&matrix->b_values, k, r * c);
+    // at least one block, so that an all-zero matrix still gets buffers
+    build(&matrix->b_values, (k > 0) ? k : 1, r * c);
     build(&matrix->b_row_start, 1, br + 1);
-    build(&matrix->b_col_idx, 1, k);
+    build(&matrix->b_col_idx, 1, (k > 0) ? k : 1);
     
     if (!matrix->b_values || !matrix->b_row_start || !matrix->b_col_idx) {
         exit(EXIT_FAILURE);
     }
 
 
+    // blocks were numbered in row-major order, so a block row starts at the
+    // number of blocks before it, also when it has no blocks of its own
     b_row_start_index = 0;
 
     for (int brow = 0; brow < br; brow++) {
 
-        bool is_new_row = true;
+        matrix->b_row_start[brow] = b_row_start_index;
 
         for (int bcol = 0; bcol < bc; bcol++) {
 
@@ -110,11 +116,7 @@ bcsr_t *bcsr_from_dense(dense_t dense, int rows, int cols, int r, int c) {
                 // block has only zeros, thus skip it
                 continue;
             }
-
-            if (is_new_row) {
-                matrix->b_row_start[b_row_start_index++] = block_index;
-                is_new_row = false;
-            }
+            b_row_start_index++;
 
             matrix->b_col_idx[block_index] = bcol;
 
@@ -129,12 +131,13 @@ bcsr_t *bcsr_from_dense(dense_t dense, int rows, int cols, int r, int c) {
 
                     // index into block values
                     int bij = block_index * r * c + (row * c + col);
-                    matrix->b_values[bij] = (bcsr_elem_t) dense[ij];
+                    matrix->b_values[bij] = (i < rows && j < cols) ? (bcsr_elem_t) dense[ij] : 0.0f;
                 }
             }
         }
     }
-    matrix->b_row_start[b_row_start_index] = k;
+    matrix->b_row_start[br] = k;
+    free(is_valid_block);
     return matrix;
 }
 
@@ -174,51 +177,6 @@ void bcsr_sgemm_basic(
     }
 }
 
-void bcsr_sgemm_prelu_basic(
-    const dense_t __restrict X, const  bcsr_t __restrict W, const dense_t __restrict B, float a, dense_t __restrict Y,
-    int M, int N, int K
-) {
-    int r = W.r;  // Number of rows in each block
-    int c = W.c;  // Number of columns in each block
-    
-    // Initialize output matrix Y with bias values
-    for (int m = 0; m < M; m++) {
-        for (int n = 0; n < N; n++) {
-            Y[m * N + n] = B[n];
-        }
-    }
-    
-    // Perform sparse-dense matrix multiplication using blocks and apply PReLU in one pass
-    for (int m = 0; m < M; m++) { // For each row in the dense input matrix X
-        for (int br = 0; br < W.br; br++) { // For each block row in the sparse matrix W
-            // Process only non-zero blocks in the current block row
-            for (int bi = W.b_row_start[br]; bi < W.b_row_start[br + 1]; bi++) {
-                int bc = W.b_col_idx[bi]; // Column position of the current block in the output
-                
-                // Dense multiplication within the current block
-                for (int i = 0; i < r; i++) { // For each row in the current block
-                    for (int j = 0; j < c; j++) { // For each column in the current block
-                        // Get the element value from the current block
-                        dense_elem_t val = W.b_values[bi * r * c + i * c + j];
-                        
-                        // Get current output value
-                        float result = Y[m * N + bc * c + j];
-                        
-                        // Multiply, accumulate, and apply PReLU in one step
-                        result += X[m * K + br * r + i] * val;
-                        result = (result > 0) ? result : a * result;
-                        
-                        // Write back to memory only once
-                        Y[m * N + bc * c + j] = result;
-                    }
-                }
-            }
-        }
-    }
-}
-
-
-
 void bcsr_sgemm_avx(
     const dense_t __restrict X, const bcsr_t __restrict W, const dense_t __restrict B, dense_t __restrict Y,
     int M, int N, int K
@@ -261,58 +219,6 @@ void bcsr_sgemm_avx(
 }
 
 
-void bcsr_sgemm_prelu_avx(
-    const dense_t __restrict X, const  bcsr_t __restrict W, const dense_t __restrict B, float a, dense_t __restrict Y,
-    int M, int N, int K
-) {
-    int r = W.r;  // Number of rows in each block
-    int c = W.c;  // Number of columns in each block
-    
-    // Initialize output matrix Y with bias values
-    for (int m = 0; m < M; m++) {
-        for (int n = 0; n < N; n+=8) {
-            __m256 b = _mm256_load_ps(&B[n]);
-            _mm256_store_ps(&Y[m * N + n], b);
-        }
-    }
-    
-    __m256 relu_param = _mm256_set1_ps(a);  
-    __m256 zero = _mm256_setzero_ps();    
-    
-    // Perform sparse-dense matrix multiplication using blocks and apply PReLU in one pass
-    for (int m = 0; m < M; m++) { // For each row in the dense input matrix X
-        for (int br = 0; br < W.br; br++) { // For each block row in the sparse matrix W
-            // Process only non-zero blocks in the current block row
-            for (int bi = W.b_row_start[br]; bi < W.b_row_start[br + 1]; bi++) {
-                int bc = W.b_col_idx[bi]; // Column position of the current block in the output
-                
-
-                // Dense multiplication within the current block, unrolled with avx
-                for (int i = 0; i < r; i++) {
-                    
-                    dense_elem_t val = X[m * K + br * r + i];
-                    __m256 x = _mm256_set1_ps(val);
-
-                    __m256 w = _mm256_load_ps(&W.b_values[bi * r * c + i * c]);
-                    __m256 y = _mm256_load_ps(&Y[m * N + bc * c]);
-
-                    // multiply and accumulate
-                    y = _mm256_fmadd_ps(x, w, y);
-
-                    __m256 mask = _mm256_cmp_ps(y, zero, _CMP_GT_OS);
-                    __m256 neg_part = _mm256_mul_ps(y, relu_param);
-                    y = _mm256_blendv_ps(neg_part, y, mask);
-
-                    _mm256_store_ps(&Y[m * N + bc * c],  y);
-                }
-            
-            }
-        }
-    }
-}
-
-
-
 void bcsr_sgemm_avx2(
     const dense_t __restrict X, const bcsr_t __restrict W, const dense_t __restrict B, dense_t __restrict Y,
     int M, int N, int K
@@ -382,4 +288,888 @@ void bcsr_sgemm_avx2(
             }
         }
     }
-}
\ No newline at end of file
+}
+
+// Scalar kernel for any block shape and any M, N, K: the padded rows and
+// columns of the last block row and block column are skipped
+// Y = X W[block rows br0 .. br1) + B, or without the bias if B is NULL
+static void bcsr_generic_rows(
+    const float *X, const bcsr_t *W, const float *B, float *Y, int M, int N, int K, int br0, int br1
+) {
+    int r = W->r, c = W->c;
+    for (int m = 0; m < M; m++) {
+        float *y = Y + (size_t) m * N;
+        for (int n = 0; n < N; n++) {
+            y[n] = B ? B[n] : 0.0f;
+        }
+        for (int br = br0; br < br1; br++) {
+            int rows = (K - br * r < r) ? K - br * r : r;
+            const float *x = X + (size_t) m * K + br * r;
+            for (int bi = W->b_row_start[br]; bi < W->b_row_start[br + 1]; bi++) {
+                int n0 = W->b_col_idx[bi] * c;
+                int cols = (N - n0 < c) ? N - n0 : c;
+                const float *w = W->b_values + (size_t) bi * r * c;
+                for (int i = 0; i < rows; i++) {
+                    for (int j = 0; j < cols; j++) {
+                        y[n0 + j] += x[i] * w[i * c + j];
+                    }
+                }
+            }
+        }
+    }
+}
+
+void bcsr_sgemm_generic(
+    const dense_t __restrict X, const bcsr_t __restrict W, const dense_t __restrict B, dense_t __restrict Y,
+    int M, int N, int K
+) {
+    bcsr_generic_rows(X, &W, B, Y, M, N, K, 0, W.br);
+}
+
+// Micro-kernel for R x C blocks, C / 8 ymm vectors per block row of Y. The
+// R broadcasts of X are loaded once per block row and every block costs one
+// load and one store of its Y strip for all R * C / 8 FMAs. Padded rows of
+// the last block row see x = 0, the partial last block column is loaded
+// and stored through masks, so N and K need not be multiples of anything.
+// Only block rows [br0, br1) are accumulated, onto B or onto zeros if B is
+// NULL.
+template <int R, int C>
+__attribute__((target("avx2,fma")))
+static void bcsr_kernel(
+    const float *X, const bcsr_t *W, const float *B, float *Y, int M, int N, int K, int br0, int br1
+) {
+    constexpr int V = C / 8;
+    // lanes of the last block column that lie inside Y
+    int tail = N - (W->bc - 1) * C;
+    __m256i mask[V];
+    for (int v = 0; v < V; v++) {
+        int lanes = tail - v * 8;
+        lanes = (lanes < 0) ? 0 : ((lanes > 8) ? 8 : lanes);
+        mask[v] = _mm256_cmpgt_epi32(_mm256_set1_epi32(lanes), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+    }
+
+    for (int m = 0; m < M; m++) {
+        float *y = Y + (size_t) m * N;
+        for (int n = 0; n < N; n++) {
+            y[n] = B ? B[n] : 0.0f;
+        }
+
+        for (int br = br0; br < br1; br++) {
+            const float *xr = X + (size_t) m * K + br * R;
+            int rows = (K - br * R < R) ? K - br * R : R;
+            __m256 x[R];
+            for (int i = 0; i < R; i++) {
+                x[i] = _mm256_set1_ps((i < rows) ? xr[i] : 0.0f);
+            }
+
+            for (int bi = W->b_row_start[br]; bi < W->b_row_start[br + 1]; bi++) {
+                int bcol = W->b_col_idx[bi];
+                const float *w = W->b_values + (size_t) bi * R * C;
+                float *yb = y + bcol * C;
+                bool full = bcol * C + C <= N;
+
+                __m256 acc[V];
+                for (int v = 0; v < V; v++) {
+                    acc[v] = full ? _mm256_loadu_ps(yb + v * 8) : _mm256_maskload_ps(yb + v * 8, mask[v]);
+                }
+                for (int i = 0; i < R; i++) {
+                    for (int v = 0; v < V; v++) {
+                        acc[v] = _mm256_fmadd_ps(x[i], _mm256_loadu_ps(w + i * C + v * 8), acc[v]);
+                    }
+                }
+                for (int v = 0; v < V; v++) {
+                    if (full) _mm256_storeu_ps(yb + v * 8, acc[v]);
+                    else _mm256_maskstore_ps(yb + v * 8, mask[v], acc[v]);
+                }
+            }
+        }
+    }
+}
+
+typedef void (*bcsr_kernel_t)(const float *, const bcsr_t *, const float *, float *, int, int, int, int, int);
+
+// Instantiated block shapes, rows r in {1, 2, 4, 8} and columns c in
+// {8, 16, 32}
+static bcsr_kernel_t bcsr_find_kernel(int r, int c) {
+#define BCSR_KERNELS_FOR_R(R) \
+    if (r == R && c == 8) return bcsr_kernel<R, 8>; \
+    if (r == R && c == 16) return bcsr_kernel<R, 16>; \
+    if (r == R && c == 32) return bcsr_kernel<R, 32>;
+    BCSR_KERNELS_FOR_R(1)
+    BCSR_KERNELS_FOR_R(2)
+    BCSR_KERNELS_FOR_R(4)
+    BCSR_KERNELS_FOR_R(8)
+#undef BCSR_KERNELS_FOR_R
+    return NULL;
+}
+
+bool bcsr_has_kernel(int r, int c) {
+    return bcsr_find_kernel(r, c) != NULL && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+}
+
+void bcsr_sgemm(
+    const dense_t __restrict X, const bcsr_t __restrict W, const dense_t __restrict B, dense_t __restrict Y,
+    int M, int N, int K
+) {
+    if (bcsr_has_kernel(W.r, W.c)) {
+        bcsr_find_kernel(W.r, W.c)(X, &W, B, Y, M, N, K, 0, W.br);
+        return;
+    }
+    bcsr_sgemm_generic(X, W, B, Y, M, N, K);
+}
+
+bcsc_t *bcsc_from_bcsr(const bcsr_t *W) {
+    bcsc_t *V = (bcsc_t*) malloc(sizeof(bcsc_t));
+    if (!V) return NULL;
+
+    V->r = W->r;
+    V->c = W->c;
+    V->br = W->br;
+    V->bc = W->bc;
+    V->k = W->k;
+    V->b_values = W->b_values;
+    V->b_col_start = (int*) calloc(W->bc + 1, sizeof(int));
+    V->b_row_idx = (int*) malloc((W->k + 1) * sizeof(int));
+    V->b_idx = (int*) malloc((W->k + 1) * sizeof(int));
+    if (!V->b_col_start || !V->b_row_idx || !V->b_idx) {
+        bcsc_free(V);
+        return NULL;
+    }
+
+    // counting sort of the blocks by column, block rows stay ascending
+    for (int bi = 0; bi < W->k; bi++) {
+        V->b_col_start[W->b_col_idx[bi] + 1]++;
+    }
+    for (int bc = 0; bc < W->bc; bc++) {
+        V->b_col_start[bc + 1] += V->b_col_start[bc];
+    }
+    int *next = (int*) malloc((W->bc + 1) * sizeof(int));
+    if (!next) {
+        bcsc_free(V);
+        return NULL;
+    }
+    for (int bc = 0; bc <= W->bc; bc++) {
+        next[bc] = V->b_col_start[bc];
+    }
+    for (int br = 0; br < W->br; br++) {
+        for (int bi = W->b_row_start[br]; bi < W->b_row_start[br + 1]; bi++) {
+            int e = next[W->b_col_idx[bi]]++;
+            V->b_row_idx[e] = br;
+            V->b_idx[e] = bi;
+        }
+    }
+    free(next);
+    return V;
+}
+
+// Copies rows [m0, m0 + rows) of X into MB rows of br * r floats, zero
+// padding the rows past M and the columns past K
+static void bcsc_pack_x(
+    const float *X, float *panel, int m0, int rows, int MB, int K, int kpad
+) {
+    for (int mm = 0; mm < MB; mm++) {
+        for (int k = 0; k < kpad; k++) {
+            panel[(size_t) mm * kpad + k] = (mm < rows && k < K) ? X[(size_t) (m0 + mm) * K + k] : 0.0f;
+        }
+    }
+}
+
+// Rows per strip of the specialized kernel for W, MB * c / 8 = 8 ymm
+// accumulators, or single rows when M is smaller than a strip so that GEMV
+// does not pay for padded rows. 0 if W runs on the generic kernel, which
+// reads X directly.
+static int bcsc_strip_rows(const bcsc_t *W, int M) {
+    if (!bcsr_has_kernel(W->r, W->c)) return 0;
+    int MB = 64 / W->c;
+    return (M >= MB) ? MB : 1;
+}
+
+template <class Epilogue>
+static void bcsc_generic(
+    const float *X, const bcsc_t *W, int M, int N, int K, int bc0, int bc1, const Epilogue &epi
+) {
+    int r = W->r, c = W->c;
+    float *acc;
+    build(&acc, 1, c);
+    if (!acc) {
+        exit(EXIT_FAILURE);
+    }
+    for (int m = 0; m < M; m++) {
+        for (int bc = bc0; bc < bc1; bc++) {
+            for (int j = 0; j < c; j++) {
+                acc[j] = 0.0f;
+            }
+            for (int e = W->b_col_start[bc]; e < W->b_col_start[bc + 1]; e++) {
+                int br = W->b_row_idx[e];
+                int rows = (K - br * r < r) ? K - br * r : r;
+                const float *w = W->b_values + (size_t) W->b_idx[e] * r * c;
+                for (int i = 0; i < rows; i++) {
+                    float x = X[(size_t) m * K + br * r + i];
+                    for (int j = 0; j < c; j++) {
+                        acc[j] += x * w[i * c + j];
+                    }
+                }
+            }
+            for (int j = 0; j < c && bc * c + j < N; j++) {
+                epi(acc[j], m, bc * c + j);
+            }
+        }
+    }
+    free(acc);
+}
+
+// MB x C accumulators of Y in registers for one block column (MB * C / 8 =
+// 8 ymm registers at most), each w vector of a block is reused by all MB
+// rows. Computes the block columns [bc0, bc1) of Y. packed holds all
+// strips of X as laid out by bcsc_pack_strips, NULL packs one strip at a
+// time.
+template <int R, int C, int MB, class Epilogue>
+__attribute__((target("avx2,fma")))
+static void bcsc_kernel(
+    const float *X, const float *packed, const bcsc_t *W, int M, int N, int K, int bc0, int bc1,
+    const Epilogue &epi
+) {
+    constexpr int V = C / 8;
+    const int kpad = W->br * R;
+    float *panel = NULL;
+    if (!packed) {
+        build(&panel, MB, kpad);
+        if (!panel) {
+            exit(EXIT_FAILURE);
+        }
+    }
+    alignas(32) float tile[MB * C];
+
+    for (int m0 = 0; m0 < M; m0 += MB) {
+        int rows = (M - m0 < MB) ? M - m0 : MB;
+        const float *strip = packed ? packed + (size_t) m0 * kpad : panel;
+        if (!packed) {
+            bcsc_pack_x(X, panel, m0, rows, MB, K, kpad);
+        }
+
+        for (int bc = bc0; bc < bc1; bc++) {
+            __m256 acc[MB][V];
+            for (int mm = 0; mm < MB; mm++)
+                for (int v = 0; v < V; v++)
+                    acc[mm][v] = _mm256_setzero_ps();
+
+            for (int e = W->b_col_start[bc]; e < W->b_col_start[bc + 1]; e++) {
+                const float *w = W->b_values + (size_t) W->b_idx[e] * R * C;
+                const float *x = strip + W->b_row_idx[e] * R;
+                for (int i = 0; i < R; i++) {
+                    __m256 wv[V];
+                    for (int v = 0; v < V; v++)
+                        wv[v] = _mm256_loadu_ps(w + i * C + v * 8);
+                    for (int mm = 0; mm < MB; mm++) {
+                        __m256 xb = _mm256_broadcast_ss(x + (size_t) mm * kpad + i);
+                        for (int v = 0; v < V; v++)
+                            acc[mm][v] = _mm256_fmadd_ps(xb, wv[v], acc[mm][v]);
+                    }
+                }
+            }
+
+            int n0 = bc * C;
+            if (n0 + C <= N) {
+                for (int mm = 0; mm < rows; mm++)
+                    for (int v = 0; v < V; v++)
+                        epi(acc[mm][v], m0 + mm, n0 + v * 8);
+            } else {
+                for (int mm = 0; mm < rows; mm++)
+                    for (int v = 0; v < V; v++)
+                        _mm256_store_ps(tile + mm * C + v * 8, acc[mm][v]);
+                for (int mm = 0; mm < rows; mm++)
+                    for (int j = 0; n0 + j < N; j++)
+                        epi(tile[mm * C + j], m0 + mm, n0 + j);
+            }
+        }
+    }
+    free(panel);
+}
+
+template <class Epilogue>
+static void bcsc_dispatch(
+    const float *X, const float *packed, const bcsc_t *W, int M, int N, int K, int bc0, int bc1,
+    const Epilogue &epi
+) {
+    int MB = bcsc_strip_rows(W, M);
+    if (MB > 0) {
+#define BCSC_KERNELS_FOR_R(R) \
+        if (W->r == R && W->c == 8) \
+            return (MB == 8) ? bcsc_kernel<R, 8, 8>(X, packed, W, M, N, K, bc0, bc1, epi) \
+                             : bcsc_kernel<R, 8, 1>(X, packed, W, M, N, K, bc0, bc1, epi); \
+        if (W->r == R && W->c == 16) \
+            return (MB == 4) ? bcsc_kernel<R, 16, 4>(X, packed, W, M, N, K, bc0, bc1, epi) \
+                             : bcsc_kernel<R, 16, 1>(X, packed, W, M, N, K, bc0, bc1, epi); \
+        if (W->r == R && W->c == 32) \
+            return (MB == 2) ? bcsc_kernel<R, 32, 2>(X, packed, W, M, N, K, bc0, bc1, epi) \
+                             : bcsc_kernel<R, 32, 1>(X, packed, W, M, N, K, bc0, bc1, epi);
+        BCSC_KERNELS_FOR_R(1)
+        BCSC_KERNELS_FOR_R(2)
+        BCSC_KERNELS_FOR_R(4)
+        BCSC_KERNELS_FOR_R(8)
+#undef BCSC_KERNELS_FOR_R
+    }
+    bcsc_generic(X, W, M, N, K, bc0, bc1, epi);
+}
+
+void bcsc_sgemm(
+    const dense_t __restrict X, const bcsc_t *W, const dense_t __restrict B, dense_t __restrict Y,
+    int M, int N, int K
+) {
+    bcsc_dispatch(X, NULL, W, M, N, K, 0, W->bc, make_epilogue(ep_store_f32{Y, N}, ep_bias{B}));
+}
+
+void bcsc_sgemm_prelu(
+    const dense_t __restrict X, const bcsc_t *W, const dense_t __restrict B, float a, dense_t __restrict Y,
+    int M, int N, int K
+) {
+    bcsc_dispatch(X, NULL, W, M, N, K, 0, W->bc, make_epilogue(ep_store_f32{Y, N}, ep_bias{B}, ep_prelu{a}));
+}
+
+void bcsc_free(bcsc_t *W) {
+    if (W) {
+        free(W->b_col_start);
+        free(W->b_row_idx);
+        free(W->b_idx);
+        free(W);
+    }
+}
+
+size_t bcsr_bytes(const bcsr_t *W) {
+    return ((size_t) W->br + 1 + W->k) * sizeof(int) + (size_t) W->k * W->r * W->c * sizeof(bcsr_elem_t);
+}
+
+void bcsr_analyze(const dense_t dense, int rows, int cols, bcsr_analysis_t *stats) {
+    static const int shape_r[4] = {1, 2, 4, 8};
+    static const int shape_c[3] = {8, 16, 32};
+
+    // bands of 8 rows hold whole block rows of every r
+    int bands = (rows + 7) / 8;
+    int samples = (bands < BCSR_SAMPLE_BANDS) ? bands : BCSR_SAMPLE_BANDS;
+    long blocks[BCSR_N_SHAPES] = {0};
+    long nnz = 0;
+    int sampled_rows = 0;
+
+    // per column of a block row: does any of its r rows have a non-zero
+    bool *any = (bool*) malloc(((size_t) cols + 32) * sizeof(bool));
+    if (!any) {
+        perror("malloc failed @ bcsr_analyze()");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int s = 0; s < samples; s++) {
+        int row0 = (int) ((long) s * bands / samples) * 8;
+        int row1 = (row0 + 8 < rows) ? row0 + 8 : rows;
+        sampled_rows += row1 - row0;
+        for (int i = row0; i < row1; i++)
+            for (int j = 0; j < cols; j++)
+                nnz += (dense[(size_t) i * cols + j] != 0.0f);
+
+        for (int ri = 0; ri < 4; ri++) {
+            int r = shape_r[ri];
+            for (int b0 = row0; b0 < row1; b0 += r) {
+                for (int j = 0; j < cols + 32; j++)
+                    any[j] = false;
+                for (int i = b0; i < b0 + r && i < row1; i++)
+                    for (int j = 0; j < cols; j++)
+                        any[j] = any[j] || dense[(size_t) i * cols + j] != 0.0f;
+
+                for (int ci = 0; ci < 3; ci++) {
+                    int c = shape_c[ci];
+                    for (int j0 = 0; j0 < cols; j0 += c) {
+                        bool hit = false;
+                        for (int j = j0; j < j0 + c; j++)
+                            hit = hit || any[j];
+                        blocks[ri * 3 + ci] += hit;
+                    }
+                }
+            }
+        }
+    }
+    free(any);
+
+    // scale the sampled bands up to all of W
+    double scale = (sampled_rows > 0) ? (double) rows / sampled_rows : 0.0;
+    stats->rows = rows;
+    stats->cols = cols;
+    stats->sampled_rows = sampled_rows;
+    stats->nnz = (long) (nnz * scale + 0.5);
+    stats->best = 0;
+    for (int ri = 0; ri < 4; ri++) {
+        for (int ci = 0; ci < 3; ci++) {
+            bcsr_shape_stats_t *shape = &stats->shapes[ri * 3 + ci];
+            int r = shape_r[ri], c = shape_c[ci];
+            long k = (long) (blocks[ri * 3 + ci] * scale + 0.5);
+            int br = (rows + r - 1) / r;
+
+            shape->r = r;
+            shape->c = c;
+            shape->blocks = k;
+            shape->fill = (k > 0) ? (float) ((double) stats->nnz / ((double) k * r * c)) : 0.0f;
+            shape->bytes = ((size_t) br + 1 + k) * sizeof(int) + (size_t) k * r * c * sizeof(bcsr_elem_t);
+
+            double per_block = r * (c / 8) * BCSR_CYCLES_PER_FMA + 2 * (c / 8) * BCSR_CYCLES_PER_Y
+                + BCSR_CYCLES_PER_BLOCK;
+            double compute = k * per_block + br * BCSR_CYCLES_PER_BLOCK_ROW;
+            double memory = shape->bytes / BCSR_BYTES_PER_CYCLE;
+            shape->cycles = (compute > memory) ? compute : memory;
+            if (shape->cycles < stats->shapes[stats->best].cycles)
+                stats->best = ri * 3 + ci;
+        }
+    }
+}
+
+bcsr_t *bcsr_from_dense_auto(dense_t dense, int rows, int cols, bcsr_analysis_t *stats) {
+    bcsr_analysis_t local;
+    if (!stats) stats = &local;
+    bcsr_analyze(dense, rows, cols, stats);
+    const bcsr_shape_stats_t *best = &stats->shapes[stats->best];
+    return bcsr_from_dense(dense, rows, cols, best->r, best->c);
+}
+
+// Arguments of one pool run. Part p covers the block columns
+// [bc_bounds[p], bc_bounds[p + 1]), in block row br its blocks are
+// [cuts[p * br_count + br], cuts[(p + 1) * br_count + br]).
+typedef struct {
+    const float *X;
+    const bcsr_t *W;
+    const float *B;
+    float *Y;
+    int M, N, K;
+    const int *bc_bounds;
+    const int *cuts;
+    int tile_n; // scheduled runs: columns per tile, tile p0 is part n0 / tile_n
+} bcsr_pool_args_t;
+
+// For every part boundary and block row the first block at or after the
+// boundary column, found in one linear sweep over b_col_idx instead of a
+// binary search per task and block row. Returns a malloc'd
+// (parts + 1) x br array.
+static int *bcsr_column_cuts(const bcsr_t *W, const int *bc_bounds, int parts) {
+    int *cuts = (int*) malloc((size_t) (parts + 1) * W->br * sizeof(int));
+    if (!cuts) {
+        exit(EXIT_FAILURE);
+    }
+    for (int br = 0; br < W->br; br++) {
+        int bi = W->b_row_start[br], end = W->b_row_start[br + 1];
+        for (int p = 0; p <= parts; p++) {
+            while (bi < end && W->b_col_idx[bi] < bc_bounds[p]) bi++;
+            cuts[(size_t) p * W->br + br] = bi;
+        }
+    }
+    return cuts;
+}
+
+// Accumulates blocks [bi0, bi1) of one block row into y, c fixed at
+// compile time for the common widths so the block row vectorizes. Only the
+// first rows rows of x and the columns below N of y are touched, which
+// skips the padding of the last block row and block column.
+template <int C>
+static inline void bcsr_row_blocks(
+    const float *x, const bcsr_t *W, float *y, int r, int c, int rows, int N, int bi0, int bi1
+) {
+    const int cc = C ? C : c;
+    for (int bi = bi0; bi < bi1; bi++) {
+        const float *w = W->b_values + (size_t) bi * r * cc;
+        int n0 = W->b_col_idx[bi] * cc;
+        float *yb = y + n0;
+        if (n0 + cc <= N) {
+            for (int i = 0; i < rows; i++) {
+                for (int j = 0; j < cc; j++) {
+                    yb[j] += x[i] * w[i * cc + j];
+                }
+            }
+        } else {
+            for (int i = 0; i < rows; i++) {
+                for (int j = 0; j < N - n0; j++) {
+                    yb[j] += x[i] * w[i * cc + j];
+                }
+            }
+        }
+    }
+}
+
+// Computes rows [m0, m1) of the block columns [bc0, bc1) of Y, the blocks
+// of block row br are [start[br], end[br])
+static void bcsr_block_range(
+    const float *X, const bcsr_t *W, const float *B, float *Y,
+    int N, int K, int m0, int m1, int bc0, int bc1, const int *start, const int *end
+) {
+    int r = W->r, c = W->c;
+    if (bc0 == bc1) return;
+
+    int n1 = (bc1 * c < N) ? bc1 * c : N;
+    for (int m = m0; m < m1; m++) {
+        float *y = Y + (size_t) m * N;
+        for (int n = bc0 * c; n < n1; n++) {
+            y[n] = B[n];
+        }
+
+        for (int br = 0; br < W->br; br++) {
+            int rows = (K - br * r < r) ? K - br * r : r;
+            const float *x = X + (size_t) m * K + br * r;
+            if (c == 8) bcsr_row_blocks<8>(x, W, y, r, c, rows, N, start[br], end[br]);
+            else if (c == 16) bcsr_row_blocks<16>(x, W, y, r, c, rows, N, start[br], end[br]);
+            else bcsr_row_blocks<0>(x, W, y, r, c, rows, N, start[br], end[br]);
+        }
+    }
+}
+
+static void bcsr_pool_task(void *arg, int task) {
+    const bcsr_pool_args_t *args = (const bcsr_pool_args_t*) arg;
+    int br = args->W->br;
+    bcsr_block_range(args->X, args->W, args->B, args->Y, args->N, args->K,
+                     0, args->M, args->bc_bounds[task], args->bc_bounds[task + 1],
+                     args->cuts + (size_t) task * br, args->cuts + (size_t) (task + 1) * br);
+}
+
+void bcsr_sgemm_pool(
+    tpool_t *pool, const dense_t __restrict X, const bcsr_t __restrict W, const dense_t __restrict B, dense_t __restrict Y,
+    int M, int N, int K
+) {
+    int parts = tpool_threads(pool);
+    int *bc_bounds = (int*) malloc((parts + 1) * sizeof(int));
+    if (!bc_bounds) {
+        exit(EXIT_FAILURE);
+    }
+
+    // block columns per 64 bytes of Y
+    int align = (W.c < 16) ? 16 / W.c : 1;
+    for (int p = 0; p <= parts; p++) {
+        int bc = (int) ((long) W.bc * p / parts);
+        bc = (bc + align / 2) / align * align;
+        bc_bounds[p] = (p == parts || bc > W.bc) ? W.bc : bc;
+    }
+    int *cuts = bcsr_column_cuts(&W, bc_bounds, parts);
+
+    bcsr_pool_args_t args = {X, &W, B, Y, M, N, K, bc_bounds, cuts, 0};
+    tpool_run(pool, bcsr_pool_task, &args, parts);
+    free(bc_bounds);
+    free(cuts);
+}
+
+static void bcsr_sched_tile(void *arg, const tsched_tile_t *tile) {
+    const bcsr_pool_args_t *args = (const bcsr_pool_args_t*) arg;
+    int br = args->W->br;
+    int p0 = tile->n0 / args->tile_n, p1 = p0 + 1;
+    bcsr_block_range(args->X, args->W, args->B, args->Y, args->N, args->K,
+                     tile->m0, tile->m1, args->bc_bounds[p0], args->bc_bounds[p1],
+                     args->cuts + (size_t) p0 * br, args->cuts + (size_t) p1 * br);
+}
+
+void bcsr_sgemm_sched(
+    tpool_t *pool, const dense_t __restrict X, const bcsr_t __restrict W, const dense_t __restrict B, dense_t __restrict Y,
+    int M, int N, int K, tsched_mode_t mode, double *busy_ns
+) {
+    // BCSR is stored by block rows, so every column tile jumps through all
+    // block rows of b_values; tiles are made as wide as the load balance
+    // allows, in whole blocks
+    int nb = N / (TSCHED_TILES_PER_THREAD * tpool_threads(pool));
+    if (nb < TSCHED_TILE_N) nb = TSCHED_TILE_N;
+    nb = (nb > W.c) ? nb / W.c * W.c : W.c;
+    int ntiles;
+    tsched_tile_t *tiles = tsched_tiles(M, N, TSCHED_TILE_M, nb, &ntiles);
+    long *cost = (long*) malloc(ntiles * sizeof(long));
+    int n_tiles = (N + nb - 1) / nb;
+    int *bc_bounds = (int*) malloc((n_tiles + 1) * sizeof(int));
+    long *blocks = (long*) malloc(n_tiles * sizeof(long));
+    if (!tiles || !cost || !bc_bounds || !blocks) {
+        exit(EXIT_FAILURE);
+    }
+
+    // one part per column tile
+    for (int p = 0; p <= n_tiles; p++) {
+        bc_bounds[p] = (p * nb / W.c < W.bc) ? p * nb / W.c : W.bc;
+    }
+    int *cuts = bcsr_column_cuts(&W, bc_bounds, n_tiles);
+
+    for (int p = 0; p < n_tiles; p++) {
+        blocks[p] = 0;
+        for (int br = 0; br < W.br; br++) {
+            blocks[p] += cuts[(size_t) (p + 1) * W.br + br] - cuts[(size_t) p * W.br + br];
+        }
+    }
+    for (int i = 0; i < ntiles; i++) {
+        cost[i] = (blocks[tiles[i].n0 / nb] + W.br) * (tiles[i].m1 - tiles[i].m0);
+    }
+
+    bcsr_pool_args_t args = {X, &W, B, Y, M, N, K, bc_bounds, cuts, nb};
+    tsched_run(pool, tiles, cost, ntiles, mode, bcsr_sched_tile, &args, busy_ns);
+
+    free(tiles);
+    free(cost);
+    free(bc_bounds);
+    free(cuts);
+    free(blocks);
+}
+
+// Splits the block rows or columns [0, n) into parts of about equal cost,
+// the blocks of row or column i being [start[i], start[i + 1]) and each
+// row or column costing one block more. Bounds are rounded to multiples of
+// align. Returns the largest part over the mean part.
+static double bcsr_balance(const int *start, int n, int parts, int align, int *bounds) {
+    long total = (long) start[n] + n;
+    int i = 0;
+    bounds[0] = 0;
+    for (int p = 1; p < parts; p++) {
+        long target = total * p / parts;
+        while (i < n && (long) start[i] + i < target) i++;
+        int b = (i + align / 2) / align * align;
+        if (b < bounds[p - 1]) b = bounds[p - 1];
+        if (b > n) b = n;
+        bounds[p] = b;
+    }
+    bounds[parts] = n;
+
+    long worst = 0;
+    for (int p = 0; p < parts; p++) {
+        long cost = ((long) start[bounds[p + 1]] + bounds[p + 1]) - ((long) start[bounds[p]] + bounds[p]);
+        if (cost > worst) worst = cost;
+    }
+    return (total > 0) ? (double) worst * parts / total : 1.0;
+}
+
+bcsr_par_t *bcsr_par_create(const bcsr_t *W, const tpool_t *pool) {
+    bcsr_par_t *P = (bcsr_par_t*) calloc(1, sizeof(bcsr_par_t));
+    if (!P) return NULL;
+
+    P->W = W;
+    P->parts = tpool_threads(pool);
+    P->V = bcsc_from_bcsr(W);
+    P->bounds = (int*) malloc((P->parts + 1) * sizeof(int));
+    int *row_bounds = (int*) malloc((P->parts + 1) * sizeof(int));
+    if (!P->V || !P->bounds || !row_bounds) {
+        free(row_bounds);
+        bcsr_par_free(P);
+        return NULL;
+    }
+
+    // block columns per 64 bytes of Y
+    int align = (W->c < 16) ? 16 / W->c : 1;
+    double columns = bcsr_balance(P->V->b_col_start, W->bc, P->parts, align, P->bounds);
+    double rows = bcsr_balance(W->b_row_start, W->br, P->parts, 1, row_bounds);
+    P->mode = BCSR_PAR_COLUMNS;
+    P->imbalance = columns;
+    // one part needs no reduction, and the block-row kernel streams W in
+    // order where the view gathers it
+    if (P->parts == 1 || (columns > BCSR_PAR_MAX_IMBALANCE && rows < columns)) {
+        P->mode = BCSR_PAR_ROWS;
+        P->imbalance = rows;
+        for (int p = 0; p <= P->parts; p++) {
+            P->bounds[p] = row_bounds[p];
+        }
+        bcsc_free(P->V);
+        P->V = NULL;
+    }
+    free(row_bounds);
+    return P;
+}
+
+typedef struct {
+    const float *X;
+    const bcsr_par_t *P;
+    const float *B;
+    float *Y;
+    int M, N, K;
+    int MB;               // rows per strip of P->packed, 0 if X is not packed
+} bcsr_par_args_t;
+
+// Packs an equal range of the strips of X into P->packed, so that the
+// column parts share one copy instead of each packing all of X
+static void bcsr_par_pack_task(void *arg, int task) {
+    const bcsr_par_args_t *args = (const bcsr_par_args_t*) arg;
+    const bcsr_par_t *P = args->P;
+    int MB = args->MB, kpad = P->V->br * P->V->r;
+    int strips = (args->M + MB - 1) / MB;
+    for (int s = strips * task / P->parts; s < strips * (task + 1) / P->parts; s++) {
+        int rows = (args->M - s * MB < MB) ? args->M - s * MB : MB;
+        bcsc_pack_x(args->X, P->packed + (size_t) s * MB * kpad, s * MB, rows, MB, args->K, kpad);
+    }
+}
+
+static void bcsr_par_columns_task(void *arg, int task) {
+    const bcsr_par_args_t *args = (const bcsr_par_args_t*) arg;
+    const bcsr_par_t *P = args->P;
+    if (P->bounds[task] == P->bounds[task + 1]) return;
+    bcsc_dispatch(args->X, args->MB ? P->packed : NULL, P->V, args->M, args->N, args->K,
+                  P->bounds[task], P->bounds[task + 1],
+                  make_epilogue(ep_store_f32{args->Y, args->N}, ep_bias{args->B}));
+}
+
+// Part 0 accumulates onto B in Y, the others onto zeros in their copy
+static void bcsr_par_rows_task(void *arg, int task) {
+    const bcsr_par_args_t *args = (const bcsr_par_args_t*) arg;
+    const bcsr_par_t *P = args->P;
+    const bcsr_t *W = P->W;
+    int M = args->M, N = args->N, K = args->K;
+    float *Y = (task == 0) ? args->Y : P->partial + (size_t) (task - 1) * M * N;
+    const float *B = (task == 0) ? args->B : NULL;
+
+    if (bcsr_has_kernel(W->r, W->c)) {
+        bcsr_find_kernel(W->r, W->c)(args->X, W, B, Y, M, N, K, P->bounds[task], P->bounds[task + 1]);
+    } else {
+        bcsr_generic_rows(args->X, W, B, Y, M, N, K, P->bounds[task], P->bounds[task + 1]);
+    }
+}
+
+// Adds the private copies into Y, every task an equal range of columns
+static void bcsr_par_reduce_task(void *arg, int task) {
+    const bcsr_par_args_t *args = (const bcsr_par_args_t*) arg;
+    const bcsr_par_t *P = args->P;
+    int M = args->M, N = args->N;
+    int n0 = (int) ((long) N * task / P->parts) / 16 * 16;
+    int n1 = (task + 1 == P->parts) ? N : (int) ((long) N * (task + 1) / P->parts) / 16 * 16;
+
+    for (int m = 0; m < M; m++) {
+        float *y = args->Y + (size_t) m * N;
+        for (int q = 0; q < P->parts - 1; q++) {
+            const float *part = P->partial + ((size_t) q * M + m) * N;
+            for (int n = n0; n < n1; n++) {
+                y[n] += part[n];
+            }
+        }
+    }
+}
+
+void bcsr_sgemm_par(
+    tpool_t *pool, bcsr_par_t *P, const dense_t __restrict X, const dense_t __restrict B, dense_t __restrict Y,
+    int M, int N, int K
+) {
+    bcsr_par_args_t args = {X, P, B, Y, M, N, K, 0};
+    if (P->mode == BCSR_PAR_COLUMNS) {
+        args.MB = bcsc_strip_rows(P->V, M);
+        if (args.MB > 0) {
+            int strips = (M + args.MB - 1) / args.MB;
+            size_t size = (size_t) strips * args.MB * P->V->br * P->V->r;
+            if (size > P->packed_size) {
+                free(P->packed);
+                build(&P->packed, strips * args.MB, P->V->br * P->V->r);
+                if (!P->packed) {
+                    perror("aligned_alloc failed @ bcsr_sgemm_par()");
+                    exit(EXIT_FAILURE);
+                }
+                P->packed_size = size;
+            }
+            tpool_run(pool, bcsr_par_pack_task, &args, P->parts);
+        }
+        tpool_run(pool, bcsr_par_columns_task, &args, P->parts);
+        return;
+    }
+
+    if (P->parts == 1) {
+        bcsr_par_rows_task(&args, 0);
+        return;
+    }
+    size_t size = (size_t) (P->parts - 1) * M * N;
+    if (size > P->partial_size) {
+        free(P->partial);
+        build(&P->partial, (P->parts - 1) * M, N);
+        if (!P->partial) {
+            perror("aligned_alloc failed @ bcsr_sgemm_par()");
+            exit(EXIT_FAILURE);
+        }
+        P->partial_size = size;
+    }
+    tpool_run(pool, bcsr_par_rows_task, &args, P->parts);
+    tpool_run(pool, bcsr_par_reduce_task, &args, P->parts);
+}
+
+void bcsr_par_free(bcsr_par_t *P) {
+    if (P) {
+        bcsc_free(P->V);
+        free(P->bounds);
+        free(P->partial);
+        free(P->packed);
+        free(P);
+    }
+}
+
+// BCSR kernel with a compile-time epilogue (see epilogue.h). A row of Y is
+// only complete after the last block row, so every row is accumulated in an
+// L1-resident scratch row and then passed through epi once, 8 columns at a
+// time, before the next row starts. Y itself is written exactly once. The
+// scratch row spans all bc * c columns, so blocks of the last block column
+// are accumulated whole and only the columns below N reach epi. AVX
+// accumulates c == 8 blocks with one FMA per block row like bcsr_sgemm_avx;
+// other widths fall back to the generic row kernels.
+template <bool AVX, class Epilogue>
+static void bcsr_sgemm_epilogue(
+    const dense_t X, const bcsr_t *W, int M, int N, int K, const Epilogue &epi
+) {
+    int r = W->r, c = W->c, width = W->bc * c;
+    float *acc;
+    build(&acc, 1, width);
+    if (!acc) {
+        exit(EXIT_FAILURE);
+    }
+
+    for (int m = 0; m < M; m++) {
+        for (int n = 0; n < width; n++) {
+            acc[n] = 0.0f;
+        }
+        for (int br = 0; br < W->br; br++) {
+            int rows = (K - br * r < r) ? K - br * r : r;
+            const float *x = X + (size_t) m * K + br * r;
+            int bi0 = W->b_row_start[br], bi1 = W->b_row_start[br + 1];
+            if (AVX && c == 8) {
+                for (int bi = bi0; bi < bi1; bi++) {
+                    float *y = acc + W->b_col_idx[bi] * 8;
+                    const float *w = W->b_values + (size_t) bi * r * 8;
+                    __m256 v = _mm256_loadu_ps(y);
+                    for (int i = 0; i < rows; i++) {
+                        v = _mm256_fmadd_ps(_mm256_set1_ps(x[i]), _mm256_loadu_ps(w + i * 8), v);
+                    }
+                    _mm256_storeu_ps(y, v);
+                }
+            } else if (c == 8) bcsr_row_blocks<8>(x, W, acc, r, c, rows, width, bi0, bi1);
+            else if (c == 16) bcsr_row_blocks<16>(x, W, acc, r, c, rows, width, bi0, bi1);
+            else bcsr_row_blocks<0>(x, W, acc, r, c, rows, width, bi0, bi1);
+        }
+
+        int n = 0;
+        for (; n + 7 < N; n += 8) {
+            epi(_mm256_loadu_ps(acc + n), m, n);
+        }
+        for (; n < N; n++) {
+            epi(acc[n], m, n);
+        }
+    }
+    free(acc);
+}
+
+void bcsr_sgemm_fused_bias(
+    const dense_t __restrict X, const bcsr_t __restrict W, const dense_t __restrict B, dense_t __restrict Y,
+    int M, int N, int K
+) {
+    bcsr_sgemm_epilogue<false>(X, &W, M, N, K, make_epilogue(ep_store_f32{Y, N}, ep_bias{B}));
+}
+
+void bcsr_sgemm_fused_bias_relu(
+    const dense_t __restrict X, const bcsr_t __restrict W, const dense_t __restrict B, dense_t __restrict Y,
+    int M, int N, int K
+) {
+    bcsr_sgemm_epilogue<false>(X, &W, M, N, K, make_epilogue(ep_store_f32{Y, N}, ep_bias{B}, ep_relu{}));
+}
+
+void bcsr_sgemm_fused_bias_prelu(
+    const dense_t __restrict X, const bcsr_t __restrict W, const dense_t __restrict B, float a, dense_t __restrict Y,
+    int M, int N, int K
+) {
+    bcsr_sgemm_epilogue<false>(X, &W, M, N, K, make_epilogue(ep_store_f32{Y, N}, ep_bias{B}, ep_prelu{a}));
+}
+
+// PReLU is the last stage of the epilogue, applied once to every finished
+// sum instead of to the partial sums of each block row
+void bcsr_sgemm_prelu_basic(
+    const dense_t __restrict X, const bcsr_t __restrict W, const dense_t __restrict B, float a, dense_t __restrict Y,
+    int M, int N, int K
+) {
+    bcsr_sgemm_epilogue<false>(X, &W, M, N, K, make_epilogue(ep_store_f32{Y, N}, ep_bias{B}, ep_prelu{a}));
+}
+
+void bcsr_sgemm_prelu_avx(
+    const dense_t __restrict X, const bcsr_t __restrict W, const dense_t __restrict B, float a, dense_t __restrict Y,
+    int M, int N, int K
+) {
+    bcsr_sgemm_epilogue<true>(X, &W, M, N, K, make_epilogue(ep_store_f32{Y, N}, ep_bias{B}, ep_prelu{a}));
+}
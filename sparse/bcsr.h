@@ -1,6 +1,8 @@
 #pragma once
 
 #include "../dense/dense.h"
+#include "tpool.h"
+#include "tsched.h"
 
 typedef float bcsr_elem_t;
 
@@ -11,8 +13,27 @@ typedef struct {
     bcsr_elem_t *b_values;
 } bcsr_t;
 
+// Blocks of r x c elements, rows and cols need not be multiples of r and c:
+// the last block row and block column are padded with zeros. Block rows
+// without any non-zero block are empty ranges of b_row_start.
 bcsr_t *bcsr_from_dense(dense_t dense, int rows, int cols, int r, int c);
 
+// Block-column view of a bcsr_t: the blocks of block column bc are
+// [b_col_start[bc], b_col_start[bc + 1]) in increasing block row. The view
+// shares b_values with the bcsr_t it was built from, which must outlive it.
+typedef struct {
+    int r, c, br, bc, k;
+    int *b_col_start;
+    int *b_row_idx; // block row of each block
+    int *b_idx;     // index of each block in b_values
+    const bcsr_elem_t *b_values;
+} bcsc_t;
+
+bcsc_t *bcsc_from_bcsr(const bcsr_t *W);
+
+// The basic and AVX kernels below need K and N to be multiples of r and c
+// (and N of 8 for the AVX ones), bcsr_sgemm handles any shape.
+
 void bcsr_sgemm_basic(
     const  dense_t __restrict X, const bcsr_t __restrict W, const dense_t __restrict B,  dense_t __restrict Y,
     int M, int N, int K
@@ -36,4 +57,161 @@ void bcsr_sgemm_prelu_avx(
 void bcsr_sgemm_avx2(
     const dense_t __restrict X, const bcsr_t __restrict W, const dense_t __restrict B, dense_t __restrict Y,
     int M, int N, int K
-);
\ No newline at end of file
+);
+
+// Scalar kernel for any block shape, M, N and K
+void bcsr_sgemm_generic(
+    const dense_t __restrict X, const bcsr_t __restrict W, const dense_t __restrict B, dense_t __restrict Y,
+    int M, int N, int K
+);
+
+// True if bcsr_sgemm has a compile-time specialized AVX2 micro-kernel for
+// r x c blocks on this CPU: r in {1, 2, 4, 8} and c in {8, 16, 32}
+bool bcsr_has_kernel(int r, int c);
+
+// Dispatches on W.r and W.c to the specialized micro-kernel, with masked
+// loads and stores for a partial last block column, and falls back to
+// bcsr_sgemm_generic for other block shapes
+void bcsr_sgemm(
+    const dense_t __restrict X, const bcsr_t __restrict W, const dense_t __restrict B, dense_t __restrict Y,
+    int M, int N, int K
+);
+
+// Column-stationary kernels on the block-column view: a strip of rows of
+// Y under one block column stays in registers while all blocks of that
+// column are accumulated, every block is loaded once per strip of 8 / (c / 8)
+// rows of X (one row when M is smaller), and the epilogue runs once on the
+// finished strip. Specialized
+// for the shapes of bcsr_has_kernel, any M, N and K.
+void bcsc_sgemm(
+    const dense_t __restrict X, const bcsc_t *W, const dense_t __restrict B, dense_t __restrict Y,
+    int M, int N, int K
+);
+
+void bcsc_sgemm_prelu(
+    const dense_t __restrict X, const bcsc_t *W, const dense_t __restrict B, float a, dense_t __restrict Y,
+    int M, int N, int K
+);
+
+void bcsc_free(bcsc_t *W);
+
+// Bytes of b_row_start, b_col_idx and the float payload of the blocks
+size_t bcsr_bytes(const bcsr_t *W);
+
+// Block shape analysis. bcsr_analyze samples BCSR_SAMPLE_BANDS evenly
+// spaced bands of 8 rows of W (all of W if it has fewer) and estimates for
+// every shape r in {1, 2, 4, 8}, c in {8, 16, 32} the number of non-zero
+// blocks, the fill ratio, bcsr_bytes and the cycles of bcsr_sgemm per row
+// of X. The cost model charges every block its FMAs with their W loads and
+// the load and store of c / 8 vectors of Y, plus fixed costs per block and
+// per block row, and takes the larger of that and the time to stream W at
+// BCSR_BYTES_PER_CYCLE.
+#ifndef BCSR_SAMPLE_BANDS
+#define BCSR_SAMPLE_BANDS 64
+#endif
+#define BCSR_CYCLES_PER_FMA 0.5
+#define BCSR_CYCLES_PER_Y 1.0
+#define BCSR_CYCLES_PER_BLOCK 2.0
+#define BCSR_CYCLES_PER_BLOCK_ROW 4.0
+#define BCSR_BYTES_PER_CYCLE 8.0
+#define BCSR_N_SHAPES 12
+
+typedef struct {
+    int r, c;
+    long blocks;   // estimated non-zero blocks of all of W
+    float fill;    // non-zeros over stored block elements
+    size_t bytes;  // estimated bcsr_bytes
+    double cycles; // predicted cycles per row of X
+} bcsr_shape_stats_t;
+
+typedef struct {
+    int rows, cols;
+    int sampled_rows;
+    long nnz;      // estimated non-zeros of all of W
+    int best;      // index of the shape with the fewest predicted cycles
+    bcsr_shape_stats_t shapes[BCSR_N_SHAPES];
+} bcsr_analysis_t;
+
+void bcsr_analyze(const dense_t dense, int rows, int cols, bcsr_analysis_t *stats);
+
+// bcsr_from_dense with the shape bcsr_analyze predicts to be fastest, the
+// analysis is written to stats unless it is NULL
+bcsr_t *bcsr_from_dense_auto(dense_t dense, int rows, int cols, bcsr_analysis_t *stats);
+
+// Runs on a persistent pool, every thread computes an equal range of block
+// columns of Y (aligned to 64 bytes of Y where c allows it)
+void bcsr_sgemm_pool(
+    tpool_t *pool, const dense_t __restrict X, const bcsr_t __restrict W, const dense_t __restrict B, dense_t __restrict Y,
+    int M, int N, int K
+);
+
+// Tiled kernel on the tile scheduler, tiles are TSCHED_TILE_M rows by
+// about N / (TSCHED_TILES_PER_THREAD * threads) columns in whole blocks,
+// cost = blocks (plus one per block row) times rows. busy_ns may be NULL,
+// see tsched_run.
+void bcsr_sgemm_sched(
+    tpool_t *pool, const dense_t __restrict X, const bcsr_t __restrict W, const dense_t __restrict B, dense_t __restrict Y,
+    int M, int N, int K, tsched_mode_t mode, double *busy_ns
+);
+
+// Parallel BCSR engine. Block rows scatter into the same columns of Y, so
+// threads never share block rows of W for one output. BCSR_PAR_COLUMNS gives
+// every thread a range of block columns of the BCSC view (no two threads
+// write the same Y), BCSR_PAR_ROWS gives every thread a range of block rows
+// with a private copy of Y that are summed into Y at the end. Both split on
+// block count (plus one per block row or column). Columns are used unless
+// their split is more than BCSR_PAR_MAX_IMBALANCE times the mean part and
+// the row split is better, i.e. for W with few or skewed block columns. A
+// single thread runs the block-row kernel directly.
+#ifndef BCSR_PAR_MAX_IMBALANCE
+#define BCSR_PAR_MAX_IMBALANCE 1.1
+#endif
+
+typedef enum {
+    BCSR_PAR_COLUMNS,
+    BCSR_PAR_ROWS
+} bcsr_par_mode_t;
+
+typedef struct {
+    const bcsr_t *W;
+    bcsc_t *V;            // column view, BCSR_PAR_COLUMNS only
+    bcsr_par_mode_t mode;
+    int parts;
+    int *bounds;          // parts + 1 block columns or block rows
+    double imbalance;     // largest part over the mean part, in blocks
+    float *partial;       // parts - 1 private copies of Y, BCSR_PAR_ROWS only
+    size_t partial_size;
+    float *packed;        // X packed once for all parts, BCSR_PAR_COLUMNS only
+    size_t packed_size;
+} bcsr_par_t;
+
+// One part per thread of pool. W must outlive the plan. Returns NULL on
+// failure.
+bcsr_par_t *bcsr_par_create(const bcsr_t *W, const tpool_t *pool);
+
+// Same result as bcsr_sgemm on the specialized kernels. Must not be called
+// concurrently on the same plan, the private copies of Y and the packed X
+// are kept in it.
+void bcsr_sgemm_par(
+    tpool_t *pool, bcsr_par_t *P, const dense_t __restrict X, const dense_t __restrict B, dense_t __restrict Y,
+    int M, int N, int K
+);
+
+void bcsr_par_free(bcsr_par_t *P);
+
+// Kernels with a fused epilogue (epilogue.h): the bias and activation are
+// applied once to the finished row instead of to every partial sum
+void bcsr_sgemm_fused_bias(
+    const dense_t __restrict X, const bcsr_t __restrict W, const dense_t __restrict B, dense_t __restrict Y,
+    int M, int N, int K
+);
+
+void bcsr_sgemm_fused_bias_relu(
+    const dense_t __restrict X, const bcsr_t __restrict W, const dense_t __restrict B, dense_t __restrict Y,
+    int M, int N, int K
+);
+
+void bcsr_sgemm_fused_bias_prelu(
+    const dense_t __restrict X, const bcsr_t __restrict W, const dense_t __restrict B, float a, dense_t __restrict Y,
+    int M, int N, int K
+);
@@ -0,0 +1,182 @@
+#ifndef EPILOGUE_H
+#define EPILOGUE_H
+
+#include <stdint.h>
+#include <math.h>
+#include <tuple>
+#include <utility>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+// Compile-time epilogues for the GEMM kernels. An epilogue is a chain of
+// stages applied to the finished accumulator of Y[m, n] followed by one
+// store, so a new activation costs neither an extra pass over Y nor an
+// extra copy of the kernel loop.
+//
+// A stage maps (y, m, n) -> y. With AVX2 every stage also maps a vector of
+// the 8 consecutive columns n .. n+7 of row m, which the vectorized kernels
+// use on their register tiles.
+
+// y + B[n]
+struct ep_bias {
+    const float *B;
+    inline float operator()(float y, int, int n) const { return y + B[n]; }
+#ifdef __AVX2__
+    inline __m256 operator()(__m256 y, int, int n) const {
+        return _mm256_add_ps(y, _mm256_loadu_ps(B + n));
+    }
+#endif
+};
+
+// max(y, 0)
+struct ep_relu {
+    inline float operator()(float y, int, int) const { return (y < 0.0f) ? 0.0f : y; }
+#ifdef __AVX2__
+    inline __m256 operator()(__m256 y, int, int) const {
+        return _mm256_max_ps(y, _mm256_setzero_ps());
+    }
+#endif
+};
+
+// y < 0 ? a * y : y with one slope for all channels
+struct ep_prelu {
+    float a;
+    inline float operator()(float y, int, int) const { return (y < 0.0f) ? a * y : y; }
+#ifdef __AVX2__
+    inline __m256 operator()(__m256 y, int, int) const {
+        __m256 neg = _mm256_cmp_ps(y, _mm256_setzero_ps(), _CMP_LT_OQ);
+        return _mm256_blendv_ps(y, _mm256_mul_ps(y, _mm256_set1_ps(a)), neg);
+    }
+#endif
+};
+
+// y < 0 ? alpha[n] * y : y with one slope per output channel
+struct ep_prelu_channel {
+    const float *alpha;
+    inline float operator()(float y, int, int n) const { return (y < 0.0f) ? alpha[n] * y : y; }
+#ifdef __AVX2__
+    inline __m256 operator()(__m256 y, int, int n) const {
+        __m256 neg = _mm256_cmp_ps(y, _mm256_setzero_ps(), _CMP_LT_OQ);
+        return _mm256_blendv_ps(y, _mm256_mul_ps(y, _mm256_loadu_ps(alpha + n)), neg);
+    }
+#endif
+};
+
+// min(max(y, lo), hi)
+struct ep_clamp {
+    float lo, hi;
+    inline float operator()(float y, int, int) const {
+        return (y < lo) ? lo : ((y > hi) ? hi : y);
+    }
+#ifdef __AVX2__
+    inline __m256 operator()(__m256 y, int, int) const {
+        return _mm256_min_ps(_mm256_max_ps(y, _mm256_set1_ps(lo)), _mm256_set1_ps(hi));
+    }
+#endif
+};
+
+// y + R[m, n] for a residual R with leading dimension ldr
+struct ep_residual {
+    const float *R;
+    int ldr;
+    inline float operator()(float y, int m, int n) const { return y + R[(size_t) m * ldr + n]; }
+#ifdef __AVX2__
+    inline __m256 operator()(__m256 y, int m, int n) const {
+        return _mm256_add_ps(y, _mm256_loadu_ps(R + (size_t) m * ldr + n));
+    }
+#endif
+};
+
+// s * y
+struct ep_scale {
+    float s;
+    inline float operator()(float y, int, int) const { return s * y; }
+#ifdef __AVX2__
+    inline __m256 operator()(__m256 y, int, int) const {
+        return _mm256_mul_ps(y, _mm256_set1_ps(s));
+    }
+#endif
+};
+
+// scale[n] * y with one scale per output column
+struct ep_col_scale {
+    const float *scale;
+    inline float operator()(float y, int, int n) const { return scale[n] * y; }
+#ifdef __AVX2__
+    inline __m256 operator()(__m256 y, int, int n) const {
+        return _mm256_mul_ps(y, _mm256_loadu_ps(scale + n));
+    }
+#endif
+};
+
+// Group scale, one scale per group of size consecutive rows of a weight
+// column. Unlike the stages above it acts on a partial sum: kernels that
+// take it split the reduction of Y[m, n] at the group boundaries and map
+// the partial sum y of group g through it before adding it up. scale is
+// column-major, group g of column n is scale[n * n_groups + g].
+struct ep_group_scale {
+    const float *scale;
+    int size;
+    int n_groups;
+    inline float operator()(float y, int g, int n) const {
+        return scale[(size_t) n * n_groups + g] * y;
+    }
+};
+
+// Stores: write the final value of Y[m, n].
+
+// float output with leading dimension ldy
+struct ep_store_f32 {
+    float *Y;
+    int ldy;
+    inline void operator()(float y, int m, int n) const { Y[(size_t) m * ldy + n] = y; }
+#ifdef __AVX2__
+    inline void operator()(__m256 y, int m, int n) const {
+        _mm256_storeu_ps(Y + (size_t) m * ldy + n, y);
+    }
+#endif
+};
+
+// int8 output q = clamp(round(y / scale) + zero_point, -128, 127)
+struct ep_store_q8 {
+    int8_t *Q;
+    int ldq;
+    float inv_scale;
+    int zero_point;
+    inline void operator()(float y, int m, int n) const {
+        int q = (int) lrintf(y * inv_scale) + zero_point;
+        Q[(size_t) m * ldq + n] = (int8_t) ((q < -128) ? -128 : ((q > 127) ? 127 : q));
+    }
+#ifdef __AVX2__
+    inline void operator()(__m256 y, int m, int n) const {
+        __m256i q = _mm256_cvtps_epi32(_mm256_mul_ps(y, _mm256_set1_ps(inv_scale)));
+        q = _mm256_add_epi32(q, _mm256_set1_epi32(zero_point));
+        // saturating packs to 16 and then 8 bit keep the lane order, the
+        // low 8 bytes hold the 8 results
+        __m128i q16 = _mm_packs_epi32(_mm256_castsi256_si128(q), _mm256_extracti128_si256(q, 1));
+        __m128i q8 = _mm_packs_epi16(q16, q16);
+        _mm_storel_epi64((__m128i*) (Q + (size_t) m * ldq + n), q8);
+    }
+#endif
+};
+
+// Stages applied in order, then the store
+template <class Store, class... Stages>
+struct epilogue {
+    Store store;
+    std::tuple<Stages...> stages;
+
+    template <class V>
+    inline void operator()(V y, int m, int n) const {
+        std::apply([&](const Stages &... stage) { ((y = stage(y, m, n)), ...); }, stages);
+        store(y, m, n);
+    }
+};
+
+template <class Store, class... Stages>
+inline epilogue<Store, Stages...> make_epilogue(Store store, Stages... stages) {
+    return epilogue<Store, Stages...>{store, std::tuple<Stages...>(stages...)};
+}
+
+#endif
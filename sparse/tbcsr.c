@@ -0,0 +1,300 @@
+#include "tbcsr.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+tbcsr_t *tbcsr_from_bcsr(const bcsr_t *W) {
+    if (W->c != 8 && W->c != 16 && W->c != 32) return NULL;
+
+    tbcsr_t *T = (tbcsr_t*) malloc(sizeof(tbcsr_t));
+    if (!T) return NULL;
+
+    T->r = W->r;
+    T->c = W->c;
+    T->br = W->br;
+    T->bc = W->bc;
+    T->k = W->k;
+    size_t bytes = (size_t) W->k * W->r * (W->c / 8);
+    T->b_row_start = (int*) malloc((W->br + 1) * sizeof(int));
+    T->b_col_idx = (int*) malloc((W->k + 1) * sizeof(int));
+    T->b_pos = (uint8_t*) calloc(bytes + 1, 1);
+    T->b_neg = (uint8_t*) calloc(bytes + 1, 1);
+    if (!T->b_row_start || !T->b_col_idx || !T->b_pos || !T->b_neg) {
+        tbcsr_free(T);
+        return NULL;
+    }
+    memcpy(T->b_row_start, W->b_row_start, (W->br + 1) * sizeof(int));
+    memcpy(T->b_col_idx, W->b_col_idx, W->k * sizeof(int));
+
+    for (size_t e = 0; e < (size_t) W->k * W->r * W->c; e++) {
+        float value = W->b_values[e];
+        uint8_t bit = (uint8_t) (1u << (e % 8));
+        if (value == 1.0f) {
+            T->b_pos[e / 8] |= bit;
+        } else if (value == -1.0f) {
+            T->b_neg[e / 8] |= bit;
+        } else if (value != 0.0f) {
+            tbcsr_free(T);
+            return NULL;
+        }
+    }
+    return T;
+}
+
+tbcsr_t *tbcsr_from_dense(dense_t dense, int rows, int cols, int r, int c) {
+    // bcsr_from_dense only keeps blocks with a -1 or +1 and would drop any
+    // other value in an otherwise empty block
+    for (size_t i = 0; i < (size_t) rows * cols; i++) {
+        if (dense[i] != 0.0f && dense[i] != 1.0f && dense[i] != -1.0f) return NULL;
+    }
+    if (c != 8 && c != 16 && c != 32) return NULL;
+
+    bcsr_t *W = bcsr_from_dense(dense, rows, cols, r, c);
+    tbcsr_t *T = tbcsr_from_bcsr(W);
+    free(W->b_values);
+    free(W->b_row_start);
+    free(W->b_col_idx);
+    free(W);
+    return T;
+}
+
+// The c mask bits of one block row
+static inline uint32_t load_bits(const uint8_t *p, int bytes) {
+    uint32_t bits = 0;
+    memcpy(&bits, p, bytes);
+    return bits;
+}
+
+void tbcsr_sgemm_basic(
+    const dense_t X, const tbcsr_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+) {
+    const int r = W->r, c = W->c, bytes = c / 8;
+    for (int m = 0; m < M; ++m) {
+        float *y = Y + (size_t) m * N;
+        for (int n = 0; n < N; ++n)
+            y[n] = B[n];
+
+        for (int br = 0; br < W->br; ++br) {
+            int rows = (K - br * r < r) ? K - br * r : r;
+            const float *x = X + (size_t) m * K + br * r;
+            for (int bi = W->b_row_start[br]; bi < W->b_row_start[br + 1]; ++bi) {
+                float *yb = y + W->b_col_idx[bi] * c;
+                for (int i = 0; i < rows; ++i) {
+                    size_t off = ((size_t) bi * r + i) * bytes;
+                    // bits past N are 0, padded columns are never touched
+                    for (uint32_t p = load_bits(W->b_pos + off, bytes); p; p &= p - 1)
+                        yb[__builtin_ctz(p)] += x[i];
+                    for (uint32_t q = load_bits(W->b_neg + off, bytes); q; q &= q - 1)
+                        yb[__builtin_ctz(q)] -= x[i];
+                }
+            }
+        }
+    }
+}
+
+#ifdef __x86_64__
+#include <immintrin.h>
+
+// Expands the low 8 bits of bits into an all-ones/all-zeros lane mask
+__attribute__((target("avx2")))
+static inline __m256i expand_mask8(uint32_t bits) {
+    const __m256i lane_bit = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+    __m256i b = _mm256_and_si256(_mm256_set1_epi32((int) (bits & 0xff)), lane_bit);
+    return _mm256_cmpeq_epi32(b, lane_bit);
+}
+
+template <int R, int C>
+__attribute__((target("avx2")))
+static void gemm_avx2(
+    const float *X, const tbcsr_t *W, const float *B, float *Y, int M, int N, int K
+) {
+    constexpr int V = C / 8;
+    // lanes of the last block column that lie inside Y
+    int tail = N - (W->bc - 1) * C;
+    __m256i mask[V];
+    for (int v = 0; v < V; v++) {
+        int lanes = tail - v * 8;
+        lanes = (lanes < 0) ? 0 : ((lanes > 8) ? 8 : lanes);
+        mask[v] = _mm256_cmpgt_epi32(_mm256_set1_epi32(lanes), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+    }
+
+    for (int m = 0; m < M; m++) {
+        float *y = Y + (size_t) m * N;
+        for (int n = 0; n < N; n++)
+            y[n] = B[n];
+
+        for (int br = 0; br < W->br; br++) {
+            const float *xr = X + (size_t) m * K + br * R;
+            int rows = (K - br * R < R) ? K - br * R : R;
+            __m256 x[R];
+            for (int i = 0; i < R; i++)
+                x[i] = _mm256_set1_ps((i < rows) ? xr[i] : 0.0f);
+
+            for (int bi = W->b_row_start[br]; bi < W->b_row_start[br + 1]; bi++) {
+                int bcol = W->b_col_idx[bi];
+                float *yb = y + bcol * C;
+                bool full = bcol * C + C <= N;
+                const uint8_t *pos = W->b_pos + (size_t) bi * R * V;
+                const uint8_t *neg = W->b_neg + (size_t) bi * R * V;
+
+                __m256 acc[V];
+                for (int v = 0; v < V; v++)
+                    acc[v] = full ? _mm256_loadu_ps(yb + v * 8) : _mm256_maskload_ps(yb + v * 8, mask[v]);
+                for (int i = 0; i < R; i++) {
+                    uint32_t p = load_bits(pos + i * V, V), q = load_bits(neg + i * V, V);
+                    for (int v = 0; v < V; v++) {
+                        __m256 pm = _mm256_castsi256_ps(expand_mask8(p >> (8 * v)));
+                        __m256 nm = _mm256_castsi256_ps(expand_mask8(q >> (8 * v)));
+                        acc[v] = _mm256_add_ps(acc[v], _mm256_and_ps(x[i], pm));
+                        acc[v] = _mm256_sub_ps(acc[v], _mm256_and_ps(x[i], nm));
+                    }
+                }
+                for (int v = 0; v < V; v++) {
+                    if (full) _mm256_storeu_ps(yb + v * 8, acc[v]);
+                    else _mm256_maskstore_ps(yb + v * 8, mask[v], acc[v]);
+                }
+            }
+        }
+    }
+}
+
+template <int R, int C>
+__attribute__((target("avx512f")))
+static void gemm_avx512(
+    const float *X, const tbcsr_t *W, const float *B, float *Y, int M, int N, int K
+) {
+    constexpr int V = C / 16;
+    int tail = N - (W->bc - 1) * C;
+    __mmask16 mask[V];
+    for (int v = 0; v < V; v++) {
+        int lanes = tail - v * 16;
+        lanes = (lanes < 0) ? 0 : ((lanes > 16) ? 16 : lanes);
+        mask[v] = (__mmask16) ((1u << lanes) - 1);
+    }
+
+    for (int m = 0; m < M; m++) {
+        float *y = Y + (size_t) m * N;
+        for (int n = 0; n < N; n++)
+            y[n] = B[n];
+
+        for (int br = 0; br < W->br; br++) {
+            const float *xr = X + (size_t) m * K + br * R;
+            int rows = (K - br * R < R) ? K - br * R : R;
+            __m512 x[R];
+            for (int i = 0; i < R; i++)
+                x[i] = _mm512_set1_ps((i < rows) ? xr[i] : 0.0f);
+
+            for (int bi = W->b_row_start[br]; bi < W->b_row_start[br + 1]; bi++) {
+                int bcol = W->b_col_idx[bi];
+                float *yb = y + bcol * C;
+                bool full = bcol * C + C <= N;
+                const uint8_t *pos = W->b_pos + (size_t) bi * R * (C / 8);
+                const uint8_t *neg = W->b_neg + (size_t) bi * R * (C / 8);
+
+                __m512 acc[V];
+                for (int v = 0; v < V; v++)
+                    acc[v] = full ? _mm512_loadu_ps(yb + v * 16) : _mm512_maskz_loadu_ps(mask[v], yb + v * 16);
+                for (int i = 0; i < R; i++) {
+                    uint32_t p = load_bits(pos + i * (C / 8), C / 8);
+                    uint32_t q = load_bits(neg + i * (C / 8), C / 8);
+                    for (int v = 0; v < V; v++) {
+                        acc[v] = _mm512_mask_add_ps(acc[v], (__mmask16) (p >> (16 * v)), acc[v], x[i]);
+                        acc[v] = _mm512_mask_sub_ps(acc[v], (__mmask16) (q >> (16 * v)), acc[v], x[i]);
+                    }
+                }
+                for (int v = 0; v < V; v++) {
+                    if (full) _mm512_storeu_ps(yb + v * 16, acc[v]);
+                    else _mm512_mask_storeu_ps(yb + v * 16, mask[v], acc[v]);
+                }
+            }
+        }
+    }
+}
+
+typedef void (*tbcsr_kernel_t)(const float *, const tbcsr_t *, const float *, float *, int, int, int);
+
+static tbcsr_kernel_t find_avx2(int r, int c) {
+#define KERNELS_FOR_R(R) \
+    if (r == R && c == 8) return gemm_avx2<R, 8>; \
+    if (r == R && c == 16) return gemm_avx2<R, 16>; \
+    if (r == R && c == 32) return gemm_avx2<R, 32>;
+    KERNELS_FOR_R(1)
+    KERNELS_FOR_R(2)
+    KERNELS_FOR_R(4)
+    KERNELS_FOR_R(8)
+#undef KERNELS_FOR_R
+    return NULL;
+}
+
+static tbcsr_kernel_t find_avx512(int r, int c) {
+#define KERNELS_FOR_R(R) \
+    if (r == R && c == 16) return gemm_avx512<R, 16>; \
+    if (r == R && c == 32) return gemm_avx512<R, 32>;
+    KERNELS_FOR_R(1)
+    KERNELS_FOR_R(2)
+    KERNELS_FOR_R(4)
+    KERNELS_FOR_R(8)
+#undef KERNELS_FOR_R
+    return NULL;
+}
+
+void tbcsr_sgemm_avx2(
+    const dense_t X, const tbcsr_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+) {
+    tbcsr_kernel_t kernel = find_avx2(W->r, W->c);
+    if (kernel) kernel(X, W, B, Y, M, N, K);
+    else tbcsr_sgemm_basic(X, W, B, Y, M, N, K);
+}
+
+void tbcsr_sgemm_avx512(
+    const dense_t X, const tbcsr_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+) {
+    tbcsr_kernel_t kernel = find_avx512(W->r, W->c);
+    if (kernel) kernel(X, W, B, Y, M, N, K);
+    else tbcsr_sgemm_avx2(X, W, B, Y, M, N, K);
+}
+#endif
+
+void tbcsr_sgemm(
+    const dense_t X, const tbcsr_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+) {
+#ifdef __x86_64__
+    if (find_avx512(W->r, W->c) && __builtin_cpu_supports("avx512f")) {
+        tbcsr_sgemm_avx512(X, W, B, Y, M, N, K);
+        return;
+    }
+    if (find_avx2(W->r, W->c) && __builtin_cpu_supports("avx2")) {
+        tbcsr_sgemm_avx2(X, W, B, Y, M, N, K);
+        return;
+    }
+#endif
+    tbcsr_sgemm_basic(X, W, B, Y, M, N, K);
+}
+
+const char *tbcsr_isa(const tbcsr_t *W) {
+#ifdef __x86_64__
+    if (find_avx512(W->r, W->c) && __builtin_cpu_supports("avx512f"))
+        return "avx512";
+    if (find_avx2(W->r, W->c) && __builtin_cpu_supports("avx2"))
+        return "avx2";
+#endif
+    return "scalar";
+}
+
+size_t tbcsr_bytes(const tbcsr_t *W) {
+    return ((size_t) W->br + 1 + W->k) * sizeof(int) + 2 * (size_t) W->k * W->r * (W->c / 8);
+}
+
+void tbcsr_free(tbcsr_t *W) {
+    if (W) {
+        free(W->b_row_start);
+        free(W->b_col_idx);
+        free(W->b_pos);
+        free(W->b_neg);
+        free(W);
+    }
+}
@@ -0,0 +1,69 @@
+#ifndef TBCSR_H
+#define TBCSR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "../dense/dense.h"
+#include "bcsr.h"
+
+// Ternary BCSR: the block structure of bcsr_t (b_row_start, b_col_idx)
+// with the payload of every block as two bitmasks instead of r * c floats.
+// Row i of block bi is c bits in each of b_pos and b_neg, stored in c / 8
+// bytes at (bi * r + i) * (c / 8), bit j is column j of the block. That is
+// 2 bits per weight against 32 for bcsr_t.
+typedef struct {
+    int r, c, br, bc, k;
+    int *b_row_start;
+    int *b_col_idx;
+    uint8_t *b_pos;
+    uint8_t *b_neg;
+} tbcsr_t;
+
+// Block widths with a bitmask payload: c in {8, 16, 32}, any r. Returns
+// NULL for other widths, for values of W other than -1, 0 and +1, or if out
+// of memory.
+tbcsr_t *tbcsr_from_bcsr(const bcsr_t *W);
+
+// bcsr_from_dense followed by tbcsr_from_bcsr, NULL for the same widths and
+// for any value of dense other than -1, 0 and +1
+tbcsr_t *tbcsr_from_dense(dense_t dense, int rows, int cols, int r, int c);
+
+// Scalar kernel, iterates the set bits of every block row
+void tbcsr_sgemm_basic(
+    const dense_t X, const tbcsr_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+
+// SIMD kernels on broadcast X specialized for r in {1, 2, 4, 8}: AVX2
+// expands 8 mask bits at a time into lane masks for and/sub, AVX-512 uses
+// 16 bits as the k-mask of masked adds and subtracts (c in {16, 32}). Any
+// M, N and K, the partial last block column is loaded and stored through
+// masks like in bcsr_sgemm.
+#ifdef __x86_64__
+void tbcsr_sgemm_avx2(
+    const dense_t X, const tbcsr_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+
+void tbcsr_sgemm_avx512(
+    const dense_t X, const tbcsr_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+#endif
+
+// Runtime dispatch to the widest kernel for W->r, W->c and the CPU,
+// tbcsr_sgemm_basic otherwise
+void tbcsr_sgemm(
+    const dense_t X, const tbcsr_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+
+// Name of the instruction set tbcsr_sgemm dispatches to for W
+const char *tbcsr_isa(const tbcsr_t *W);
+
+// Bytes of the block structure plus payload, see bcsr_bytes
+size_t tbcsr_bytes(const tbcsr_t *W);
+
+void tbcsr_free(tbcsr_t *W);
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef TBITACT_H
+#define TBITACT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "../dense/dense.h"
+#include "tbitmap.h"
+
+// Ternary activations as two bitplanes per row, the row-major counterpart
+// of tbitmap_t: bit r of word m * n_words + w is column 64 * w + r of row
+// m. A row of X and a column of a tbitmap_t with the same K line up word
+// for word.
+typedef struct {
+    int rows, cols;
+    int n_words; // words per row, ceil(cols / 64)
+    // have rows*n_words many elements
+    uint64_t* pos;
+    uint64_t* neg;
+} tbitact_t;
+
+// All-zero activations of rows x cols, e.g. the output of
+// tbitact_gemm_ternary
+tbitact_t *tbitact_create(int rows, int cols);
+
+// x > threshold becomes +1, x < -threshold becomes -1, anything else 0.
+// With threshold 0.5 a dense {-1, 0, +1} (or binary {-1, +1}) matrix is
+// taken over exactly.
+tbitact_t *tbitact_from_dense(const dense_t X, int rows, int cols, float threshold);
+
+// Writes the activations as a dense rows x cols matrix of -1, 0, +1
+void tbitact_to_dense(const tbitact_t *X, dense_t out);
+
+// Y = XW + B with ternary X and W, the W bitmap comes from
+// tbitmap_from_dense or tbitmap_from_tcsc. Per pair of words
+//  x.w = popcount((xp & wp) | (xn & wn)) - popcount((xp & wn) | (xn & wp))
+// (the planes of one operand are disjoint, so the OR of the agreeing and
+// of the disagreeing terms needs two popcounts instead of four).
+void tbitact_sgemm_basic(
+    const tbitact_t *X, const tbitmap_t *W, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+
+#ifdef __x86_64__
+// 8 words per step with vpopcntq, masked loads for the last words
+void tbitact_sgemm_avx512(
+    const tbitact_t *X, const tbitmap_t *W, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+#endif
+
+// Runtime dispatch to the vpopcntq kernel, tbitact_sgemm_basic otherwise
+void tbitact_sgemm(
+    const tbitact_t *X, const tbitmap_t *W, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+
+// Z = ternarize(XW + B, threshold) as in tbitact_from_dense, the next
+// layer's activations are written directly as bitplanes. Z has to be an
+// M x N tbitact_t.
+void tbitact_gemm_ternary(
+    const tbitact_t *X, const tbitmap_t *W, const dense_t B, float threshold, tbitact_t *Z,
+    int M, int N, int K
+);
+
+// Name of the instruction set tbitact_sgemm dispatches to
+const char *tbitact_isa(void);
+
+void tbitact_free(tbitact_t *X);
+
+#endif
@@ -0,0 +1,206 @@
+#include "tbitmap.h"
+#include <stdlib.h>
+#include <stdio.h>
+
+static tbitmap_t *tbitmap_alloc(int rows, int cols) {
+    tbitmap_t* sparse = (tbitmap_t*) malloc(sizeof(tbitmap_t));
+    if (!sparse) return NULL;
+
+    sparse->rows = rows;
+    sparse->cols = cols;
+    sparse->n_words = (rows + 63) / 64;
+    sparse->n_elem_pos = 0;
+    sparse->n_elem_neg = 0;
+    sparse->pos = (uint64_t*) calloc((size_t) cols * sparse->n_words, sizeof(uint64_t));
+    sparse->neg = (uint64_t*) calloc((size_t) cols * sparse->n_words, sizeof(uint64_t));
+
+    if (!sparse->pos || !sparse->neg) {
+        tbitmap_free(sparse);
+        return NULL;
+    }
+    return sparse;
+}
+
+tbitmap_t *tbitmap_from_dense(dense_t dense, int rows, int cols) {
+    tbitmap_t* sparse = tbitmap_alloc(rows, cols);
+    if (!sparse) return NULL;
+
+    for (int i = 0; i < rows; ++i) {
+        for (int j = 0; j < cols; ++j) {
+            float value = dense[i * cols + j];
+            size_t w = (size_t) j * sparse->n_words + i / 64;
+            uint64_t bit = 1ull << (i % 64);
+            if (value == 1.0f) {
+                sparse->pos[w] |= bit;
+                sparse->n_elem_pos++;
+            } else if (value == -1.0f) {
+                sparse->neg[w] |= bit;
+                sparse->n_elem_neg++;
+            }
+        }
+    }
+    return sparse;
+}
+
+tbitmap_t *tbitmap_from_tcsc(const tcsc_t *W) {
+    tbitmap_t* sparse = tbitmap_alloc(W->rows, W->cols);
+    if (!sparse) return NULL;
+
+    for (int j = 0; j < W->cols; ++j) {
+        uint64_t *pos = sparse->pos + (size_t) j * sparse->n_words;
+        uint64_t *neg = sparse->neg + (size_t) j * sparse->n_words;
+        for (int k = W->col_start_pos[j]; k < W->col_start_pos[j + 1]; ++k) {
+            int i = W->row_index_pos[k];
+            pos[i / 64] |= 1ull << (i % 64);
+        }
+        for (int k = W->col_start_neg[j]; k < W->col_start_neg[j + 1]; ++k) {
+            int i = W->row_index_neg[k];
+            neg[i / 64] |= 1ull << (i % 64);
+        }
+    }
+    sparse->n_elem_pos = W->n_elem_pos;
+    sparse->n_elem_neg = W->n_elem_neg;
+    return sparse;
+}
+
+// Basic bitmap SGEMM
+void tbitmap_sgemm_basic(
+    const dense_t X, const tbitmap_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+) {
+    for (int m = 0; m < M; ++m) {
+        const float *x = X + (size_t) m * K;
+        for (int n = 0; n < N; ++n) {
+            const uint64_t *pos = W->pos + (size_t) n * W->n_words;
+            const uint64_t *neg = W->neg + (size_t) n * W->n_words;
+            float y = 0.0f;
+            for (int w = 0; w < W->n_words; ++w) {
+                const float *xw = x + 64 * w;
+                for (uint64_t bits = pos[w]; bits; bits &= bits - 1) {
+                    y += xw[__builtin_ctzll(bits)];
+                }
+                for (uint64_t bits = neg[w]; bits; bits &= bits - 1) {
+                    y -= xw[__builtin_ctzll(bits)];
+                }
+            }
+            Y[m * N + n] = y + B[n];
+        }
+    }
+}
+
+size_t tbitmap_bytes(const tbitmap_t *W) {
+    return 2 * (size_t) W->cols * W->n_words * sizeof(uint64_t);
+}
+
+void tbitmap_free(tbitmap_t *W) {
+    if (W) {
+        free(W->pos);
+        free(W->neg);
+        free(W);
+    }
+}
+
+#ifdef __x86_64__
+#include <immintrin.h>
+
+// Expands the low 8 bits of bits into an all-ones/all-zeros lane mask
+__attribute__((target("avx2")))
+static inline __m256i expand_mask8(uint64_t bits) {
+    const __m256i lane_bit = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+    __m256i b = _mm256_and_si256(_mm256_set1_epi32((int) (bits & 0xff)), lane_bit);
+    return _mm256_cmpeq_epi32(b, lane_bit);
+}
+
+__attribute__((target("avx2")))
+static inline float hsum8(__m256 v) {
+    __m128 lo = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    lo = _mm_add_ps(lo, _mm_movehl_ps(lo, lo));
+    lo = _mm_add_ss(lo, _mm_movehdup_ps(lo));
+    return _mm_cvtss_f32(lo);
+}
+
+// AVX2 bitmap SGEMM
+__attribute__((target("avx2")))
+void tbitmap_sgemm_avx2(
+    const dense_t X, const tbitmap_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+) {
+    for (int m = 0; m < M; ++m) {
+        const float *x = X + (size_t) m * K;
+        for (int n = 0; n < N; ++n) {
+            const uint64_t *pos = W->pos + (size_t) n * W->n_words;
+            const uint64_t *neg = W->neg + (size_t) n * W->n_words;
+            __m256 acc0 = _mm256_setzero_ps();
+            __m256 acc1 = _mm256_setzero_ps();
+            for (int w = 0; w < W->n_words; ++w) {
+                uint64_t p = pos[w], q = neg[w];
+                if (!(p | q)) continue;
+                const float *xw = x + 64 * w;
+                for (int s = 0; s < 64; s += 16, p >>= 16, q >>= 16) {
+                    __m256i pm0 = expand_mask8(p), nm0 = expand_mask8(q);
+                    __m256i pm1 = expand_mask8(p >> 8), nm1 = expand_mask8(q >> 8);
+                    // masked loads never touch rows past K, their bits are 0
+                    __m256 x0 = _mm256_maskload_ps(xw + s, _mm256_or_si256(pm0, nm0));
+                    __m256 x1 = _mm256_maskload_ps(xw + s + 8, _mm256_or_si256(pm1, nm1));
+                    acc0 = _mm256_add_ps(acc0, _mm256_and_ps(x0, _mm256_castsi256_ps(pm0)));
+                    acc1 = _mm256_add_ps(acc1, _mm256_and_ps(x1, _mm256_castsi256_ps(pm1)));
+                    acc0 = _mm256_sub_ps(acc0, _mm256_and_ps(x0, _mm256_castsi256_ps(nm0)));
+                    acc1 = _mm256_sub_ps(acc1, _mm256_and_ps(x1, _mm256_castsi256_ps(nm1)));
+                }
+            }
+            Y[m * N + n] = B[n] + hsum8(_mm256_add_ps(acc0, acc1));
+        }
+    }
+}
+
+// AVX-512 bitmap SGEMM
+__attribute__((target("avx512f")))
+void tbitmap_sgemm_avx512(
+    const dense_t X, const tbitmap_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+) {
+    for (int m = 0; m < M; ++m) {
+        const float *x = X + (size_t) m * K;
+        for (int n = 0; n < N; ++n) {
+            const uint64_t *pos = W->pos + (size_t) n * W->n_words;
+            const uint64_t *neg = W->neg + (size_t) n * W->n_words;
+            __m512 acc0 = _mm512_setzero_ps();
+            __m512 acc1 = _mm512_setzero_ps();
+            for (int w = 0; w < W->n_words; ++w) {
+                uint64_t p = pos[w], q = neg[w];
+                if (!(p | q)) continue;
+                const float *xw = x + 64 * w;
+                for (int s = 0; s < 64; s += 32, p >>= 32, q >>= 32) {
+                    __mmask16 pm0 = (__mmask16) p, nm0 = (__mmask16) q;
+                    __mmask16 pm1 = (__mmask16) (p >> 16), nm1 = (__mmask16) (q >> 16);
+                    // masked loads never touch rows past K, their bits are 0
+                    __m512 x0 = _mm512_maskz_loadu_ps(pm0 | nm0, xw + s);
+                    __m512 x1 = _mm512_maskz_loadu_ps(pm1 | nm1, xw + s + 16);
+                    acc0 = _mm512_mask_add_ps(acc0, pm0, acc0, x0);
+                    acc1 = _mm512_mask_add_ps(acc1, pm1, acc1, x1);
+                    acc0 = _mm512_mask_sub_ps(acc0, nm0, acc0, x0);
+                    acc1 = _mm512_mask_sub_ps(acc1, nm1, acc1, x1);
+                }
+            }
+            Y[m * N + n] = B[n] + _mm512_reduce_add_ps(_mm512_add_ps(acc0, acc1));
+        }
+    }
+}
+#endif
+
+void tbitmap_sgemm(
+    const dense_t X, const tbitmap_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+) {
+#ifdef __x86_64__
+    if (__builtin_cpu_supports("avx512f")) {
+        tbitmap_sgemm_avx512(X, W, B, Y, M, N, K);
+        return;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        tbitmap_sgemm_avx2(X, W, B, Y, M, N, K);
+        return;
+    }
+#endif
+    tbitmap_sgemm_basic(X, W, B, Y, M, N, K);
+}
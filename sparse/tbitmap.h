@@ -0,0 +1,56 @@
+#ifndef TBITMAP_H
+#define TBITMAP_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "../dense/dense.h"
+#include "tcsc.h"
+
+// Ternary bitmap: two bitplanes per column, one for the +1 and one for the
+// -1 elements, with 64 rows per word
+typedef struct {
+    int rows, cols;
+    int n_words; // words per column, ceil(rows / 64)
+    int n_elem_pos; // number of matrix elements with value +1
+    int n_elem_neg; // number of matrix elements with value -1
+    // have cols*n_words many elements, column-major: bit r of word
+    // n * n_words + w is row 64 * w + r of column n
+    uint64_t* pos;
+    uint64_t* neg;
+} tbitmap_t;
+
+tbitmap_t *tbitmap_from_dense(dense_t dense, int rows, int cols);
+tbitmap_t *tbitmap_from_tcsc(const tcsc_t *W);
+
+// Scalar kernel, iterates the set bits of each word
+void tbitmap_sgemm_basic(
+    const dense_t X, const tbitmap_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+
+// SIMD kernels on contiguous X: AVX2 turns the masks into blend masks,
+// AVX-512 uses them directly as k-masks of the adds and subtracts
+#ifdef __x86_64__
+void tbitmap_sgemm_avx2(
+    const dense_t X, const tbitmap_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+
+void tbitmap_sgemm_avx512(
+    const dense_t X, const tbitmap_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+#endif
+
+// Runtime dispatch to the widest SIMD kernel, tbitmap_sgemm_basic otherwise
+void tbitmap_sgemm(
+    const dense_t X, const tbitmap_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+
+// Bytes occupied by the two bitplanes
+size_t tbitmap_bytes(const tbitmap_t *W);
+
+void tbitmap_free(tbitmap_t *W);
+
+#endif
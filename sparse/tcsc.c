@@ -1,7 +1,12 @@
 #include "tcsc.h"
+#include "tcsc_fused.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
+#include <string.h>
+#ifdef __APPLE__
+#include <sys/sysctl.h>
+#endif
 
 tcsc_t *tcsc_from_dense(dense_t dense, int rows, int cols) {
     // Initialize counters
@@ -26,6 +31,9 @@ tcsc_t *tcsc_from_dense(dense_t dense, int rows, int cols) {
     sparse->cols = cols;
     sparse->n_elem_pos = n_elem_pos;
     sparse->n_elem_neg = n_elem_neg;
+    sparse->col_scale = NULL;
+    sparse->group_scale = NULL;
+    sparse->group_size = 0;
 
     sparse->col_start_pos = (int*) malloc((cols + 1) * sizeof(int));
     sparse->col_start_neg = (int*) malloc((cols + 1) * sizeof(int));
@@ -139,7 +147,8 @@ void tcsc_sgemm_optimized(
     }
 }
 
-// PReLU version - basic
+// PReLU version - basic, the scalar baseline the optimized PReLU kernels
+// are measured against
 void tcsc_sgemm_prelu_basic(
     const dense_t X, const tcsc_t* W, const dense_t B, float a, dense_t Y,
     int M, int N, int K
@@ -164,112 +173,640 @@ void tcsc_sgemm_prelu_basic(
     }
 }
 
+size_t tcsc_bytes(const tcsc_t *W) {
+    size_t offsets = 2 * ((size_t) W->cols + 1) * sizeof(int);
+    return offsets + ((size_t) W->n_elem_pos + W->n_elem_neg) * sizeof(int);
+}
+
 void tcsc_free(tcsc_t *W) {
     if (W) {
         free(W->col_start_pos);
         free(W->col_start_neg);
         free(W->row_index_pos);
         free(W->row_index_neg);
+        free(W->col_scale);
+        free(W->group_scale);
         free(W);
     }
 }
 
 // PReLU optimized version - separate loop approach
-// First compute matrix multiplication, then apply PReLU in separate pass
+// First compute XW + B through the epilogue, then apply PReLU in a separate
+// pass over Y with the same vector stage
 void tcsc_sgemm_prelu_optimized_separate(
     const dense_t X, const tcsc_t* W, const dense_t B, float a, dense_t Y,
     int M, int N, int K
 ) {
-    // Phase 1: Precompute bias in separate loop to reduce cache conflicts
+    tcsc_sgemm_epilogue(X, W, M, N, K, make_epilogue(ep_store_f32{Y, N}, ep_bias{B}));
+
+    auto prelu = make_epilogue(ep_store_f32{Y, N}, ep_prelu{a});
     for (int m = 0; m < M; ++m) {
-        for (int n = 0; n < N; ++n) {
-            Y[m * N + n] = B[n];
+        int n = 0;
+#ifdef __AVX2__
+        for (; n + 7 < N; n += 8) {
+            prelu(_mm256_loadu_ps(Y + (size_t) m * N + n), m, n);
+        }
+#endif
+        for (; n < N; ++n) {
+            prelu(Y[(size_t) m * N + n], m, n);
         }
     }
-    
-    // Phase 2: Sparse matrix multiplication with optimized loop order
-    for (int n = 0; n < N; ++n) {
-        // Process positive values for this column
-        int pos_start = W->col_start_pos[n];
-        int pos_end = W->col_start_pos[n + 1];
-        
-        for (int m = 0; m < M; ++m) {
-            float acc_pos = 0.0f;
-            // Local accumulation to reduce memory accesses
-            for (int k = pos_start; k < pos_end; ++k) {
-                acc_pos += X[m * K + W->row_index_pos[k]];
-            }
-            Y[m * N + n] += acc_pos;
+}
+
+// PReLU optimized version - compute PReLU on-the-go
+// Bias and PReLU are epilogue stages applied to every finished tile
+void tcsc_sgemm_prelu_optimized_onthego(
+    const dense_t X, const tcsc_t* W, const dense_t B, float a, dense_t Y,
+    int M, int N, int K
+) {
+    tcsc_sgemm_epilogue(X, W, M, N, K, make_epilogue(ep_store_f32{Y, N}, ep_bias{B}, ep_prelu{a}));
+}
+
+// Packs rows [m0, m0 + rows) and columns [k0, k0 + kb) of X into a
+// kb x mb panel, zero padding the lanes past the last row so that the
+// whole panel can be used as vectors
+static void pack_x_panel(const dense_t X, float *panel, int m0, int rows, int mb, int k0, int kb, int K) {
+    for (int k = 0; k < kb; ++k) {
+        for (int r = 0; r < mb; ++r) {
+            panel[(size_t) k * mb + r] = (r < rows) ? X[(size_t) (m0 + r) * K + k0 + k] : 0.0f;
         }
-        
-        // Process negative values for this column
-        int neg_start = W->col_start_neg[n];
-        int neg_end = W->col_start_neg[n + 1];
-        
-        for (int m = 0; m < M; ++m) {
-            float acc_neg = 0.0f;
-            // Local accumulation to reduce memory accesses
-            for (int k = neg_start; k < neg_end; ++k) {
-                acc_neg += X[m * K + W->row_index_neg[k]];
-            }
-            Y[m * N + n] -= acc_neg;
+    }
+}
+
+#ifdef __x86_64__
+#include <immintrin.h>
+
+// Horizontal sum of the 8 lanes of an AVX register
+__attribute__((target("avx2")))
+static inline float hsum_avx2(__m256 v) {
+    __m128 lo = _mm256_castps256_ps128(v);
+    __m128 hi = _mm256_extractf128_ps(v, 1);
+    lo = _mm_add_ps(lo, hi);
+    lo = _mm_add_ps(lo, _mm_movehl_ps(lo, lo));
+    lo = _mm_add_ss(lo, _mm_movehdup_ps(lo));
+    return _mm_cvtss_f32(lo);
+}
+
+// Gathers x[idx[0..len)] and adds (or, if negate, subtracts) them into four
+// independent accumulators. The tail is handled with a masked gather.
+__attribute__((target("avx2")))
+static inline void gather_accumulate_avx2(
+    const float *x, const int *idx, int len, bool negate,
+    __m256 *acc0, __m256 *acc1, __m256 *acc2, __m256 *acc3
+) {
+    __m256 a0 = *acc0, a1 = *acc1, a2 = *acc2, a3 = *acc3;
+    int k = 0;
+    if (!negate) {
+        for (; k + 32 <= len; k += 32) {
+            a0 = _mm256_add_ps(a0, _mm256_i32gather_ps(x, _mm256_loadu_si256((const __m256i*) &idx[k]), 4));
+            a1 = _mm256_add_ps(a1, _mm256_i32gather_ps(x, _mm256_loadu_si256((const __m256i*) &idx[k + 8]), 4));
+            a2 = _mm256_add_ps(a2, _mm256_i32gather_ps(x, _mm256_loadu_si256((const __m256i*) &idx[k + 16]), 4));
+            a3 = _mm256_add_ps(a3, _mm256_i32gather_ps(x, _mm256_loadu_si256((const __m256i*) &idx[k + 24]), 4));
+        }
+        for (; k + 8 <= len; k += 8) {
+            a0 = _mm256_add_ps(a0, _mm256_i32gather_ps(x, _mm256_loadu_si256((const __m256i*) &idx[k]), 4));
+        }
+    } else {
+        for (; k + 32 <= len; k += 32) {
+            a0 = _mm256_sub_ps(a0, _mm256_i32gather_ps(x, _mm256_loadu_si256((const __m256i*) &idx[k]), 4));
+            a1 = _mm256_sub_ps(a1, _mm256_i32gather_ps(x, _mm256_loadu_si256((const __m256i*) &idx[k + 8]), 4));
+            a2 = _mm256_sub_ps(a2, _mm256_i32gather_ps(x, _mm256_loadu_si256((const __m256i*) &idx[k + 16]), 4));
+            a3 = _mm256_sub_ps(a3, _mm256_i32gather_ps(x, _mm256_loadu_si256((const __m256i*) &idx[k + 24]), 4));
+        }
+        for (; k + 8 <= len; k += 8) {
+            a0 = _mm256_sub_ps(a0, _mm256_i32gather_ps(x, _mm256_loadu_si256((const __m256i*) &idx[k]), 4));
         }
     }
-    
-    // Phase 3: Apply PReLU activation in separate optimized loop
-    // This allows for better vectorization and cache usage
+    int rem = len - k;
+    if (rem > 0) {
+        // lanes [0, rem) are active, the others gather nothing and stay 0
+        __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        __m256i mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(rem), lane);
+        __m256i vidx = _mm256_maskload_epi32(&idx[k], mask);
+        __m256 v = _mm256_mask_i32gather_ps(
+            _mm256_setzero_ps(), x, vidx, _mm256_castsi256_ps(mask), 4
+        );
+        a1 = negate ? _mm256_sub_ps(a1, v) : _mm256_add_ps(a1, v);
+    }
+    *acc0 = a0; *acc1 = a1; *acc2 = a2; *acc3 = a3;
+}
+
+// AVX2 gather TCSC SGEMM
+__attribute__((target("avx2")))
+void tcsc_sgemm_gather_avx2(
+    const dense_t X, const tcsc_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+) {
     for (int m = 0; m < M; ++m) {
+        const float *x = X + (size_t) m * K;
         for (int n = 0; n < N; ++n) {
-            float val = Y[m * N + n];
-            Y[m * N + n] = (val < 0.0f) ? a * val : val;
+            __m256 acc0 = _mm256_setzero_ps();
+            __m256 acc1 = _mm256_setzero_ps();
+            __m256 acc2 = _mm256_setzero_ps();
+            __m256 acc3 = _mm256_setzero_ps();
+
+            int pos_start = W->col_start_pos[n];
+            int neg_start = W->col_start_neg[n];
+            gather_accumulate_avx2(
+                x, &W->row_index_pos[pos_start], W->col_start_pos[n + 1] - pos_start,
+                false, &acc0, &acc1, &acc2, &acc3
+            );
+            gather_accumulate_avx2(
+                x, &W->row_index_neg[neg_start], W->col_start_neg[n + 1] - neg_start,
+                true, &acc0, &acc1, &acc2, &acc3
+            );
+
+            acc0 = _mm256_add_ps(_mm256_add_ps(acc0, acc1), _mm256_add_ps(acc2, acc3));
+            Y[m * N + n] = B[n] + hsum_avx2(acc0);
         }
     }
 }
 
-// PReLU optimized version - compute PReLU on-the-go
-// Apply PReLU immediately after computing each element
-void tcsc_sgemm_prelu_optimized_onthego(
-    const dense_t X, const tcsc_t* W, const dense_t B, float a, dense_t Y,
+// Same as gather_accumulate_avx2 with 16 lanes and k-mask tails
+__attribute__((target("avx512f")))
+static inline void gather_accumulate_avx512(
+    const float *x, const int *idx, int len, bool negate,
+    __m512 *acc0, __m512 *acc1, __m512 *acc2, __m512 *acc3
+) {
+    __m512 a0 = *acc0, a1 = *acc1, a2 = *acc2, a3 = *acc3;
+    int k = 0;
+    if (!negate) {
+        for (; k + 64 <= len; k += 64) {
+            a0 = _mm512_add_ps(a0, _mm512_i32gather_ps(_mm512_loadu_si512(&idx[k]), x, 4));
+            a1 = _mm512_add_ps(a1, _mm512_i32gather_ps(_mm512_loadu_si512(&idx[k + 16]), x, 4));
+            a2 = _mm512_add_ps(a2, _mm512_i32gather_ps(_mm512_loadu_si512(&idx[k + 32]), x, 4));
+            a3 = _mm512_add_ps(a3, _mm512_i32gather_ps(_mm512_loadu_si512(&idx[k + 48]), x, 4));
+        }
+        for (; k + 16 <= len; k += 16) {
+            a0 = _mm512_add_ps(a0, _mm512_i32gather_ps(_mm512_loadu_si512(&idx[k]), x, 4));
+        }
+    } else {
+        for (; k + 64 <= len; k += 64) {
+            a0 = _mm512_sub_ps(a0, _mm512_i32gather_ps(_mm512_loadu_si512(&idx[k]), x, 4));
+            a1 = _mm512_sub_ps(a1, _mm512_i32gather_ps(_mm512_loadu_si512(&idx[k + 16]), x, 4));
+            a2 = _mm512_sub_ps(a2, _mm512_i32gather_ps(_mm512_loadu_si512(&idx[k + 32]), x, 4));
+            a3 = _mm512_sub_ps(a3, _mm512_i32gather_ps(_mm512_loadu_si512(&idx[k + 48]), x, 4));
+        }
+        for (; k + 16 <= len; k += 16) {
+            a0 = _mm512_sub_ps(a0, _mm512_i32gather_ps(_mm512_loadu_si512(&idx[k]), x, 4));
+        }
+    }
+    int rem = len - k;
+    if (rem > 0) {
+        __mmask16 mask = (__mmask16) ((1u << rem) - 1);
+        __m512i vidx = _mm512_maskz_loadu_epi32(mask, &idx[k]);
+        __m512 v = _mm512_mask_i32gather_ps(_mm512_setzero_ps(), mask, vidx, x, 4);
+        a1 = negate ? _mm512_sub_ps(a1, v) : _mm512_add_ps(a1, v);
+    }
+    *acc0 = a0; *acc1 = a1; *acc2 = a2; *acc3 = a3;
+}
+
+// AVX-512 gather TCSC SGEMM
+__attribute__((target("avx512f")))
+void tcsc_sgemm_gather_avx512(
+    const dense_t X, const tcsc_t* W, const dense_t B, dense_t Y,
     int M, int N, int K
 ) {
-    // Precompute bias in separate loop to reduce cache conflicts
     for (int m = 0; m < M; ++m) {
+        const float *x = X + (size_t) m * K;
         for (int n = 0; n < N; ++n) {
-            Y[m * N + n] = B[n];
+            __m512 acc0 = _mm512_setzero_ps();
+            __m512 acc1 = _mm512_setzero_ps();
+            __m512 acc2 = _mm512_setzero_ps();
+            __m512 acc3 = _mm512_setzero_ps();
+
+            int pos_start = W->col_start_pos[n];
+            int neg_start = W->col_start_neg[n];
+            gather_accumulate_avx512(
+                x, &W->row_index_pos[pos_start], W->col_start_pos[n + 1] - pos_start,
+                false, &acc0, &acc1, &acc2, &acc3
+            );
+            gather_accumulate_avx512(
+                x, &W->row_index_neg[neg_start], W->col_start_neg[n + 1] - neg_start,
+                true, &acc0, &acc1, &acc2, &acc3
+            );
+
+            acc0 = _mm512_add_ps(_mm512_add_ps(acc0, acc1), _mm512_add_ps(acc2, acc3));
+            Y[m * N + n] = B[n] + _mm512_reduce_add_ps(acc0);
         }
     }
-    
-    // Sparse matrix multiplication with PReLU applied on-the-go
-    // Column-major processing for better cache locality
-    for (int n = 0; n < N; ++n) {
-        // Process positive values for this column
-        int pos_start = W->col_start_pos[n];
-        int pos_end = W->col_start_pos[n + 1];
-        
-        for (int m = 0; m < M; ++m) {
-            float acc_pos = 0.0f;
-            // Local accumulation for positive values
-            for (int k = pos_start; k < pos_end; ++k) {
-                acc_pos += X[m * K + W->row_index_pos[k]];
+}
+
+// Writes a column-major mb x nb tile (tile[j * mb + r]) plus bias into Y
+static void store_y_tile(
+    const float *tile, const dense_t B, dense_t Y,
+    int m0, int rows, int mb, int n0, int cols, int N
+) {
+    for (int r = 0; r < rows; ++r) {
+        for (int j = 0; j < cols; ++j) {
+            Y[(m0 + r) * N + n0 + j] = tile[j * mb + r] + B[n0 + j];
+        }
+    }
+}
+
+// Batched AVX2 TCSC SGEMM (8 rows of X per panel)
+__attribute__((target("avx2")))
+void tcsc_sgemm_batched_avx2(
+    const dense_t X, const tcsc_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+) {
+    const int mb = 8, nb = 8;
+    float *panel;
+    if (posix_memalign((void**) &panel, 64, (size_t) K * mb * sizeof(float)) != 0) {
+        perror("posix_memalign failed @ tcsc_sgemm_batched_avx2()");
+        exit(EXIT_FAILURE);
+    }
+    alignas(32) float tile[8 * 8];
+
+    for (int m0 = 0; m0 < M; m0 += mb) {
+        int rows = (M - m0 < mb) ? M - m0 : mb;
+        pack_x_panel(X, panel, m0, rows, mb, 0, K, K);
+
+        for (int n0 = 0; n0 < N; n0 += nb) {
+            int cols = (N - n0 < nb) ? N - n0 : nb;
+            for (int j = 0; j < cols; ++j) {
+                int n = n0 + j;
+                // two accumulators to break the add dependency chain
+                __m256 acc0 = _mm256_setzero_ps();
+                __m256 acc1 = _mm256_setzero_ps();
+
+                int k = W->col_start_pos[n];
+                int end = W->col_start_pos[n + 1];
+                for (; k + 2 <= end; k += 2) {
+                    acc0 = _mm256_add_ps(acc0, _mm256_load_ps(&panel[W->row_index_pos[k] * mb]));
+                    acc1 = _mm256_add_ps(acc1, _mm256_load_ps(&panel[W->row_index_pos[k + 1] * mb]));
+                }
+                if (k < end)
+                    acc0 = _mm256_add_ps(acc0, _mm256_load_ps(&panel[W->row_index_pos[k] * mb]));
+
+                k = W->col_start_neg[n];
+                end = W->col_start_neg[n + 1];
+                for (; k + 2 <= end; k += 2) {
+                    acc0 = _mm256_sub_ps(acc0, _mm256_load_ps(&panel[W->row_index_neg[k] * mb]));
+                    acc1 = _mm256_sub_ps(acc1, _mm256_load_ps(&panel[W->row_index_neg[k + 1] * mb]));
+                }
+                if (k < end)
+                    acc0 = _mm256_sub_ps(acc0, _mm256_load_ps(&panel[W->row_index_neg[k] * mb]));
+
+                _mm256_store_ps(&tile[j * mb], _mm256_add_ps(acc0, acc1));
             }
-            Y[m * N + n] += acc_pos;
+            store_y_tile(tile, B, Y, m0, rows, mb, n0, cols, N);
         }
-        
-        // Process negative values for this column
-        int neg_start = W->col_start_neg[n];
-        int neg_end = W->col_start_neg[n + 1];
-        
-        for (int m = 0; m < M; ++m) {
-            float acc_neg = 0.0f;
-            // Local accumulation for negative values
-            for (int k = neg_start; k < neg_end; ++k) {
-                acc_neg += X[m * K + W->row_index_neg[k]];
+    }
+    free(panel);
+}
+
+// Batched AVX-512 TCSC SGEMM (16 rows of X per panel)
+__attribute__((target("avx512f")))
+void tcsc_sgemm_batched_avx512(
+    const dense_t X, const tcsc_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+) {
+    const int mb = 16, nb = 8;
+    float *panel;
+    if (posix_memalign((void**) &panel, 64, (size_t) K * mb * sizeof(float)) != 0) {
+        perror("posix_memalign failed @ tcsc_sgemm_batched_avx512()");
+        exit(EXIT_FAILURE);
+    }
+    alignas(64) float tile[16 * 8];
+
+    for (int m0 = 0; m0 < M; m0 += mb) {
+        int rows = (M - m0 < mb) ? M - m0 : mb;
+        pack_x_panel(X, panel, m0, rows, mb, 0, K, K);
+
+        for (int n0 = 0; n0 < N; n0 += nb) {
+            int cols = (N - n0 < nb) ? N - n0 : nb;
+            for (int j = 0; j < cols; ++j) {
+                int n = n0 + j;
+                __m512 acc0 = _mm512_setzero_ps();
+                __m512 acc1 = _mm512_setzero_ps();
+
+                int k = W->col_start_pos[n];
+                int end = W->col_start_pos[n + 1];
+                for (; k + 2 <= end; k += 2) {
+                    acc0 = _mm512_add_ps(acc0, _mm512_load_ps(&panel[W->row_index_pos[k] * mb]));
+                    acc1 = _mm512_add_ps(acc1, _mm512_load_ps(&panel[W->row_index_pos[k + 1] * mb]));
+                }
+                if (k < end)
+                    acc0 = _mm512_add_ps(acc0, _mm512_load_ps(&panel[W->row_index_pos[k] * mb]));
+
+                k = W->col_start_neg[n];
+                end = W->col_start_neg[n + 1];
+                for (; k + 2 <= end; k += 2) {
+                    acc0 = _mm512_sub_ps(acc0, _mm512_load_ps(&panel[W->row_index_neg[k] * mb]));
+                    acc1 = _mm512_sub_ps(acc1, _mm512_load_ps(&panel[W->row_index_neg[k + 1] * mb]));
+                }
+                if (k < end)
+                    acc0 = _mm512_sub_ps(acc0, _mm512_load_ps(&panel[W->row_index_neg[k] * mb]));
+
+                _mm512_store_ps(&tile[j * mb], _mm512_add_ps(acc0, acc1));
             }
-            Y[m * N + n] -= acc_neg;
-            
-            // Apply PReLU immediately after computing final value
-            float val = Y[m * N + n];
-            Y[m * N + n] = (val < 0.0f) ? a * val : val;
+            store_y_tile(tile, B, Y, m0, rows, mb, n0, cols, N);
+        }
+    }
+    free(panel);
+}
+#endif
+
+// Runtime dispatch on CPUID for the gather kernels
+void tcsc_sgemm_gather(
+    const dense_t X, const tcsc_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+) {
+#ifdef __x86_64__
+    if (__builtin_cpu_supports("avx512f")) {
+        tcsc_sgemm_gather_avx512(X, W, B, Y, M, N, K);
+        return;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        tcsc_sgemm_gather_avx2(X, W, B, Y, M, N, K);
+        return;
+    }
+#endif
+    tcsc_sgemm_optimized(X, W, B, Y, M, N, K);
+}
+
+const char *tcsc_gather_isa(void) {
+#ifdef __x86_64__
+    if (__builtin_cpu_supports("avx512f"))
+        return "avx512";
+    if (__builtin_cpu_supports("avx2"))
+        return "avx2";
+#endif
+    return "scalar";
+}
+
+// Runtime dispatch on CPUID for the batched kernels
+void tcsc_sgemm_batched(
+    const dense_t X, const tcsc_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+) {
+#ifdef __x86_64__
+    if (M >= 16 && __builtin_cpu_supports("avx512f")) {
+        tcsc_sgemm_batched_avx512(X, W, B, Y, M, N, K);
+        return;
+    }
+    if (M >= 8 && __builtin_cpu_supports("avx2")) {
+        tcsc_sgemm_batched_avx2(X, W, B, Y, M, N, K);
+        return;
+    }
+#endif
+    tcsc_sgemm_gather(X, W, B, Y, M, N, K);
+}
+
+// Cache sizes in bytes, detected once from sysfs (or sysctl on macOS)
+static size_t cache_l1d = 0, cache_l2 = 0;
+
+// Parses sizes like "48K" or "2048K" or "32M" as found in sysfs
+static size_t parse_cache_size(const char *str) {
+    char *end;
+    size_t size = strtoul(str, &end, 10);
+    if (*end == 'K') size *= 1024;
+    else if (*end == 'M') size *= 1024 * 1024;
+    return size;
+}
+
+static void detect_cache_sizes(void) {
+    if (cache_l1d) return;
+#ifdef __APPLE__
+    size_t value, len = sizeof(value);
+    if (sysctlbyname("hw.l1dcachesize", &value, &len, NULL, 0) == 0) cache_l1d = value;
+    len = sizeof(value);
+    if (sysctlbyname("hw.l2cachesize", &value, &len, NULL, 0) == 0) cache_l2 = value;
+#else
+    for (int index = 0; index < 8; ++index) {
+        char path[96], level[16] = "", type[32] = "", size[32] = "";
+        const char *fields[] = {"level", "type", "size"};
+        char *values[] = {level, type, size};
+        int sizes[] = {sizeof(level), sizeof(type), sizeof(size)};
+        bool ok = true;
+        for (int f = 0; f < 3 && ok; ++f) {
+            snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%d/%s", index, fields[f]);
+            FILE *file = fopen(path, "r");
+            ok = file && fgets(values[f], sizes[f], file);
+            if (file) fclose(file);
         }
+        if (!ok) break;
+        if (atoi(level) == 1 && strncmp(type, "Instruction", 11) != 0) cache_l1d = parse_cache_size(size);
+        if (atoi(level) == 2) cache_l2 = parse_cache_size(size);
+    }
+#endif
+    // conservative defaults if nothing could be read
+    if (!cache_l1d) cache_l1d = 32 * 1024;
+    if (!cache_l2) cache_l2 = 1024 * 1024;
+}
+
+tcsc_tiles_t tcsc_choose_tiles(int M, int N, int K) {
+    detect_cache_sizes();
+    tcsc_tiles_t tiles;
+
+    tiles.mb = (M < 32) ? M : 32;
+    // half of L1 for the Y tile, rounded to whole cache lines of Y
+    tiles.nb = (int) (cache_l1d / 2 / (sizeof(float) * tiles.mb)) / 16 * 16;
+    // half of L2 for the X panel, the rest is left for W and Y
+    tiles.kb = (int) (cache_l2 / 2 / (sizeof(float) * tiles.mb)) / 64 * 64;
+
+    if (tiles.nb < 16) tiles.nb = 16;
+    if (tiles.kb < 64) tiles.kb = 64;
+    if (tiles.nb > N) tiles.nb = N;
+    if (tiles.kb > K) tiles.kb = K;
+    return tiles;
+}
+
+// Advances cursor ends past all row indices below k_end
+static inline int panel_end(const int *row_index, int begin, int col_end, int k_end) {
+    int e = begin;
+    while (e < col_end && row_index[e] < k_end) ++e;
+    return e;
+}
+
+// Adds the panel rows of one column's indices to its mb partial sums in
+// acc, mb a multiple of 8. Every decoded index updates all mb rows.
+#ifdef __AVX2__
+template <int V>
+static inline void panel_column_avx2(
+    const float *panel, const int *pos, int n_pos, const int *neg, int n_neg, int k0, float *acc
+) {
+    const int mb = 8 * V;
+    __m256 sum[V];
+    for (int v = 0; v < V; ++v) sum[v] = _mm256_load_ps(acc + 8 * v);
+    for (int i = 0; i < n_pos; ++i) {
+        const float *x = panel + (size_t) (pos[i] - k0) * mb;
+        for (int v = 0; v < V; ++v) sum[v] = _mm256_add_ps(sum[v], _mm256_load_ps(x + 8 * v));
+    }
+    for (int i = 0; i < n_neg; ++i) {
+        const float *x = panel + (size_t) (neg[i] - k0) * mb;
+        for (int v = 0; v < V; ++v) sum[v] = _mm256_sub_ps(sum[v], _mm256_load_ps(x + 8 * v));
     }
+    for (int v = 0; v < V; ++v) _mm256_store_ps(acc + 8 * v, sum[v]);
+}
+#endif
+
+static inline void panel_column(
+    const float *panel, int mb, const int *pos, int n_pos, const int *neg, int n_neg, int k0, float *acc
+) {
+#ifdef __AVX2__
+    switch (mb) {
+    case 8: panel_column_avx2<1>(panel, pos, n_pos, neg, n_neg, k0, acc); return;
+    case 16: panel_column_avx2<2>(panel, pos, n_pos, neg, n_neg, k0, acc); return;
+    case 24: panel_column_avx2<3>(panel, pos, n_pos, neg, n_neg, k0, acc); return;
+    case 32: panel_column_avx2<4>(panel, pos, n_pos, neg, n_neg, k0, acc); return;
+    }
+#endif
+    for (int i = 0; i < n_pos; ++i) {
+        const float *x = panel + (size_t) (pos[i] - k0) * mb;
+        for (int r = 0; r < mb; ++r) acc[r] += x[r];
+    }
+    for (int i = 0; i < n_neg; ++i) {
+        const float *x = panel + (size_t) (neg[i] - k0) * mb;
+        for (int r = 0; r < mb; ++r) acc[r] -= x[r];
+    }
+}
+
+// Tiled driver: loops M tiles, then K panels, then N tiles. Each K panel
+// of the M tile is packed K-major as in tcsc_sgemm_batched, so it is reused
+// from L2 by all N tiles, while the column-major partial sums of an N tile
+// stay in L1 across the panels.
+static void sgemm_tiled(
+    const dense_t X, const tcsc_t* W, const dense_t B, bool prelu, float a, dense_t Y,
+    int M, int N, int K
+) {
+    tcsc_tiles_t tiles = tcsc_choose_tiles(M, N, K);
+    // panel rows padded to whole vectors
+    const int mb = (tiles.mb + 7) / 8 * 8;
+
+    float *panel, *acc;
+    if (posix_memalign((void**) &panel, 64, (size_t) tiles.kb * mb * sizeof(float)) != 0 ||
+        posix_memalign((void**) &acc, 64, (size_t) N * mb * sizeof(float)) != 0) {
+        perror("posix_memalign failed @ sgemm_tiled()");
+        exit(EXIT_FAILURE);
+    }
+
+    // per column cursors into the index arrays, advanced panel by panel
+    int *cur_pos = (int*) malloc(N * sizeof(int));
+    int *cur_neg = (int*) malloc(N * sizeof(int));
+    if (!cur_pos || !cur_neg) {
+        perror("malloc failed @ sgemm_tiled()");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int m0 = 0; m0 < M; m0 += tiles.mb) {
+        int rows = (M - m0 < tiles.mb) ? M - m0 : tiles.mb;
+        memcpy(cur_pos, W->col_start_pos, N * sizeof(int));
+        memcpy(cur_neg, W->col_start_neg, N * sizeof(int));
+
+        for (int k0 = 0; k0 < K; k0 += tiles.kb) {
+            int k1 = (k0 + tiles.kb < K) ? k0 + tiles.kb : K;
+            bool first = (k0 == 0);
+            bool last = (k1 == K);
+            pack_x_panel(X, panel, m0, rows, mb, k0, k1 - k0, K);
+
+            for (int n0 = 0; n0 < N; n0 += tiles.nb) {
+                int n1 = (n0 + tiles.nb < N) ? n0 + tiles.nb : N;
+
+                for (int n = n0; n < n1; ++n) {
+                    int pos_start = cur_pos[n];
+                    int pos_end = panel_end(W->row_index_pos, pos_start, W->col_start_pos[n + 1], k1);
+                    int neg_start = cur_neg[n];
+                    int neg_end = panel_end(W->row_index_neg, neg_start, W->col_start_neg[n + 1], k1);
+                    cur_pos[n] = pos_end;
+                    cur_neg[n] = neg_end;
+
+                    float *col = acc + (size_t) n * mb;
+                    if (first) {
+                        memset(col, 0, mb * sizeof(float));
+                    }
+                    panel_column(panel, mb, W->row_index_pos + pos_start, pos_end - pos_start,
+                                 W->row_index_neg + neg_start, neg_end - neg_start, k0, col);
+
+                    if (last) {
+                        for (int r = 0; r < rows; ++r) {
+                            float y = col[r] + B[n];
+                            if (prelu) {
+                                y = (y < 0.0f) ? a * y : y;
+                            }
+                            Y[(size_t) (m0 + r) * N + n] = y;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    free(panel);
+    free(acc);
+    free(cur_pos);
+    free(cur_neg);
+}
+
+void tcsc_sgemm_tiled(
+    const dense_t X, const tcsc_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+) {
+    sgemm_tiled(X, W, B, false, 0.0f, Y, M, N, K);
+}
+
+void tcsc_sgemm_prelu_tiled(
+    const dense_t X, const tcsc_t* W, const dense_t B, float a, dense_t Y,
+    int M, int N, int K
+) {
+    sgemm_tiled(X, W, B, true, a, Y, M, N, K);
+}
+
+int tcsc_set_col_scale(tcsc_t *W, const float *scale) {
+    float *copy = (float*) malloc(W->cols * sizeof(float));
+    if (!copy) return -1;
+    memcpy(copy, scale, W->cols * sizeof(float));
+
+    free(W->col_scale);
+    free(W->group_scale);
+    W->col_scale = copy;
+    W->group_scale = NULL;
+    W->group_size = 0;
+    return 0;
+}
+
+int tcsc_set_group_scale(tcsc_t *W, int group_size, const float *scale) {
+    if (group_size <= 0) return -1;
+    size_t n = (size_t) W->cols * ((W->rows + group_size - 1) / group_size);
+    float *copy = (float*) malloc(n * sizeof(float));
+    if (!copy) return -1;
+    memcpy(copy, scale, n * sizeof(float));
+
+    free(W->col_scale);
+    free(W->group_scale);
+    W->col_scale = NULL;
+    W->group_scale = copy;
+    W->group_size = group_size;
+    return 0;
+}
+
+// Shared driver of the scaled kernels: the scales of W select the
+// epilogue kernel, the remaining stages follow the scale in every case
+template <class... Stages>
+static void sgemm_scaled(
+    const dense_t X, const tcsc_t* W, dense_t Y, int M, int N, int K, Stages... stages
+) {
+    if (W->group_scale) {
+        ep_group_scale group{W->group_scale, W->group_size, (W->rows + W->group_size - 1) / W->group_size};
+        tcsc_sgemm_epilogue(X, W, M, N, K, group, make_epilogue(ep_store_f32{Y, N}, stages...));
+    } else if (W->col_scale) {
+        tcsc_sgemm_epilogue(X, W, M, N, K, make_epilogue(ep_store_f32{Y, N}, ep_col_scale{W->col_scale}, stages...));
+    } else {
+        tcsc_sgemm_epilogue(X, W, M, N, K, make_epilogue(ep_store_f32{Y, N}, stages...));
+    }
+}
+
+void tcsc_sgemm_scaled(
+    const dense_t X, const tcsc_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+) {
+    sgemm_scaled(X, W, Y, M, N, K, ep_bias{B});
+}
+
+void tcsc_sgemm_prelu_channel(
+    const dense_t X, const tcsc_t* W, const dense_t B, const float *alpha, dense_t Y,
+    int M, int N, int K
+) {
+    sgemm_scaled(X, W, Y, M, N, K, ep_bias{B}, ep_prelu_channel{alpha});
 }
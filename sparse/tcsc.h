@@ -1,6 +1,7 @@
 #ifndef TCSC_H
 #define TCSC_H
 
+#include <stddef.h>
 #include "../dense/dense.h"
 
 typedef struct {
@@ -14,6 +15,15 @@ typedef struct {
     int* row_index_pos;
     // has n_elem_neg many elements
     int* row_index_neg;
+    // Optional weight scales, W = scale * {-1, 0, +1}. NULL means 1. Only
+    // tcsc_sgemm_scaled and tcsc_sgemm_prelu_channel honour them.
+    // col_scale has cols elements
+    float* col_scale;
+    // one scale per group of group_size consecutive rows of a column,
+    // column-major: group g of column n is group_scale[n * n_groups + g]
+    // with n_groups = ceil(rows / group_size)
+    float* group_scale;
+    int group_size;
 } tcsc_t;
 
 tcsc_t *tcsc_from_dense(dense_t dense, int rows, int cols);
@@ -45,6 +55,103 @@ void tcsc_sgemm_prelu_optimized_onthego(
     int M, int N, int K
 );
 
+// Gather-based SIMD kernels for the GEMV (M=1) case; correct for any M.
+// Each column loads 8/16 row indices at once and gathers the matching X
+// values into several independent accumulators.
+#ifdef __x86_64__
+void tcsc_sgemm_gather_avx2(
+    const dense_t X, const tcsc_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+
+void tcsc_sgemm_gather_avx512(
+    const dense_t X, const tcsc_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+#endif
+
+// Picks the widest gather kernel supported by the CPU at runtime and falls
+// back to tcsc_sgemm_optimized when no gather instructions are available
+void tcsc_sgemm_gather(
+    const dense_t X, const tcsc_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+
+// Name of the instruction set tcsc_sgemm_gather dispatches to
+const char *tcsc_gather_isa(void);
+
+// Batched kernels for M >= 8. Blocks of 8 (AVX2) or 16 (AVX-512) rows of X
+// are packed into a K x mb panel so that every row index loads one
+// contiguous vector of X values that is added into a register-resident Y
+// tile.
+#ifdef __x86_64__
+void tcsc_sgemm_batched_avx2(
+    const dense_t X, const tcsc_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+
+void tcsc_sgemm_batched_avx512(
+    const dense_t X, const tcsc_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+#endif
+
+// Runtime dispatch for the batched kernels, small M goes to tcsc_sgemm_gather
+void tcsc_sgemm_batched(
+    const dense_t X, const tcsc_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+
+// Tile sizes of the cache-blocked driver: mb rows of X/Y, nb columns of
+// W/Y and kb rows of W per K panel
+typedef struct {
+    int mb, nb, kb;
+} tcsc_tiles_t;
+
+// Derives tile sizes from the detected L1d/L2 sizes so that an mb x kb
+// panel of X stays in L2 and an mb x nb tile of Y stays in L1
+tcsc_tiles_t tcsc_choose_tiles(int M, int N, int K);
+
+// Three-level M/N/K cache-blocked drivers for large shapes. Partial Y
+// tiles are accumulated across K panels, bias and PReLU are applied on the
+// last panel only.
+void tcsc_sgemm_tiled(
+    const dense_t X, const tcsc_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+
+void tcsc_sgemm_prelu_tiled(
+    const dense_t X, const tcsc_t* W, const dense_t B, float a, dense_t Y,
+    int M, int N, int K
+);
+
+// Copy a scale per column (cols elements) into W, replacing any group
+// scales. Returns 0, or -1 if the allocation fails.
+int tcsc_set_col_scale(tcsc_t *W, const float *scale);
+
+// Copy a scale per group of group_size rows of every column into W, laid
+// out as described at tcsc_t::group_scale, replacing any column scales.
+// Returns 0, or -1 on a bad group size or failed allocation.
+int tcsc_set_group_scale(tcsc_t *W, int group_size, const float *scale);
+
+// Y = (XW) * scale + B with the scales of W. Column scales are applied
+// once per finished output, group scales once per group partial sum.
+void tcsc_sgemm_scaled(
+    const dense_t X, const tcsc_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+
+// As tcsc_sgemm_scaled followed by PReLU with one slope alpha[n] per
+// output channel, all in the same pass over Y. Without scales this is
+// tcsc_sgemm_fused_bias_prelu_channel.
+void tcsc_sgemm_prelu_channel(
+    const dense_t X, const tcsc_t* W, const dense_t B, const float *alpha, dense_t Y,
+    int M, int N, int K
+);
+
+// Bytes occupied by the offsets and indices of the format
+size_t tcsc_bytes(const tcsc_t *W);
+
 void tcsc_free(tcsc_t *W);
 
 #endif
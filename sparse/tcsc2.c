@@ -0,0 +1,201 @@
+#include "tcsc2.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+tcsc2_t *tcsc2_from_tcsc(const tcsc_t *W) {
+    tcsc2_t* sparse = (tcsc2_t*) malloc(sizeof(tcsc2_t));
+    if (!sparse) return NULL;
+
+    int n_elem = W->n_elem_pos + W->n_elem_neg;
+    sparse->rows = W->rows;
+    sparse->cols = W->cols;
+    sparse->n_elem = n_elem;
+    sparse->col_ptr = (int*) malloc((2 * W->cols + 1) * sizeof(int));
+    // at least one element so that an all-zero matrix is not a failed malloc
+    sparse->row_index = (uint32_t*) malloc((n_elem > 0 ? n_elem : 1) * sizeof(uint32_t));
+
+    if (!sparse->col_ptr || !sparse->row_index) {
+        free(sparse->col_ptr);
+        free(sparse->row_index);
+        free(sparse);
+        return NULL;
+    }
+
+    int counter = 0;
+    for (int j = 0; j < W->cols; ++j) {
+        sparse->col_ptr[2 * j] = counter;
+        for (int k = W->col_start_pos[j]; k < W->col_start_pos[j + 1]; ++k) {
+            sparse->row_index[counter++] = (uint32_t) W->row_index_pos[k];
+        }
+        sparse->col_ptr[2 * j + 1] = counter;
+        for (int k = W->col_start_neg[j]; k < W->col_start_neg[j + 1]; ++k) {
+            sparse->row_index[counter++] = (uint32_t) W->row_index_neg[k] | TCSC2_SIGN_BIT;
+        }
+    }
+    sparse->col_ptr[2 * W->cols] = counter;
+
+    return sparse;
+}
+
+tcsc2_t *tcsc2_from_dense(dense_t dense, int rows, int cols) {
+    tcsc_t *W = tcsc_from_dense(dense, rows, cols);
+    if (!W) return NULL;
+    tcsc2_t *sparse = tcsc2_from_tcsc(W);
+    tcsc_free(W);
+    return sparse;
+}
+
+// Flips the sign of x if the entry carries TCSC2_SIGN_BIT
+static inline float apply_sign(float x, uint32_t entry) {
+    uint32_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    bits ^= entry & TCSC2_SIGN_BIT;
+    memcpy(&x, &bits, sizeof(bits));
+    return x;
+}
+
+// Basic single-stream TCSC SGEMM
+void tcsc2_sgemm_basic(
+    const dense_t X, const tcsc2_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+) {
+    for (int m = 0; m < M; ++m) {
+        const float *x = X + (size_t) m * K;
+        for (int n = 0; n < N; ++n) {
+            float y = 0.0f;
+            for (int k = W->col_ptr[2 * n]; k < W->col_ptr[2 * n + 2]; ++k) {
+                uint32_t entry = W->row_index[k];
+                y += apply_sign(x[entry & TCSC2_ROW_MASK], entry);
+            }
+            Y[m * N + n] = y + B[n];
+        }
+    }
+}
+
+void tcsc2_free(tcsc2_t *W) {
+    if (W) {
+        free(W->col_ptr);
+        free(W->row_index);
+        free(W);
+    }
+}
+
+#ifdef __x86_64__
+#include <immintrin.h>
+
+// Gathers x at the row of each entry in idx and flips the sign of -1 entries
+__attribute__((target("avx2")))
+static inline __m256 signed_gather_avx2(const float *x, __m256i idx) {
+    const __m256i sign = _mm256_set1_epi32((int) TCSC2_SIGN_BIT);
+    __m256 v = _mm256_i32gather_ps(x, _mm256_andnot_si256(sign, idx), 4);
+    return _mm256_xor_ps(v, _mm256_castsi256_ps(_mm256_and_si256(idx, sign)));
+}
+
+__attribute__((target("avx2")))
+static inline float hsum8(__m256 v) {
+    __m128 lo = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    lo = _mm_add_ps(lo, _mm_movehl_ps(lo, lo));
+    lo = _mm_add_ss(lo, _mm_movehdup_ps(lo));
+    return _mm_cvtss_f32(lo);
+}
+
+// AVX2 single-stream TCSC SGEMM
+__attribute__((target("avx2")))
+void tcsc2_sgemm_avx2(
+    const dense_t X, const tcsc2_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+) {
+    const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    for (int m = 0; m < M; ++m) {
+        const float *x = X + (size_t) m * K;
+        for (int n = 0; n < N; ++n) {
+            const uint32_t *idx = W->row_index;
+            int k = W->col_ptr[2 * n];
+            int end = W->col_ptr[2 * n + 2];
+
+            __m256 acc0 = _mm256_setzero_ps();
+            __m256 acc1 = _mm256_setzero_ps();
+            for (; k + 16 <= end; k += 16) {
+                acc0 = _mm256_add_ps(acc0, signed_gather_avx2(x, _mm256_loadu_si256((const __m256i*) &idx[k])));
+                acc1 = _mm256_add_ps(acc1, signed_gather_avx2(x, _mm256_loadu_si256((const __m256i*) &idx[k + 8])));
+            }
+            for (; k + 8 <= end; k += 8) {
+                acc0 = _mm256_add_ps(acc0, signed_gather_avx2(x, _mm256_loadu_si256((const __m256i*) &idx[k])));
+            }
+            int rem = end - k;
+            if (rem > 0) {
+                __m256i mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(rem), lane);
+                __m256i entry = _mm256_maskload_epi32((const int*) &idx[k], mask);
+                const __m256i sign = _mm256_set1_epi32((int) TCSC2_SIGN_BIT);
+                __m256 v = _mm256_mask_i32gather_ps(
+                    _mm256_setzero_ps(), x, _mm256_andnot_si256(sign, entry),
+                    _mm256_castsi256_ps(mask), 4
+                );
+                v = _mm256_xor_ps(v, _mm256_castsi256_ps(_mm256_and_si256(entry, sign)));
+                acc1 = _mm256_add_ps(acc1, v);
+            }
+            Y[m * N + n] = B[n] + hsum8(_mm256_add_ps(acc0, acc1));
+        }
+    }
+}
+
+__attribute__((target("avx512f")))
+static inline __m512 signed_gather_avx512(const float *x, __m512i idx, __mmask16 mask) {
+    const __m512i sign = _mm512_set1_epi32((int) TCSC2_SIGN_BIT);
+    __m512 v = _mm512_mask_i32gather_ps(
+        _mm512_setzero_ps(), mask, _mm512_andnot_si512(sign, idx), x, 4
+    );
+    return _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(v), _mm512_and_si512(idx, sign)));
+}
+
+// AVX-512 single-stream TCSC SGEMM
+__attribute__((target("avx512f")))
+void tcsc2_sgemm_avx512(
+    const dense_t X, const tcsc2_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+) {
+    for (int m = 0; m < M; ++m) {
+        const float *x = X + (size_t) m * K;
+        for (int n = 0; n < N; ++n) {
+            const uint32_t *idx = W->row_index;
+            int k = W->col_ptr[2 * n];
+            int end = W->col_ptr[2 * n + 2];
+
+            __m512 acc0 = _mm512_setzero_ps();
+            __m512 acc1 = _mm512_setzero_ps();
+            for (; k + 32 <= end; k += 32) {
+                acc0 = _mm512_add_ps(acc0, signed_gather_avx512(x, _mm512_loadu_si512(&idx[k]), 0xffff));
+                acc1 = _mm512_add_ps(acc1, signed_gather_avx512(x, _mm512_loadu_si512(&idx[k + 16]), 0xffff));
+            }
+            for (; k + 16 <= end; k += 16) {
+                acc0 = _mm512_add_ps(acc0, signed_gather_avx512(x, _mm512_loadu_si512(&idx[k]), 0xffff));
+            }
+            int rem = end - k;
+            if (rem > 0) {
+                __mmask16 mask = (__mmask16) ((1u << rem) - 1);
+                __m512i entry = _mm512_maskz_loadu_epi32(mask, &idx[k]);
+                acc1 = _mm512_add_ps(acc1, signed_gather_avx512(x, entry, mask));
+            }
+            Y[m * N + n] = B[n] + _mm512_reduce_add_ps(_mm512_add_ps(acc0, acc1));
+        }
+    }
+}
+#endif
+
+void tcsc2_sgemm(
+    const dense_t X, const tcsc2_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+) {
+#ifdef __x86_64__
+    if (__builtin_cpu_supports("avx512f")) {
+        tcsc2_sgemm_avx512(X, W, B, Y, M, N, K);
+        return;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        tcsc2_sgemm_avx2(X, W, B, Y, M, N, K);
+        return;
+    }
+#endif
+    tcsc2_sgemm_basic(X, W, B, Y, M, N, K);
+}
@@ -0,0 +1,55 @@
+#ifndef TCSC2_H
+#define TCSC2_H
+
+#include <stdint.h>
+#include "../dense/dense.h"
+#include "tcsc.h"
+
+// set in an entry of row_index if the matrix element has value -1
+#define TCSC2_SIGN_BIT 0x80000000u
+#define TCSC2_ROW_MASK 0x7fffffffu
+
+// Single-stream TCSC: both signs of a column live in one index stream
+typedef struct {
+    int rows, cols;
+    int n_elem; // number of matrix elements with value +1 or -1
+    // has 2*cols+1 many elements, interleaved per column:
+    //  col_ptr[2n]   first entry of column n
+    //  col_ptr[2n+1] first -1 entry of column n (split offset)
+    //  col_ptr[2n+2] end of column n
+    int* col_ptr;
+    // has n_elem many elements, per column first the +1 rows then the -1
+    // rows, the latter tagged with TCSC2_SIGN_BIT
+    uint32_t* row_index;
+} tcsc2_t;
+
+tcsc2_t *tcsc2_from_tcsc(const tcsc_t *W);
+tcsc2_t *tcsc2_from_dense(dense_t dense, int rows, int cols);
+
+// Scalar kernel, both signs in one branch-free loop (sign applied by xor)
+void tcsc2_sgemm_basic(
+    const dense_t X, const tcsc2_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+
+#ifdef __x86_64__
+void tcsc2_sgemm_avx2(
+    const dense_t X, const tcsc2_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+
+void tcsc2_sgemm_avx512(
+    const dense_t X, const tcsc2_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+#endif
+
+// Runtime dispatch to the widest SIMD kernel, tcsc2_sgemm_basic otherwise
+void tcsc2_sgemm(
+    const dense_t X, const tcsc2_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+
+void tcsc2_free(tcsc2_t *W);
+
+#endif
@@ -0,0 +1,59 @@
+#include "tcsc_fused.h"
+
+void tcsc_sgemm_fused_bias(
+    const dense_t X, const tcsc_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+) {
+    tcsc_sgemm_epilogue(X, W, M, N, K, make_epilogue(ep_store_f32{Y, N}, ep_bias{B}));
+}
+
+void tcsc_sgemm_fused_bias_relu(
+    const dense_t X, const tcsc_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+) {
+    tcsc_sgemm_epilogue(X, W, M, N, K, make_epilogue(ep_store_f32{Y, N}, ep_bias{B}, ep_relu{}));
+}
+
+void tcsc_sgemm_fused_bias_prelu(
+    const dense_t X, const tcsc_t* W, const dense_t B, float a, dense_t Y,
+    int M, int N, int K
+) {
+    tcsc_sgemm_epilogue(X, W, M, N, K, make_epilogue(ep_store_f32{Y, N}, ep_bias{B}, ep_prelu{a}));
+}
+
+void tcsc_sgemm_fused_bias_prelu_channel(
+    const dense_t X, const tcsc_t* W, const dense_t B, const float *alpha, dense_t Y,
+    int M, int N, int K
+) {
+    tcsc_sgemm_epilogue(X, W, M, N, K, make_epilogue(ep_store_f32{Y, N}, ep_bias{B}, ep_prelu_channel{alpha}));
+}
+
+void tcsc_sgemm_fused_bias_clamp(
+    const dense_t X, const tcsc_t* W, const dense_t B, float lo, float hi, dense_t Y,
+    int M, int N, int K
+) {
+    tcsc_sgemm_epilogue(X, W, M, N, K, make_epilogue(ep_store_f32{Y, N}, ep_bias{B}, ep_clamp{lo, hi}));
+}
+
+void tcsc_sgemm_fused_bias_residual(
+    const dense_t X, const tcsc_t* W, const dense_t B, const dense_t R, dense_t Y,
+    int M, int N, int K
+) {
+    tcsc_sgemm_epilogue(X, W, M, N, K, make_epilogue(ep_store_f32{Y, N}, ep_bias{B}, ep_residual{R, N}));
+}
+
+void tcsc_sgemm_fused_scale_bias(
+    const dense_t X, const tcsc_t* W, float s, const dense_t B, dense_t Y,
+    int M, int N, int K
+) {
+    tcsc_sgemm_epilogue(X, W, M, N, K, make_epilogue(ep_store_f32{Y, N}, ep_scale{s}, ep_bias{B}));
+}
+
+void tcsc_sgemm_fused_bias_prelu_q8(
+    const dense_t X, const tcsc_t* W, const dense_t B, float a,
+    float q_scale, int zero_point, int8_t *Q,
+    int M, int N, int K
+) {
+    tcsc_sgemm_epilogue(X, W, M, N, K,
+        make_epilogue(ep_store_q8{Q, N, 1.0f / q_scale, zero_point}, ep_bias{B}, ep_prelu{a}));
+}
@@ -0,0 +1,204 @@
+#ifndef TCSC_FUSED_H
+#define TCSC_FUSED_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../dense/dense.h"
+#include "tcsc.h"
+#include "epilogue.h"
+
+// Signed sum of x over the entries [pos_start, pos_end) and
+// [neg_start, neg_end) of the index arrays of W
+static inline float tcsc_range_dot(
+    const float *x, const tcsc_t* W, int pos_start, int pos_end, int neg_start, int neg_end
+) {
+    // independent accumulators to hide the add latency
+    float acc0 = 0.0f, acc1 = 0.0f, acc2 = 0.0f, acc3 = 0.0f;
+
+    int k = pos_start;
+    for (; k + 3 < pos_end; k += 4) {
+        acc0 += x[W->row_index_pos[k]];
+        acc1 += x[W->row_index_pos[k + 1]];
+        acc2 += x[W->row_index_pos[k + 2]];
+        acc3 += x[W->row_index_pos[k + 3]];
+    }
+    for (; k < pos_end; ++k) {
+        acc0 += x[W->row_index_pos[k]];
+    }
+
+    k = neg_start;
+    for (; k + 3 < neg_end; k += 4) {
+        acc0 -= x[W->row_index_neg[k]];
+        acc1 -= x[W->row_index_neg[k + 1]];
+        acc2 -= x[W->row_index_neg[k + 2]];
+        acc3 -= x[W->row_index_neg[k + 3]];
+    }
+    for (; k < neg_end; ++k) {
+        acc0 -= x[W->row_index_neg[k]];
+    }
+    return (acc0 + acc1) + (acc2 + acc3);
+}
+
+// Sum of column n of W over one row x of X
+static inline float tcsc_column_dot(const float *x, const tcsc_t* W, int n) {
+    return tcsc_range_dot(x, W, W->col_start_pos[n], W->col_start_pos[n + 1],
+                          W->col_start_neg[n], W->col_start_neg[n + 1]);
+}
+
+// Split the sorted entries [begin, end) of a column at the group
+// boundaries: group g is [bound[g], bound[g + 1])
+static inline void tcsc_group_bounds(
+    const int *row_index, int begin, int end, int size, int n_groups, int *bound
+) {
+    bound[0] = begin;
+    for (int g = 0; g < n_groups; ++g) {
+        int e = bound[g], k_end = (g + 1) * size;
+        while (e < end && row_index[e] < k_end) ++e;
+        bound[g + 1] = e;
+    }
+}
+
+// TCSC kernel with a compile-time epilogue (see epilogue.h). The finished
+// accumulator of every Y[m, n] goes through epi exactly once, nothing is
+// written before that. With AVX2, W is walked in tiles of 8 columns whose
+// indices stay in L1 for all rows of X; the 8 sums of one row are
+// assembled into one __m256 and the vector stages of epi run on it.
+// Columns past the last full tile go through the scalar stages. Any
+// epilogue built with make_epilogue works, the C symbols below are the
+// instantiations used by the benchmarks.
+template <class Epilogue>
+void tcsc_sgemm_epilogue(
+    const dense_t X, const tcsc_t* W, int M, int N, int K, const Epilogue &epi
+) {
+    int n0 = 0;
+#ifdef __AVX2__
+    alignas(32) float tile[8];
+    for (; n0 + 7 < N; n0 += 8) {
+        for (int m = 0; m < M; ++m) {
+            const float *x = X + (size_t) m * K;
+            for (int j = 0; j < 8; ++j) {
+                tile[j] = tcsc_column_dot(x, W, n0 + j);
+            }
+            epi(_mm256_load_ps(tile), m, n0);
+        }
+    }
+#endif
+    for (int n = n0; n < N; ++n) {
+        for (int m = 0; m < M; ++m) {
+            epi(tcsc_column_dot(X + (size_t) m * K, W, n), m, n);
+        }
+    }
+}
+
+// As above with group scales: every column sum is split into group
+// partial sums, each mapped through group, before epi sees the total. The
+// group boundaries of a tile of 8 columns are located once and reused by
+// all rows of X.
+template <class Epilogue>
+void tcsc_sgemm_epilogue(
+    const dense_t X, const tcsc_t* W, int M, int N, int K,
+    const ep_group_scale &group, const Epilogue &epi
+) {
+    int G = group.n_groups;
+    int *bound_pos = (int*) malloc(8 * (G + 1) * sizeof(int));
+    int *bound_neg = (int*) malloc(8 * (G + 1) * sizeof(int));
+    if (!bound_pos || !bound_neg) {
+        perror("malloc failed @ tcsc_sgemm_epilogue()");
+        exit(EXIT_FAILURE);
+    }
+
+    // sum of column n0 + j whose bounds are at slot j
+    auto group_dot = [&](const float *x, int n0, int j) {
+        const int *bp = bound_pos + j * (G + 1), *bn = bound_neg + j * (G + 1);
+        float y = 0.0f;
+        for (int g = 0; g < G; ++g) {
+            y += group(tcsc_range_dot(x, W, bp[g], bp[g + 1], bn[g], bn[g + 1]), g, n0 + j);
+        }
+        return y;
+    };
+    auto locate = [&](int n, int j) {
+        tcsc_group_bounds(W->row_index_pos, W->col_start_pos[n], W->col_start_pos[n + 1],
+                          group.size, G, bound_pos + j * (G + 1));
+        tcsc_group_bounds(W->row_index_neg, W->col_start_neg[n], W->col_start_neg[n + 1],
+                          group.size, G, bound_neg + j * (G + 1));
+    };
+
+    int n0 = 0;
+#ifdef __AVX2__
+    alignas(32) float tile[8];
+    for (; n0 + 7 < N; n0 += 8) {
+        for (int j = 0; j < 8; ++j) {
+            locate(n0 + j, j);
+        }
+        for (int m = 0; m < M; ++m) {
+            const float *x = X + (size_t) m * K;
+            for (int j = 0; j < 8; ++j) {
+                tile[j] = group_dot(x, n0, j);
+            }
+            epi(_mm256_load_ps(tile), m, n0);
+        }
+    }
+#endif
+    for (int n = n0; n < N; ++n) {
+        locate(n, 0);
+        for (int m = 0; m < M; ++m) {
+            epi(group_dot(X + (size_t) m * K, n, 0), m, n);
+        }
+    }
+
+    free(bound_pos);
+    free(bound_neg);
+}
+
+// Y = XW + B
+void tcsc_sgemm_fused_bias(
+    const dense_t X, const tcsc_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+
+// Y = relu(XW + B)
+void tcsc_sgemm_fused_bias_relu(
+    const dense_t X, const tcsc_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+
+// Y = prelu(XW + B, a), same signature as tcsc_sgemm_prelu_basic
+void tcsc_sgemm_fused_bias_prelu(
+    const dense_t X, const tcsc_t* W, const dense_t B, float a, dense_t Y,
+    int M, int N, int K
+);
+
+// Y = prelu(XW + B, alpha[n])
+void tcsc_sgemm_fused_bias_prelu_channel(
+    const dense_t X, const tcsc_t* W, const dense_t B, const float *alpha, dense_t Y,
+    int M, int N, int K
+);
+
+// Y = clamp(XW + B, lo, hi)
+void tcsc_sgemm_fused_bias_clamp(
+    const dense_t X, const tcsc_t* W, const dense_t B, float lo, float hi, dense_t Y,
+    int M, int N, int K
+);
+
+// Y = XW + B + R, R is M x N
+void tcsc_sgemm_fused_bias_residual(
+    const dense_t X, const tcsc_t* W, const dense_t B, const dense_t R, dense_t Y,
+    int M, int N, int K
+);
+
+// Y = s * XW + B, e.g. for a per-tensor weight scale
+void tcsc_sgemm_fused_scale_bias(
+    const dense_t X, const tcsc_t* W, float s, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+
+// Q = quantize(prelu(XW + B, a)) with q = round(y / q_scale) + zero_point
+// saturated to int8
+void tcsc_sgemm_fused_bias_prelu_q8(
+    const dense_t X, const tcsc_t* W, const dense_t B, float a,
+    float q_scale, int zero_point, int8_t *Q,
+    int M, int N, int K
+);
+
+#endif
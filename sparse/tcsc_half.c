@@ -0,0 +1,295 @@
+#include "tcsc_half.h"
+#include "epilogue.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+static inline uint16_t fp32_to_fp16(float f) {
+    uint32_t x;
+    memcpy(&x, &f, sizeof(x));
+    uint32_t sign = (x >> 16) & 0x8000;
+    uint32_t abs = x & 0x7fffffff;
+
+    if (abs >= 0x7f800000) {  // inf and nan
+        return sign | 0x7c00 | ((abs > 0x7f800000) ? 0x200 : 0);
+    }
+    if (abs >= 0x477ff000) {  // 65520 and above round to inf
+        return sign | 0x7c00;
+    }
+    if (abs < 0x38800000) {   // subnormal half
+        if (abs < 0x33000000) return sign;
+        uint32_t e = abs >> 23;
+        uint32_t m = (abs & 0x7fffff) | 0x800000;
+        uint32_t shift = 126 - e;
+        uint32_t q = m >> shift, rem = m & ((1u << shift) - 1), half = 1u << (shift - 1);
+        if (rem > half || (rem == half && (q & 1))) ++q;
+        return sign | q;
+    }
+    // rebias the exponent and round off 13 mantissa bits without a branch
+    // (data dependent, it would mispredict half the time); a carry moves
+    // into the exponent as it should
+    uint32_t v = abs - (112u << 23);
+    return sign | ((v + 0xfff + ((v >> 13) & 1)) >> 13);
+}
+
+static inline float fp16_to_fp32(uint16_t h) {
+    uint32_t sign = (uint32_t) (h & 0x8000) << 16;
+    uint32_t e = (h >> 10) & 0x1f, m = h & 0x3ff;
+    uint32_t x;
+    if (e == 0) {
+        float f = ldexpf((float) m, -24);
+        return sign ? -f : f;
+    }
+    if (e == 31) {
+        x = sign | 0x7f800000 | (m << 13);
+    } else {
+        x = sign | ((e + 112) << 23) | (m << 13);
+    }
+    float f;
+    memcpy(&f, &x, sizeof(f));
+    return f;
+}
+
+static inline uint16_t fp32_to_bf16(float f) {
+    uint32_t x;
+    memcpy(&x, &f, sizeof(x));
+    if ((x & 0x7fffffff) > 0x7f800000) return (uint16_t) ((x >> 16) | 0x40);  // quiet nan
+    x += 0x7fff + ((x >> 16) & 1);
+    return (uint16_t) (x >> 16);
+}
+
+static inline float bf16_to_fp32(uint16_t h) {
+    uint32_t x = (uint32_t) h << 16;
+    float f;
+    memcpy(&f, &x, sizeof(f));
+    return f;
+}
+
+void tcsc_to_half(const float *x, size_t n, tcsc_half_t fmt, uint16_t *h) {
+    for (size_t i = 0; i < n; ++i) {
+        h[i] = (fmt == TCSC_BF16) ? fp32_to_bf16(x[i]) : fp32_to_fp16(x[i]);
+    }
+}
+
+void tcsc_from_half(const uint16_t *h, size_t n, tcsc_half_t fmt, float *x) {
+    for (size_t i = 0; i < n; ++i) {
+        x[i] = (fmt == TCSC_BF16) ? bf16_to_fp32(h[i]) : fp16_to_fp32(h[i]);
+    }
+}
+
+// Half-precision output store for the epilogues
+struct ep_store_half {
+    uint16_t *Y;
+    int ldy;
+    tcsc_half_t fmt;
+    inline void operator()(float y, int m, int n) const {
+        Y[(size_t) m * ldy + n] = (fmt == TCSC_BF16) ? fp32_to_bf16(y) : fp32_to_fp16(y);
+    }
+};
+
+// Scalar kernel: every row of X is converted once into a float row that
+// all N columns gather from
+template <class Epilogue>
+static void gemm_half_scalar(
+    const uint16_t *X, tcsc_half_t fmt, const tcsc_t *W, int M, int N, int K, const Epilogue &epi
+) {
+    float *x = (float*) malloc((size_t) K * sizeof(float));
+    if (!x) {
+        perror("malloc failed @ gemm_half_scalar()");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int m = 0; m < M; ++m) {
+        tcsc_from_half(X + (size_t) m * K, K, fmt, x);
+        for (int n = 0; n < N; ++n) {
+            float acc_pos = 0.0f, acc_neg = 0.0f;
+            for (int k = W->col_start_pos[n]; k < W->col_start_pos[n + 1]; ++k) {
+                acc_pos += x[W->row_index_pos[k]];
+            }
+            for (int k = W->col_start_neg[n]; k < W->col_start_neg[n + 1]; ++k) {
+                acc_neg += x[W->row_index_neg[k]];
+            }
+            epi(acc_pos - acc_neg, m, n);
+        }
+    }
+    free(x);
+}
+
+#ifdef __x86_64__
+#include <immintrin.h>
+
+// Packs rows [m0, m0 + rows) of X into a K x mb panel of 16-bit values,
+// zero padding the lanes past the last row (0 is +0.0 in both formats)
+static void pack_half_panel(const uint16_t *X, uint16_t *panel, int m0, int rows, int mb, int K) {
+    for (int k = 0; k < K; ++k) {
+        for (int r = 0; r < mb; ++r) {
+            panel[k * mb + r] = (r < rows) ? X[(size_t) (m0 + r) * K + k] : 0;
+        }
+    }
+}
+
+// Applies the epilogue to a column-major mb x nb tile (tile[j * mb + r])
+template <class Epilogue>
+static inline void store_half_tile(
+    const float *tile, int m0, int rows, int mb, int n0, int cols, const Epilogue &epi
+) {
+    for (int r = 0; r < rows; ++r) {
+        for (int j = 0; j < cols; ++j) {
+            epi(tile[j * mb + r], m0 + r, n0 + j);
+        }
+    }
+}
+
+template <bool BF16>
+__attribute__((target("avx2,f16c")))
+static inline __m256 load_half8(const uint16_t *p) {
+    __m128i v = _mm_load_si128((const __m128i*) p);
+    if (BF16) return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvtepu16_epi32(v), 16));
+    return _mm256_cvtph_ps(v);
+}
+
+template <bool BF16>
+__attribute__((target("avx512f")))
+static inline __m512 load_half16(const uint16_t *p) {
+    __m256i v = _mm256_load_si256((const __m256i*) p);
+    if (BF16) return _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_cvtepu16_epi32(v), 16));
+    return _mm512_cvtph_ps(v);
+}
+
+// Batched AVX2 kernel on a 16-bit panel, 8 rows of X per panel
+template <bool BF16, class Epilogue>
+__attribute__((target("avx2,f16c")))
+static void gemm_half_avx2(
+    const uint16_t *X, const tcsc_t *W, int M, int N, int K, const Epilogue &epi
+) {
+    const int mb = 8, nb = 8;
+    uint16_t *panel;
+    if (posix_memalign((void**) &panel, 64, (size_t) K * mb * sizeof(uint16_t)) != 0) {
+        perror("posix_memalign failed @ gemm_half_avx2()");
+        exit(EXIT_FAILURE);
+    }
+    alignas(32) float tile[8 * 8];
+
+    for (int m0 = 0; m0 < M; m0 += mb) {
+        int rows = (M - m0 < mb) ? M - m0 : mb;
+        pack_half_panel(X, panel, m0, rows, mb, K);
+
+        for (int n0 = 0; n0 < N; n0 += nb) {
+            int cols = (N - n0 < nb) ? N - n0 : nb;
+            for (int j = 0; j < cols; ++j) {
+                int n = n0 + j;
+                __m256 acc0 = _mm256_setzero_ps();
+                __m256 acc1 = _mm256_setzero_ps();
+
+                int k = W->col_start_pos[n];
+                int end = W->col_start_pos[n + 1];
+                for (; k + 2 <= end; k += 2) {
+                    acc0 = _mm256_add_ps(acc0, load_half8<BF16>(&panel[W->row_index_pos[k] * mb]));
+                    acc1 = _mm256_add_ps(acc1, load_half8<BF16>(&panel[W->row_index_pos[k + 1] * mb]));
+                }
+                if (k < end)
+                    acc0 = _mm256_add_ps(acc0, load_half8<BF16>(&panel[W->row_index_pos[k] * mb]));
+
+                k = W->col_start_neg[n];
+                end = W->col_start_neg[n + 1];
+                for (; k + 2 <= end; k += 2) {
+                    acc0 = _mm256_sub_ps(acc0, load_half8<BF16>(&panel[W->row_index_neg[k] * mb]));
+                    acc1 = _mm256_sub_ps(acc1, load_half8<BF16>(&panel[W->row_index_neg[k + 1] * mb]));
+                }
+                if (k < end)
+                    acc0 = _mm256_sub_ps(acc0, load_half8<BF16>(&panel[W->row_index_neg[k] * mb]));
+
+                _mm256_store_ps(&tile[j * mb], _mm256_add_ps(acc0, acc1));
+            }
+            store_half_tile(tile, m0, rows, mb, n0, cols, epi);
+        }
+    }
+    free(panel);
+}
+
+// Batched AVX-512 kernel on a 16-bit panel, 16 rows of X per panel
+template <bool BF16, class Epilogue>
+__attribute__((target("avx512f")))
+static void gemm_half_avx512(
+    const uint16_t *X, const tcsc_t *W, int M, int N, int K, const Epilogue &epi
+) {
+    const int mb = 16, nb = 8;
+    uint16_t *panel;
+    if (posix_memalign((void**) &panel, 64, (size_t) K * mb * sizeof(uint16_t)) != 0) {
+        perror("posix_memalign failed @ gemm_half_avx512()");
+        exit(EXIT_FAILURE);
+    }
+    alignas(64) float tile[16 * 8];
+
+    for (int m0 = 0; m0 < M; m0 += mb) {
+        int rows = (M - m0 < mb) ? M - m0 : mb;
+        pack_half_panel(X, panel, m0, rows, mb, K);
+
+        for (int n0 = 0; n0 < N; n0 += nb) {
+            int cols = (N - n0 < nb) ? N - n0 : nb;
+            for (int j = 0; j < cols; ++j) {
+                int n = n0 + j;
+                __m512 acc0 = _mm512_setzero_ps();
+                __m512 acc1 = _mm512_setzero_ps();
+
+                int k = W->col_start_pos[n];
+                int end = W->col_start_pos[n + 1];
+                for (; k + 2 <= end; k += 2) {
+                    acc0 = _mm512_add_ps(acc0, load_half16<BF16>(&panel[W->row_index_pos[k] * mb]));
+                    acc1 = _mm512_add_ps(acc1, load_half16<BF16>(&panel[W->row_index_pos[k + 1] * mb]));
+                }
+                if (k < end)
+                    acc0 = _mm512_add_ps(acc0, load_half16<BF16>(&panel[W->row_index_pos[k] * mb]));
+
+                k = W->col_start_neg[n];
+                end = W->col_start_neg[n + 1];
+                for (; k + 2 <= end; k += 2) {
+                    acc0 = _mm512_sub_ps(acc0, load_half16<BF16>(&panel[W->row_index_neg[k] * mb]));
+                    acc1 = _mm512_sub_ps(acc1, load_half16<BF16>(&panel[W->row_index_neg[k + 1] * mb]));
+                }
+                if (k < end)
+                    acc0 = _mm512_sub_ps(acc0, load_half16<BF16>(&panel[W->row_index_neg[k] * mb]));
+
+                _mm512_store_ps(&tile[j * mb], _mm512_add_ps(acc0, acc1));
+            }
+            store_half_tile(tile, m0, rows, mb, n0, cols, epi);
+        }
+    }
+    free(panel);
+}
+#endif
+
+// Runtime dispatch on CPUID and format, like tcsc_sgemm_batched
+template <class Epilogue>
+static void gemm_half(
+    const uint16_t *X, tcsc_half_t fmt, const tcsc_t *W, int M, int N, int K, const Epilogue &epi
+) {
+#ifdef __x86_64__
+    if (M >= 16 && __builtin_cpu_supports("avx512f")) {
+        if (fmt == TCSC_BF16) gemm_half_avx512<true>(X, W, M, N, K, epi);
+        else gemm_half_avx512<false>(X, W, M, N, K, epi);
+        return;
+    }
+    if (M >= 8 && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("f16c")) {
+        if (fmt == TCSC_BF16) gemm_half_avx2<true>(X, W, M, N, K, epi);
+        else gemm_half_avx2<false>(X, W, M, N, K, epi);
+        return;
+    }
+#endif
+    gemm_half_scalar(X, fmt, W, M, N, K, epi);
+}
+
+void tcsc_sgemm_half(
+    const uint16_t *X, tcsc_half_t fmt, const tcsc_t *W, const dense_t B, dense_t Y,
+    int M, int N, int K
+) {
+    gemm_half(X, fmt, W, M, N, K, make_epilogue(ep_store_f32{Y, N}, ep_bias{B}));
+}
+
+void tcsc_sgemm_half_out(
+    const uint16_t *X, tcsc_half_t fmt, const tcsc_t *W, const dense_t B, uint16_t *Y,
+    int M, int N, int K
+) {
+    gemm_half(X, fmt, W, M, N, K, make_epilogue(ep_store_half{Y, N, fmt}, ep_bias{B}));
+}
@@ -0,0 +1,37 @@
+#ifndef TCSC_HALF_H
+#define TCSC_HALF_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "../dense/dense.h"
+#include "tcsc.h"
+
+// 16-bit activation storage formats
+typedef enum {
+    TCSC_FP16, // IEEE half precision
+    TCSC_BF16  // upper half of a float
+} tcsc_half_t;
+
+// Round to nearest even conversions of n values
+void tcsc_to_half(const float *x, size_t n, tcsc_half_t fmt, uint16_t *h);
+void tcsc_from_half(const uint16_t *h, size_t n, tcsc_half_t fmt, float *x);
+
+// TCSC kernels on half-precision X, accumulated in fp32. Like
+// tcsc_sgemm_batched, blocks of 8 (AVX2 + F16C) or 16 (AVX-512) rows of X
+// are packed into a K x mb panel, which now holds 16-bit values and is
+// converted on load (vcvtph2ps for fp16, a 16 bit shift for bf16), so the
+// panel and its cache footprint are half the size. M < 8 converts each
+// row of X once and uses the scalar kernel.
+void tcsc_sgemm_half(
+    const uint16_t *X, tcsc_half_t fmt, const tcsc_t *W, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+
+// As tcsc_sgemm_half with Y rounded to the same half format, ready to be
+// the X of the next layer
+void tcsc_sgemm_half_out(
+    const uint16_t *X, tcsc_half_t fmt, const tcsc_t *W, const dense_t B, uint16_t *Y,
+    int M, int N, int K
+);
+
+#endif
@@ -0,0 +1,319 @@
+#include "tcsc_int.h"
+#include "epilogue.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <type_traits>
+
+tcsc_qparams_t tcsc_quant_params(const dense_t X, size_t n, int bits) {
+    float lo = 0.0f, hi = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        lo = (X[i] < lo) ? X[i] : lo;
+        hi = (X[i] > hi) ? X[i] : hi;
+    }
+    int q_min = -(1 << (bits - 1)), q_max = (1 << (bits - 1)) - 1;
+
+    tcsc_qparams_t qp;
+    qp.scale = (hi > lo) ? (hi - lo) / (float) (q_max - q_min) : 1.0f;
+    qp.zero_point = q_min - (int) lrintf(lo / qp.scale);
+    qp.zero_point = (qp.zero_point < q_min) ? q_min : ((qp.zero_point > q_max) ? q_max : qp.zero_point);
+    return qp;
+}
+
+static inline int quantize(float x, tcsc_qparams_t qp, int q_min, int q_max) {
+    int q = (int) lrintf(x / qp.scale) + qp.zero_point;
+    return (q < q_min) ? q_min : ((q > q_max) ? q_max : q);
+}
+
+void tcsc_quantize_s8(const dense_t X, size_t n, tcsc_qparams_t qp, int8_t *Xq) {
+    for (size_t i = 0; i < n; ++i) {
+        Xq[i] = (int8_t) quantize(X[i], qp, INT8_MIN, INT8_MAX);
+    }
+}
+
+void tcsc_quantize_s16(const dense_t X, size_t n, tcsc_qparams_t qp, int16_t *Xq) {
+    for (size_t i = 0; i < n; ++i) {
+        Xq[i] = (int16_t) quantize(X[i], qp, INT16_MIN, INT16_MAX);
+    }
+}
+
+// Dequantization factor of the integer sum of column n
+static inline float column_scale(const tcsc_t *W, float x_scale, int n) {
+    return W->col_scale ? x_scale * W->col_scale[n] : x_scale;
+}
+
+// x_zero times (number of +1 minus number of -1 entries of column n), the
+// contribution of the zero point to every integer sum of the column
+static inline int32_t zero_correction(const tcsc_t *W, int x_zero, int n) {
+    int pos = W->col_start_pos[n + 1] - W->col_start_pos[n];
+    int neg = W->col_start_neg[n + 1] - W->col_start_neg[n];
+    return x_zero * (pos - neg);
+}
+
+// Scalar kernel with int32 accumulation, column-outer like
+// tcsc_sgemm_optimized
+template <typename T, class Epilogue>
+static void gemm_int_scalar(
+    const T *X, tcsc_qparams_t xq, const tcsc_t *W, int M, int N, int K, const Epilogue &epi
+) {
+    for (int n = 0; n < N; ++n) {
+        int pos_start = W->col_start_pos[n], pos_end = W->col_start_pos[n + 1];
+        int neg_start = W->col_start_neg[n], neg_end = W->col_start_neg[n + 1];
+        float scale = column_scale(W, xq.scale, n);
+        int32_t corr = zero_correction(W, xq.zero_point, n);
+
+        for (int m = 0; m < M; ++m) {
+            const T *x = X + (size_t) m * K;
+            int32_t acc_pos = 0, acc_neg = 0;
+            for (int k = pos_start; k < pos_end; ++k) {
+                acc_pos += x[W->row_index_pos[k]];
+            }
+            for (int k = neg_start; k < neg_end; ++k) {
+                acc_neg += x[W->row_index_neg[k]];
+            }
+            epi(scale * (float) (acc_pos - acc_neg - corr), m, n);
+        }
+    }
+}
+
+#ifdef __x86_64__
+#include <immintrin.h>
+
+// Indices summed in int16 lanes before they are widened: each of the two
+// accumulators takes half, at most 255 values of magnitude <= 128
+#define S8_CHUNK 510
+
+// Packs rows [m0, m0 + rows) of X into a K x mb panel of wider integers,
+// zero padding the lanes past the last row
+template <typename T, typename P>
+static void pack_int_panel(const T *X, P *panel, int m0, int rows, int mb, int K) {
+    for (int k = 0; k < K; ++k) {
+        for (int r = 0; r < mb; ++r) {
+            panel[k * mb + r] = (r < rows) ? (P) X[(size_t) (m0 + r) * K + k] : 0;
+        }
+    }
+}
+
+// Dequantizes a column-major mb x nb tile of integer sums (tile[j * mb + r])
+// through the epilogue
+template <class Epilogue>
+static inline void store_int_tile(
+    const int32_t *tile, const tcsc_t *W, tcsc_qparams_t xq,
+    int m0, int rows, int mb, int n0, int cols, const Epilogue &epi
+) {
+    float scale[8];
+    int32_t corr[8];
+    for (int j = 0; j < cols; ++j) {
+        scale[j] = column_scale(W, xq.scale, n0 + j);
+        corr[j] = zero_correction(W, xq.zero_point, n0 + j);
+    }
+    for (int r = 0; r < rows; ++r) {
+        for (int j = 0; j < cols; ++j) {
+            epi(scale[j] * (float) (tile[j * mb + r] - corr[j]), m0 + r, n0 + j);
+        }
+    }
+}
+
+// Adds (NEG: subtracts) the 16-lane panel rows idx[begin, end) into the
+// int32 sums lo (rows 0-7) and hi (rows 8-15)
+template <bool NEG>
+__attribute__((target("avx2")))
+static inline void accumulate_s8(
+    const int16_t *panel, const int *idx, int begin, int end, __m256i *lo, __m256i *hi
+) {
+    for (int c = begin; c < end; c += S8_CHUNK) {
+        int e = (end - c < S8_CHUNK) ? end : c + S8_CHUNK;
+        __m256i acc0 = _mm256_setzero_si256();
+        __m256i acc1 = _mm256_setzero_si256();
+        int k = c;
+        for (; k + 2 <= e; k += 2) {
+            __m256i v0 = _mm256_load_si256((const __m256i*) &panel[idx[k] * 16]);
+            __m256i v1 = _mm256_load_si256((const __m256i*) &panel[idx[k + 1] * 16]);
+            acc0 = NEG ? _mm256_sub_epi16(acc0, v0) : _mm256_add_epi16(acc0, v0);
+            acc1 = NEG ? _mm256_sub_epi16(acc1, v1) : _mm256_add_epi16(acc1, v1);
+        }
+        if (k < e) {
+            __m256i v0 = _mm256_load_si256((const __m256i*) &panel[idx[k] * 16]);
+            acc0 = NEG ? _mm256_sub_epi16(acc0, v0) : _mm256_add_epi16(acc0, v0);
+        }
+        __m256i lo16 = _mm256_add_epi32(
+            _mm256_cvtepi16_epi32(_mm256_castsi256_si128(acc0)),
+            _mm256_cvtepi16_epi32(_mm256_castsi256_si128(acc1)));
+        __m256i hi16 = _mm256_add_epi32(
+            _mm256_cvtepi16_epi32(_mm256_extracti128_si256(acc0, 1)),
+            _mm256_cvtepi16_epi32(_mm256_extracti128_si256(acc1, 1)));
+        *lo = _mm256_add_epi32(*lo, lo16);
+        *hi = _mm256_add_epi32(*hi, hi16);
+    }
+}
+
+// Adds (NEG: subtracts) the 8-lane int32 panel rows idx[begin, end)
+template <bool NEG>
+__attribute__((target("avx2")))
+static inline __m256i accumulate_s16(
+    const int32_t *panel, const int *idx, int begin, int end, __m256i acc0
+) {
+    __m256i acc1 = _mm256_setzero_si256();
+    int k = begin;
+    for (; k + 2 <= end; k += 2) {
+        __m256i v0 = _mm256_load_si256((const __m256i*) &panel[idx[k] * 8]);
+        __m256i v1 = _mm256_load_si256((const __m256i*) &panel[idx[k + 1] * 8]);
+        acc0 = NEG ? _mm256_sub_epi32(acc0, v0) : _mm256_add_epi32(acc0, v0);
+        acc1 = NEG ? _mm256_sub_epi32(acc1, v1) : _mm256_add_epi32(acc1, v1);
+    }
+    if (k < end) {
+        __m256i v0 = _mm256_load_si256((const __m256i*) &panel[idx[k] * 8]);
+        acc0 = NEG ? _mm256_sub_epi32(acc0, v0) : _mm256_add_epi32(acc0, v0);
+    }
+    return _mm256_add_epi32(acc0, acc1);
+}
+
+// Batched AVX2 kernel, 16 (int8 X, int16 panel) or 8 (int16 X, int32
+// panel) rows per panel. The integer sums of an mb x 8 tile are collected
+// column-major and then dequantized through the epilogue.
+template <typename T, class Epilogue>
+__attribute__((target("avx2")))
+static void gemm_int_avx2(
+    const T *X, tcsc_qparams_t xq, const tcsc_t *W, int M, int N, int K, const Epilogue &epi
+) {
+    typedef typename std::conditional<sizeof(T) == 1, int16_t, int32_t>::type panel_t;
+    const int mb = (sizeof(T) == 1) ? 16 : 8, nb = 8;
+    panel_t *panel;
+    if (posix_memalign((void**) &panel, 64, (size_t) K * mb * sizeof(panel_t)) != 0) {
+        perror("posix_memalign failed @ gemm_int_avx2()");
+        exit(EXIT_FAILURE);
+    }
+    alignas(32) int32_t tile[16 * 8];
+
+    for (int m0 = 0; m0 < M; m0 += mb) {
+        int rows = (M - m0 < mb) ? M - m0 : mb;
+        pack_int_panel(X, panel, m0, rows, mb, K);
+
+        for (int n0 = 0; n0 < N; n0 += nb) {
+            int cols = (N - n0 < nb) ? N - n0 : nb;
+            for (int j = 0; j < cols; ++j) {
+                int n = n0 + j;
+                int pos_start = W->col_start_pos[n], pos_end = W->col_start_pos[n + 1];
+                int neg_start = W->col_start_neg[n], neg_end = W->col_start_neg[n + 1];
+
+                if (sizeof(T) == 1) {
+                    __m256i lo = _mm256_setzero_si256(), hi = _mm256_setzero_si256();
+                    accumulate_s8<false>((const int16_t*) panel, W->row_index_pos, pos_start, pos_end, &lo, &hi);
+                    accumulate_s8<true>((const int16_t*) panel, W->row_index_neg, neg_start, neg_end, &lo, &hi);
+                    _mm256_store_si256((__m256i*) &tile[j * mb], lo);
+                    _mm256_store_si256((__m256i*) &tile[j * mb + 8], hi);
+                } else {
+                    __m256i acc = _mm256_setzero_si256();
+                    acc = accumulate_s16<false>((const int32_t*) panel, W->row_index_pos, pos_start, pos_end, acc);
+                    acc = accumulate_s16<true>((const int32_t*) panel, W->row_index_neg, neg_start, neg_end, acc);
+                    _mm256_store_si256((__m256i*) &tile[j * mb], acc);
+                }
+            }
+
+            store_int_tile(tile, W, xq, m0, rows, mb, n0, cols, epi);
+        }
+    }
+    free(panel);
+}
+
+// AVX-512BW version of the int8 kernel, 32 rows per panel in int16 lanes
+template <class Epilogue>
+__attribute__((target("avx512f,avx512bw")))
+static void gemm_s8_avx512(
+    const int8_t *X, tcsc_qparams_t xq, const tcsc_t *W, int M, int N, int K, const Epilogue &epi
+) {
+    const int mb = 32, nb = 8;
+    int16_t *panel;
+    if (posix_memalign((void**) &panel, 64, (size_t) K * mb * sizeof(int16_t)) != 0) {
+        perror("posix_memalign failed @ gemm_s8_avx512()");
+        exit(EXIT_FAILURE);
+    }
+    alignas(64) int32_t tile[32 * 8];
+
+    for (int m0 = 0; m0 < M; m0 += mb) {
+        int rows = (M - m0 < mb) ? M - m0 : mb;
+        pack_int_panel(X, panel, m0, rows, mb, K);
+
+        for (int n0 = 0; n0 < N; n0 += nb) {
+            int cols = (N - n0 < nb) ? N - n0 : nb;
+            for (int j = 0; j < cols; ++j) {
+                int n = n0 + j;
+                __m512i lo = _mm512_setzero_si512(), hi = _mm512_setzero_si512();
+                for (int neg = 0; neg < 2; ++neg) {
+                    const int *idx = neg ? W->row_index_neg : W->row_index_pos;
+                    int begin = neg ? W->col_start_neg[n] : W->col_start_pos[n];
+                    int end = neg ? W->col_start_neg[n + 1] : W->col_start_pos[n + 1];
+
+                    for (int c = begin; c < end; c += S8_CHUNK) {
+                        int e = (end - c < S8_CHUNK) ? end : c + S8_CHUNK;
+                        __m512i acc0 = _mm512_setzero_si512();
+                        __m512i acc1 = _mm512_setzero_si512();
+                        int k = c;
+                        for (; k + 2 <= e; k += 2) {
+                            acc0 = _mm512_add_epi16(acc0, _mm512_load_si512(&panel[idx[k] * 32]));
+                            acc1 = _mm512_add_epi16(acc1, _mm512_load_si512(&panel[idx[k + 1] * 32]));
+                        }
+                        if (k < e)
+                            acc0 = _mm512_add_epi16(acc0, _mm512_load_si512(&panel[idx[k] * 32]));
+                        // the sign is applied after widening so that one
+                        // loop serves both index streams
+                        __m512i wide_lo = _mm512_add_epi32(
+                            _mm512_cvtepi16_epi32(_mm512_castsi512_si256(acc0)),
+                            _mm512_cvtepi16_epi32(_mm512_castsi512_si256(acc1)));
+                        __m512i wide_hi = _mm512_add_epi32(
+                            _mm512_cvtepi16_epi32(_mm512_extracti64x4_epi64(acc0, 1)),
+                            _mm512_cvtepi16_epi32(_mm512_extracti64x4_epi64(acc1, 1)));
+                        lo = neg ? _mm512_sub_epi32(lo, wide_lo) : _mm512_add_epi32(lo, wide_lo);
+                        hi = neg ? _mm512_sub_epi32(hi, wide_hi) : _mm512_add_epi32(hi, wide_hi);
+                    }
+                }
+                _mm512_store_si512(&tile[j * mb], lo);
+                _mm512_store_si512(&tile[j * mb + 16], hi);
+            }
+            store_int_tile(tile, W, xq, m0, rows, mb, n0, cols, epi);
+        }
+    }
+    free(panel);
+}
+#endif
+
+// Runtime dispatch between the panel kernels and the scalar kernel
+template <typename T, class Epilogue>
+static void gemm_int(
+    const T *X, tcsc_qparams_t xq, const tcsc_t *W, int M, int N, int K, const Epilogue &epi
+) {
+#ifdef __x86_64__
+    if (sizeof(T) == 1 && M >= 32 && __builtin_cpu_supports("avx512bw")) {
+        gemm_s8_avx512((const int8_t*) X, xq, W, M, N, K, epi);
+        return;
+    }
+    if (M >= 8 && __builtin_cpu_supports("avx2")) {
+        gemm_int_avx2(X, xq, W, M, N, K, epi);
+        return;
+    }
+#endif
+    gemm_int_scalar(X, xq, W, M, N, K, epi);
+}
+
+void tcsc_gemm_s8(
+    const int8_t *X, tcsc_qparams_t xq, const tcsc_t *W, const dense_t B, dense_t Y,
+    int M, int N, int K
+) {
+    gemm_int(X, xq, W, M, N, K, make_epilogue(ep_store_f32{Y, N}, ep_bias{B}));
+}
+
+void tcsc_gemm_s16(
+    const int16_t *X, tcsc_qparams_t xq, const tcsc_t *W, const dense_t B, dense_t Y,
+    int M, int N, int K
+) {
+    gemm_int(X, xq, W, M, N, K, make_epilogue(ep_store_f32{Y, N}, ep_bias{B}));
+}
+
+void tcsc_gemm_s8_q8(
+    const int8_t *X, tcsc_qparams_t xq, const tcsc_t *W, const dense_t B,
+    tcsc_qparams_t yq, int8_t *Q,
+    int M, int N, int K
+) {
+    gemm_int(X, xq, W, M, N, K,
+             make_epilogue(ep_store_q8{Q, N, 1.0f / yq.scale, yq.zero_point}, ep_bias{B}));
+}
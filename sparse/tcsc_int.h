@@ -0,0 +1,52 @@
+#ifndef TCSC_INT_H
+#define TCSC_INT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "../dense/dense.h"
+#include "tcsc.h"
+
+// Affine quantization, a real value x is stored as
+// q = round(x / scale) + zero_point
+typedef struct {
+    float scale;
+    int zero_point;
+} tcsc_qparams_t;
+
+// Parameters that cover the range of the n values of X (and 0) with a
+// signed integer of the given bits (8 or 16)
+tcsc_qparams_t tcsc_quant_params(const dense_t X, size_t n, int bits);
+
+// Saturating quantization of n values
+void tcsc_quantize_s8(const dense_t X, size_t n, tcsc_qparams_t qp, int8_t *Xq);
+void tcsc_quantize_s16(const dense_t X, size_t n, tcsc_qparams_t qp, int16_t *Xq);
+
+// TCSC kernels on quantized activations. The ternary sums are computed in
+// integers only:
+//  int8 X:  16 rows per AVX2 panel (32 with AVX-512BW, M >= 32) with
+//           int16 adds (vpaddw), widened to int32 before an int16 lane
+//           can overflow
+//  int16 X: 8 rows per AVX2 panel with int32 adds (vpaddd)
+// The zero point is removed once per output as x_zero * (pos - neg), the
+// number of +1 and -1 entries of the column, and the result is dequantized
+// with x_scale (times W->col_scale[n] if set, group scales are not
+// supported) before the bias is added. M < 8 uses the scalar kernel.
+void tcsc_gemm_s8(
+    const int8_t *X, tcsc_qparams_t xq, const tcsc_t *W, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+
+void tcsc_gemm_s16(
+    const int16_t *X, tcsc_qparams_t xq, const tcsc_t *W, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+
+// As tcsc_gemm_s8 with the output requantized to int8 with yq in the
+// epilogue, so a chain of layers never leaves the integer domain in memory
+void tcsc_gemm_s8_q8(
+    const int8_t *X, tcsc_qparams_t xq, const tcsc_t *W, const dense_t B,
+    tcsc_qparams_t yq, int8_t *Q,
+    int M, int N, int K
+);
+
+#endif
@@ -0,0 +1,410 @@
+#include <stdio.h>
+#include <stdlib.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "tcsc_parallel.h"
+
+// requested number of threads, 0 means all available
+static int requested_threads = 0;
+
+void tcsc_parallel_set_threads(int nthreads) {
+    requested_threads = (nthreads > 0) ? nthreads : 0;
+}
+
+int tcsc_parallel_threads(void) {
+#ifdef _OPENMP
+    return requested_threads ? requested_threads : omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+// Work of the columns [0, n): non-zeros plus one unit per column for the
+// loop overhead and the Y store
+static inline long column_cost(const tcsc_t *W, int n) {
+    return (long) W->col_start_pos[n] + W->col_start_neg[n] + n;
+}
+
+void tcsc_partition_columns(const tcsc_t *W, int parts, int align, int *bounds) {
+    int N = W->cols;
+    long total = column_cost(W, N);
+
+    bounds[0] = 0;
+    for (int p = 1; p < parts; ++p) {
+        long target = total * p / parts;
+
+        // smallest n with column_cost(n) >= target
+        int lo = bounds[p - 1], hi = N;
+        while (lo < hi) {
+            int mid = lo + (hi - lo) / 2;
+            if (column_cost(W, mid) < target) lo = mid + 1;
+            else hi = mid;
+        }
+
+        // round to the nearest aligned column, never moving backwards
+        int n = (lo + align / 2) / align * align;
+        if (n < bounds[p - 1]) n = bounds[p - 1];
+        if (n > N) n = N;
+        bounds[p] = n;
+    }
+    bounds[parts] = N;
+}
+
+// Computes rows [m0, m1) of the columns [n0, n1) of Y
+template <bool PRELU>
+static void sgemm_range(
+    const dense_t X, const tcsc_t* W, const dense_t B, float a, dense_t Y,
+    int N, int K, int m0, int m1, int n0, int n1
+) {
+    for (int n = n0; n < n1; ++n) {
+        int pos_start = W->col_start_pos[n], pos_end = W->col_start_pos[n + 1];
+        int neg_start = W->col_start_neg[n], neg_end = W->col_start_neg[n + 1];
+
+        for (int m = m0; m < m1; ++m) {
+            const float *x = X + (size_t) m * K;
+            // independent accumulators to hide the add latency
+            float acc0 = 0.0f, acc1 = 0.0f, acc2 = 0.0f, acc3 = 0.0f;
+
+            int k = pos_start;
+            for (; k + 3 < pos_end; k += 4) {
+                acc0 += x[W->row_index_pos[k]];
+                acc1 += x[W->row_index_pos[k + 1]];
+                acc2 += x[W->row_index_pos[k + 2]];
+                acc3 += x[W->row_index_pos[k + 3]];
+            }
+            for (; k < pos_end; ++k) {
+                acc0 += x[W->row_index_pos[k]];
+            }
+
+            k = neg_start;
+            for (; k + 3 < neg_end; k += 4) {
+                acc0 -= x[W->row_index_neg[k]];
+                acc1 -= x[W->row_index_neg[k + 1]];
+                acc2 -= x[W->row_index_neg[k + 2]];
+                acc3 -= x[W->row_index_neg[k + 3]];
+            }
+            for (; k < neg_end; ++k) {
+                acc0 -= x[W->row_index_neg[k]];
+            }
+
+            float y = B[n] + ((acc0 + acc1) + (acc2 + acc3));
+            if (PRELU) {
+                y = (y < 0.0f) ? a * y : y;
+            }
+            Y[(size_t) m * N + n] = y;
+        }
+    }
+}
+
+// Splits the threads into a row_parts x col_parts grid. Rows are only split
+// while every thread keeps at least TCSC_PAR_MIN_ROWS rows, so for small M
+// all threads share the rows and partition the columns.
+static int choose_row_parts(int M, int threads) {
+    int row_parts = 1;
+    for (int d = 1; d <= threads; ++d) {
+        if (threads % d == 0 && M / d >= TCSC_PAR_MIN_ROWS) row_parts = d;
+    }
+    return row_parts;
+}
+
+// Thread index and team size inside a parallel region
+static inline int thread_id(void) {
+#ifdef _OPENMP
+    return omp_get_thread_num();
+#else
+    return 0;
+#endif
+}
+
+static inline int team_size(void) {
+#ifdef _OPENMP
+    return omp_get_num_threads();
+#else
+    return 1;
+#endif
+}
+
+// First entry in [begin, end) of a sorted row index array that is >= k
+static inline int lower_bound_row(const int *row_index, int begin, int end, int k) {
+    while (begin < end) {
+        int mid = begin + (end - begin) / 2;
+        if (row_index[mid] < k) begin = mid + 1;
+        else end = mid;
+    }
+    return begin;
+}
+
+// Partial sums of the rows [k0, k1) of W for all of Y, written to buf
+static void sgemm_k_range(
+    const dense_t X, const tcsc_t* W, float *buf, int M, int N, int K, int k0, int k1
+) {
+    for (int n = 0; n < N; ++n) {
+        int col_pos = W->col_start_pos[n], col_pos_end = W->col_start_pos[n + 1];
+        int col_neg = W->col_start_neg[n], col_neg_end = W->col_start_neg[n + 1];
+        int pos_start = lower_bound_row(W->row_index_pos, col_pos, col_pos_end, k0);
+        int pos_end = lower_bound_row(W->row_index_pos, pos_start, col_pos_end, k1);
+        int neg_start = lower_bound_row(W->row_index_neg, col_neg, col_neg_end, k0);
+        int neg_end = lower_bound_row(W->row_index_neg, neg_start, col_neg_end, k1);
+
+        for (int m = 0; m < M; ++m) {
+            const float *x = X + (size_t) m * K;
+            float acc0 = 0.0f, acc1 = 0.0f;
+            int k = pos_start;
+            for (; k + 1 < pos_end; k += 2) {
+                acc0 += x[W->row_index_pos[k]];
+                acc1 += x[W->row_index_pos[k + 1]];
+            }
+            if (k < pos_end) acc0 += x[W->row_index_pos[k]];
+            k = neg_start;
+            for (; k + 1 < neg_end; k += 2) {
+                acc0 -= x[W->row_index_neg[k]];
+                acc1 -= x[W->row_index_neg[k + 1]];
+            }
+            if (k < neg_end) acc0 -= x[W->row_index_neg[k]];
+            buf[(size_t) m * N + n] = acc0 + acc1;
+        }
+    }
+}
+
+// Split-K buffers of the calling thread, kept across calls and grown on
+// demand like the partial sums of bcsr_par_t, released at thread exit
+struct split_k_buffer_t {
+    float *data = NULL;
+    size_t size = 0;
+    ~split_k_buffer_t() { free(data); }
+};
+static thread_local split_k_buffer_t split_k_buffer;
+
+// Split-K: thread t sums the K range [K*t/T, K*(t+1)/T) into its private
+// buffer, then the buffers are folded pairwise (log2 T levels). Every level
+// is split over all threads by aligned element ranges, a final pass over
+// the same ranges adds the bias, applies PReLU and writes Y.
+template <bool PRELU>
+static void sgemm_split_k(
+    const dense_t X, const tcsc_t* W, const dense_t B, float a, dense_t Y,
+    int M, int N, int K, int threads
+) {
+    size_t total = (size_t) M * N;
+    // buffer stride rounded up to whole cache lines
+    size_t stride = (total + TCSC_PAR_ALIGN - 1) / TCSC_PAR_ALIGN * TCSC_PAR_ALIGN;
+    size_t size = threads * stride;
+    if (size > split_k_buffer.size) {
+        free(split_k_buffer.data);
+        if (posix_memalign((void**) &split_k_buffer.data, 64, size * sizeof(float)) != 0) {
+            perror("posix_memalign failed @ sgemm_split_k()");
+            exit(EXIT_FAILURE);
+        }
+        split_k_buffer.size = size;
+    }
+    float *buf = split_k_buffer.data;
+
+    #pragma omp parallel num_threads(threads)
+    {
+        int t = thread_id(), T = team_size();
+        int k0 = (int) ((long) K * t / T), k1 = (int) ((long) K * (t + 1) / T);
+        sgemm_k_range(X, W, buf + t * stride, M, N, K, k0, k1);
+
+        // element range of this thread in every reduction level
+        size_t e0 = total * t / T / TCSC_PAR_ALIGN * TCSC_PAR_ALIGN;
+        size_t e1 = (t + 1 == T) ? total : total * (t + 1) / T / TCSC_PAR_ALIGN * TCSC_PAR_ALIGN;
+
+        for (int step = 1; step < T; step *= 2) {
+            #pragma omp barrier
+            for (int dst = 0; dst + step < T; dst += 2 * step) {
+                float *d = buf + dst * stride;
+                const float *src = buf + (dst + step) * stride;
+                for (size_t e = e0; e < e1; ++e) {
+                    d[e] += src[e];
+                }
+            }
+        }
+        #pragma omp barrier
+
+        int n = (int) (e0 % N);
+        for (size_t e = e0; e < e1; ++e) {
+            float y = B[n] + buf[e];
+            if (PRELU) {
+                y = (y < 0.0f) ? a * y : y;
+            }
+            Y[e] = y;
+            if (++n == N) n = 0;
+        }
+    }
+}
+
+template <bool PRELU>
+static void sgemm_columns(
+    const dense_t X, const tcsc_t* W, const dense_t B, float a, dense_t Y,
+    int M, int N, int K, int threads
+) {
+    int row_parts = choose_row_parts(M, threads);
+    int col_parts = threads / row_parts;
+
+    int *bounds = (int*) malloc((col_parts + 1) * sizeof(int));
+    if (!bounds) {
+        perror("malloc failed @ sgemm_columns()");
+        exit(EXIT_FAILURE);
+    }
+    tcsc_partition_columns(W, col_parts, TCSC_PAR_ALIGN, bounds);
+
+    #pragma omp parallel for num_threads(threads) schedule(static, 1)
+    for (int t = 0; t < threads; ++t) {
+        int rp = t / col_parts, cp = t % col_parts;
+        int m0 = (int) ((long) M * rp / row_parts);
+        int m1 = (int) ((long) M * (rp + 1) / row_parts);
+        sgemm_range<PRELU>(X, W, B, a, Y, N, K, m0, m1, bounds[cp], bounds[cp + 1]);
+    }
+
+    free(bounds);
+}
+
+// Split-K pays off once the rows cannot be split and the columns give
+// fewer than two aligned ranges per thread
+static tcsc_par_mode_t choose_mode(int M, int N, int threads) {
+    if (threads > 1 && choose_row_parts(M, threads) == 1 && N < 2 * threads * TCSC_PAR_ALIGN) {
+        return TCSC_PAR_SPLIT_K;
+    }
+    return TCSC_PAR_COLUMNS;
+}
+
+template <bool PRELU>
+static void sgemm_parallel(
+    const dense_t X, const tcsc_t* W, const dense_t B, float a, dense_t Y,
+    int M, int N, int K, tcsc_par_mode_t mode
+) {
+    int threads = tcsc_parallel_threads();
+    if (mode == TCSC_PAR_AUTO) {
+        mode = choose_mode(M, N, threads);
+    }
+
+    if (mode == TCSC_PAR_SPLIT_K) {
+        sgemm_split_k<PRELU>(X, W, B, a, Y, M, N, K, threads);
+    } else {
+        sgemm_columns<PRELU>(X, W, B, a, Y, M, N, K, threads);
+    }
+}
+
+void tcsc_sgemm_parallel(
+    const dense_t X, const tcsc_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+) {
+    sgemm_parallel<false>(X, W, B, 0.0f, Y, M, N, K, TCSC_PAR_AUTO);
+}
+
+void tcsc_sgemm_prelu_parallel(
+    const dense_t X, const tcsc_t* W, const dense_t B, float a, dense_t Y,
+    int M, int N, int K
+) {
+    sgemm_parallel<true>(X, W, B, a, Y, M, N, K, TCSC_PAR_AUTO);
+}
+
+void tcsc_sgemm_parallel_mode(
+    const dense_t X, const tcsc_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K, tcsc_par_mode_t mode
+) {
+    sgemm_parallel<false>(X, W, B, 0.0f, Y, M, N, K, mode);
+}
+
+void tcsc_sgemm_prelu_parallel_mode(
+    const dense_t X, const tcsc_t* W, const dense_t B, float a, dense_t Y,
+    int M, int N, int K, tcsc_par_mode_t mode
+) {
+    sgemm_parallel<true>(X, W, B, a, Y, M, N, K, mode);
+}
+
+// Arguments of one pool run, task p computes the column range p
+typedef struct {
+    const float *X;
+    const tcsc_t *W;
+    const float *B;
+    float a;
+    float *Y;
+    int M, N, K;
+    const int *bounds;
+} pool_args_t;
+
+template <bool PRELU>
+static void pool_task(void *arg, int task) {
+    const pool_args_t *args = (const pool_args_t*) arg;
+    sgemm_range<PRELU>((dense_t) args->X, args->W, (dense_t) args->B, args->a, args->Y,
+                       args->N, args->K, 0, args->M, args->bounds[task], args->bounds[task + 1]);
+}
+
+// partitions up to this many threads without touching the heap
+#define POOL_STACK_PARTS 64
+
+template <bool PRELU>
+static void sgemm_pool(
+    tpool_t *pool, const dense_t X, const tcsc_t* W, const dense_t B, float a, dense_t Y,
+    int M, int N, int K
+) {
+    int parts = tpool_threads(pool);
+    int stack_bounds[POOL_STACK_PARTS + 1];
+    int *bounds = stack_bounds;
+    if (parts > POOL_STACK_PARTS) {
+        bounds = (int*) malloc((parts + 1) * sizeof(int));
+        if (!bounds) {
+            perror("malloc failed @ sgemm_pool()");
+            exit(EXIT_FAILURE);
+        }
+    }
+    tcsc_partition_columns(W, parts, TCSC_PAR_ALIGN, bounds);
+
+    pool_args_t args = {X, W, B, a, Y, M, N, K, bounds};
+    tpool_run(pool, pool_task<PRELU>, &args, parts);
+
+    if (bounds != stack_bounds) free(bounds);
+}
+
+void tcsc_sgemm_pool(
+    tpool_t *pool, const dense_t X, const tcsc_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+) {
+    sgemm_pool<false>(pool, X, W, B, 0.0f, Y, M, N, K);
+}
+
+void tcsc_sgemm_prelu_pool(
+    tpool_t *pool, const dense_t X, const tcsc_t* W, const dense_t B, float a, dense_t Y,
+    int M, int N, int K
+) {
+    sgemm_pool<true>(pool, X, W, B, a, Y, M, N, K);
+}
+
+// Arguments of the scheduled tile executor
+typedef struct {
+    const float *X;
+    const tcsc_t *W;
+    const float *B;
+    float *Y;
+    int N, K;
+} sched_args_t;
+
+static void sched_tile(void *arg, const tsched_tile_t *tile) {
+    const sched_args_t *args = (const sched_args_t*) arg;
+    sgemm_range<false>((dense_t) args->X, args->W, (dense_t) args->B, 0.0f, args->Y,
+                       args->N, args->K, tile->m0, tile->m1, tile->n0, tile->n1);
+}
+
+void tcsc_sgemm_sched(
+    tpool_t *pool, const dense_t X, const tcsc_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K, tsched_mode_t mode, double *busy_ns
+) {
+    int ntiles;
+    tsched_tile_t *tiles = tsched_tiles(M, N, TSCHED_TILE_M, TSCHED_TILE_N, &ntiles);
+    long *cost = (long*) malloc(ntiles * sizeof(long));
+    if (!tiles || !cost) {
+        perror("malloc failed @ tcsc_sgemm_sched()");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < ntiles; ++i) {
+        long work = column_cost(W, tiles[i].n1) - column_cost(W, tiles[i].n0);
+        cost[i] = work * (tiles[i].m1 - tiles[i].m0);
+    }
+
+    sched_args_t args = {X, W, B, Y, N, K};
+    tsched_run(pool, tiles, cost, ntiles, mode, sched_tile, &args, busy_ns);
+
+    free(tiles);
+    free(cost);
+}
@@ -0,0 +1,82 @@
+#ifndef TCSC_PARALLEL_H
+#define TCSC_PARALLEL_H
+
+#include "../dense/dense.h"
+#include "tcsc.h"
+#include "tpool.h"
+#include "tsched.h"
+
+// Column partitions are aligned to this many columns (one 64 byte cache
+// line of Y) so that no two threads write the same line of a Y row
+#define TCSC_PAR_ALIGN 16
+// Minimum rows per thread before the M dimension is split as well
+#define TCSC_PAR_MIN_ROWS 16
+
+// Splits the N columns of W into parts contiguous ranges holding about the
+// same number of non-zeros, using the col_start_pos/col_start_neg prefix
+// sums. Boundaries except 0 and N are multiples of align. bounds must have
+// room for parts+1 elements, range p is [bounds[p], bounds[p+1]).
+void tcsc_partition_columns(const tcsc_t *W, int parts, int align, int *bounds);
+
+// Number of threads used by the parallel kernels, 0 (the default) means
+// all available threads. Without OpenMP the kernels always run serially.
+void tcsc_parallel_set_threads(int nthreads);
+int tcsc_parallel_threads(void);
+
+// How the parallel kernels distribute the work over the threads
+typedef enum {
+    TCSC_PAR_AUTO,    // split-K when N has too few aligned column ranges
+    TCSC_PAR_COLUMNS, // nnz-balanced column ranges, 2D for large M
+    TCSC_PAR_SPLIT_K  // every thread covers a K range of all columns
+} tcsc_par_mode_t;
+
+// nnz-balanced multithreaded kernels. Each thread computes a column range
+// of Y, when M is large the rows are split as well (2D M x N grid). These
+// use TCSC_PAR_AUTO, so narrow N falls back to split-K.
+void tcsc_sgemm_parallel(
+    const dense_t X, const tcsc_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+
+void tcsc_sgemm_prelu_parallel(
+    const dense_t X, const tcsc_t* W, const dense_t B, float a, dense_t Y,
+    int M, int N, int K
+);
+
+// Same as above with an explicit partitioning mode. In split-K mode every
+// thread accumulates its K range into a private M x N buffer, the buffers
+// are then folded pairwise in a parallel tree reduction before bias and
+// PReLU are applied. The buffers are cached per calling thread and only
+// reallocated when a call needs more than the previous ones.
+void tcsc_sgemm_parallel_mode(
+    const dense_t X, const tcsc_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K, tcsc_par_mode_t mode
+);
+
+void tcsc_sgemm_prelu_parallel_mode(
+    const dense_t X, const tcsc_t* W, const dense_t B, float a, dense_t Y,
+    int M, int N, int K, tcsc_par_mode_t mode
+);
+
+// Column-partitioned kernels on a persistent pool instead of an OpenMP
+// region, for calls too short to amortize the fork/join. Every thread of
+// the pool gets one nnz-balanced column range.
+void tcsc_sgemm_pool(
+    tpool_t *pool, const dense_t X, const tcsc_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+
+void tcsc_sgemm_prelu_pool(
+    tpool_t *pool, const dense_t X, const tcsc_t* W, const dense_t B, float a, dense_t Y,
+    int M, int N, int K
+);
+
+// Tiled kernel on the tile scheduler (TSCHED_TILE_M x TSCHED_TILE_N tiles,
+// cost = non-zeros of the tile columns times its rows). busy_ns may be
+// NULL, see tsched_run.
+void tcsc_sgemm_sched(
+    tpool_t *pool, const dense_t X, const tcsc_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K, tsched_mode_t mode, double *busy_ns
+);
+
+#endif
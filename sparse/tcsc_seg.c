@@ -0,0 +1,194 @@
+#include "tcsc_seg.h"
+#include <stdlib.h>
+#include <stdio.h>
+
+// Fills the panel-major offsets and panel-local indices of one sign
+template<typename index_t>
+static void fill_segments(
+    const int *col_start, const int *row_index, int cols, int seg_rows, int n_seg,
+    int *seg_start, index_t *seg_index
+) {
+    // count the entries of every (panel, column) pair
+    for (int i = 0; i <= n_seg * cols; ++i)
+        seg_start[i] = 0;
+    for (int j = 0; j < cols; ++j) {
+        for (int k = col_start[j]; k < col_start[j + 1]; ++k) {
+            int p = row_index[k] / seg_rows;
+            seg_start[p * cols + j + 1]++;
+        }
+    }
+    // prefix sum into offsets
+    for (int i = 0; i < n_seg * cols; ++i)
+        seg_start[i + 1] += seg_start[i];
+
+    // row indices are sorted within a column, so every (panel, column)
+    // range is filled in order by walking the column once
+    for (int j = 0; j < cols; ++j) {
+        for (int k = col_start[j]; k < col_start[j + 1]; ++k) {
+            int p = row_index[k] / seg_rows;
+            int pos = seg_start[p * cols + j]++;
+            seg_index[pos] = (index_t) (row_index[k] - p * seg_rows);
+        }
+    }
+    // the fill loop advanced every start to the next start, shift back
+    for (int i = n_seg * cols; i > 0; --i)
+        seg_start[i] = seg_start[i - 1];
+    seg_start[0] = 0;
+}
+
+tcsc_seg_t *tcsc_seg_from_tcsc(const tcsc_t *W, int seg_rows) {
+    if (seg_rows != TCSC_SEG_ROWS_U8 && seg_rows != TCSC_SEG_ROWS_U16)
+        return NULL;
+
+    tcsc_seg_t* sparse = (tcsc_seg_t*) calloc(1, sizeof(tcsc_seg_t));
+    if (!sparse) return NULL;
+
+    int n_seg = (W->rows + seg_rows - 1) / seg_rows;
+    sparse->rows = W->rows;
+    sparse->cols = W->cols;
+    sparse->seg_rows = seg_rows;
+    sparse->n_seg = n_seg;
+    sparse->n_elem_pos = W->n_elem_pos;
+    sparse->n_elem_neg = W->n_elem_neg;
+
+    sparse->seg_start_pos = (int*) malloc((n_seg * W->cols + 1) * sizeof(int));
+    sparse->seg_start_neg = (int*) malloc((n_seg * W->cols + 1) * sizeof(int));
+
+    // at least one element so that an empty sign is not a failed malloc
+    size_t n_pos = W->n_elem_pos > 0 ? W->n_elem_pos : 1;
+    size_t n_neg = W->n_elem_neg > 0 ? W->n_elem_neg : 1;
+    bool index_ok;
+    if (seg_rows == TCSC_SEG_ROWS_U8) {
+        sparse->row_index8_pos = (uint8_t*) malloc(n_pos * sizeof(uint8_t));
+        sparse->row_index8_neg = (uint8_t*) malloc(n_neg * sizeof(uint8_t));
+        index_ok = sparse->row_index8_pos && sparse->row_index8_neg;
+    } else {
+        sparse->row_index16_pos = (uint16_t*) malloc(n_pos * sizeof(uint16_t));
+        sparse->row_index16_neg = (uint16_t*) malloc(n_neg * sizeof(uint16_t));
+        index_ok = sparse->row_index16_pos && sparse->row_index16_neg;
+    }
+
+    if (!sparse->seg_start_pos || !sparse->seg_start_neg || !index_ok) {
+        tcsc_seg_free(sparse);
+        return NULL;
+    }
+
+    if (seg_rows == TCSC_SEG_ROWS_U8) {
+        fill_segments(W->col_start_pos, W->row_index_pos, W->cols, seg_rows, n_seg,
+                      sparse->seg_start_pos, sparse->row_index8_pos);
+        fill_segments(W->col_start_neg, W->row_index_neg, W->cols, seg_rows, n_seg,
+                      sparse->seg_start_neg, sparse->row_index8_neg);
+    } else {
+        fill_segments(W->col_start_pos, W->row_index_pos, W->cols, seg_rows, n_seg,
+                      sparse->seg_start_pos, sparse->row_index16_pos);
+        fill_segments(W->col_start_neg, W->row_index_neg, W->cols, seg_rows, n_seg,
+                      sparse->seg_start_neg, sparse->row_index16_neg);
+    }
+
+    return sparse;
+}
+
+// Packs rows [m0, m0 + rows) of the K panel starting at k0 into a
+// kb x mb block, zero padding the lanes past the last row
+static void pack_panel(const dense_t X, float *panel, int m0, int rows, int mb, int k0, int kb, int K) {
+    for (int k = 0; k < kb; ++k) {
+        for (int r = 0; r < mb; ++r) {
+            panel[(size_t) k * mb + r] = (r < rows) ? X[(size_t) (m0 + r) * K + k0 + k] : 0.0f;
+        }
+    }
+}
+
+// Panel-by-panel SGEMM, optionally applying PReLU during the last panel.
+// Each panel of mb rows of X is packed K-major, so the loops run over the
+// columns and their decoded local indices and every index adds a whole
+// vector of mb rows.
+template<typename index_t, bool prelu>
+static void seg_sgemm(
+    const dense_t X, const tcsc_seg_t* W, const index_t *index_pos, const index_t *index_neg,
+    const dense_t B, float a, dense_t Y, int M, int N, int K
+) {
+    const int mb = 8;
+    int panel_rows = (W->seg_rows < K) ? W->seg_rows : K;
+    float *panel;
+    if (posix_memalign((void**) &panel, 64, (size_t) panel_rows * mb * sizeof(float)) != 0) {
+        perror("posix_memalign failed @ seg_sgemm()");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int m0 = 0; m0 < M; m0 += mb) {
+        int rows = (M - m0 < mb) ? M - m0 : mb;
+        for (int r = 0; r < rows; ++r) {
+            float *y = Y + (size_t) (m0 + r) * N;
+            for (int n = 0; n < N; ++n) {
+                y[n] = B[n];
+            }
+        }
+
+        for (int p = 0; p < W->n_seg; ++p) {
+            int k0 = p * W->seg_rows;
+            int kb = (K - k0 < W->seg_rows) ? K - k0 : W->seg_rows;
+            pack_panel(X, panel, m0, rows, mb, k0, kb, K);
+            const int *start_pos = W->seg_start_pos + (size_t) p * N;
+            const int *start_neg = W->seg_start_neg + (size_t) p * N;
+            bool last = (p == W->n_seg - 1);
+
+            for (int n = 0; n < N; ++n) {
+                alignas(32) float acc[mb] = {0.0f};
+                for (int k = start_pos[n]; k < start_pos[n + 1]; ++k) {
+                    const float *x = panel + (size_t) index_pos[k] * mb;
+                    for (int r = 0; r < mb; ++r) acc[r] += x[r];
+                }
+                for (int k = start_neg[n]; k < start_neg[n + 1]; ++k) {
+                    const float *x = panel + (size_t) index_neg[k] * mb;
+                    for (int r = 0; r < mb; ++r) acc[r] -= x[r];
+                }
+                for (int r = 0; r < rows; ++r) {
+                    float val = Y[(size_t) (m0 + r) * N + n] + acc[r];
+                    if (prelu && last) {
+                        val = (val < 0.0f) ? a * val : val;
+                    }
+                    Y[(size_t) (m0 + r) * N + n] = val;
+                }
+            }
+        }
+    }
+    free(panel);
+}
+
+void tcsc_seg_sgemm(
+    const dense_t X, const tcsc_seg_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+) {
+    if (W->seg_rows == TCSC_SEG_ROWS_U8)
+        seg_sgemm<uint8_t, false>(X, W, W->row_index8_pos, W->row_index8_neg, B, 0.0f, Y, M, N, K);
+    else
+        seg_sgemm<uint16_t, false>(X, W, W->row_index16_pos, W->row_index16_neg, B, 0.0f, Y, M, N, K);
+}
+
+void tcsc_seg_sgemm_prelu(
+    const dense_t X, const tcsc_seg_t* W, const dense_t B, float a, dense_t Y,
+    int M, int N, int K
+) {
+    if (W->seg_rows == TCSC_SEG_ROWS_U8)
+        seg_sgemm<uint8_t, true>(X, W, W->row_index8_pos, W->row_index8_neg, B, a, Y, M, N, K);
+    else
+        seg_sgemm<uint16_t, true>(X, W, W->row_index16_pos, W->row_index16_neg, B, a, Y, M, N, K);
+}
+
+size_t tcsc_seg_bytes(const tcsc_seg_t *W) {
+    size_t index_size = (W->seg_rows == TCSC_SEG_ROWS_U8) ? sizeof(uint8_t) : sizeof(uint16_t);
+    size_t offsets = 2 * ((size_t) W->n_seg * W->cols + 1) * sizeof(int);
+    return offsets + ((size_t) W->n_elem_pos + W->n_elem_neg) * index_size;
+}
+
+void tcsc_seg_free(tcsc_seg_t *W) {
+    if (W) {
+        free(W->seg_start_pos);
+        free(W->seg_start_neg);
+        free(W->row_index8_pos);
+        free(W->row_index8_neg);
+        free(W->row_index16_pos);
+        free(W->row_index16_neg);
+        free(W);
+    }
+}
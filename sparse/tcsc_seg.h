@@ -0,0 +1,52 @@
+#ifndef TCSC_SEG_H
+#define TCSC_SEG_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "../dense/dense.h"
+#include "tcsc.h"
+
+// rows per K panel for 8- and 16-bit panel-local row indices
+#define TCSC_SEG_ROWS_U8  256
+#define TCSC_SEG_ROWS_U16 65536
+
+// K-segmented TCSC: K is split into panels of seg_rows rows and every
+// column stores the panel-local row indices of each panel separately
+typedef struct {
+    int rows, cols;
+    int seg_rows; // TCSC_SEG_ROWS_U8 or TCSC_SEG_ROWS_U16
+    int n_seg;    // number of K panels, ceil(rows / seg_rows)
+    int n_elem_pos; // number of matrix elements with value +1
+    int n_elem_neg; // number of matrix elements with value -1
+    // has n_seg*cols+1 many elements, panel-major: the entries of
+    // column n in panel p start at seg_start_*[p * cols + n]
+    int* seg_start_pos;
+    int* seg_start_neg;
+    // panel-local row indices (row - p * seg_rows), only the pair that
+    // matches seg_rows is allocated, the other one is NULL
+    uint8_t* row_index8_pos;
+    uint8_t* row_index8_neg;
+    uint16_t* row_index16_pos;
+    uint16_t* row_index16_neg;
+} tcsc_seg_t;
+
+tcsc_seg_t *tcsc_seg_from_tcsc(const tcsc_t *W, int seg_rows);
+
+// Iterates panel by panel, so one K panel of X stays in cache for all columns
+void tcsc_seg_sgemm(
+    const dense_t X, const tcsc_seg_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+
+// PReLU is applied while accumulating the last panel
+void tcsc_seg_sgemm_prelu(
+    const dense_t X, const tcsc_seg_t* W, const dense_t B, float a, dense_t Y,
+    int M, int N, int K
+);
+
+// Bytes occupied by the offsets and indices of the format
+size_t tcsc_seg_bytes(const tcsc_seg_t *W);
+
+void tcsc_seg_free(tcsc_seg_t *W);
+
+#endif
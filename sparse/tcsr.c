@@ -0,0 +1,385 @@
+#include "tcsr.h"
+#include "epilogue.h"
+#include <stdlib.h>
+#include <stdio.h>
+
+static float x_density_threshold = TCSR_X_DENSITY_THRESHOLD;
+
+// Allocates a tcsr_t with zeroed row starts
+static tcsr_t *tcsr_create(int rows, int cols, int n_elem_pos, int n_elem_neg) {
+    tcsr_t *W = (tcsr_t*) malloc(sizeof(tcsr_t));
+    if (!W) return NULL;
+
+    W->rows = rows;
+    W->cols = cols;
+    W->n_elem_pos = n_elem_pos;
+    W->n_elem_neg = n_elem_neg;
+    W->row_start_pos = (int*) calloc(rows + 1, sizeof(int));
+    W->row_start_neg = (int*) calloc(rows + 1, sizeof(int));
+    W->col_index_pos = (int*) malloc(n_elem_pos * sizeof(int));
+    W->col_index_neg = (int*) malloc(n_elem_neg * sizeof(int));
+
+    if (!W->row_start_pos || !W->row_start_neg ||
+        (!W->col_index_pos && n_elem_pos) || (!W->col_index_neg && n_elem_neg)) {
+        tcsr_free(W);
+        return NULL;
+    }
+    return W;
+}
+
+tcsr_t *tcsr_from_dense(dense_t dense, int rows, int cols) {
+    int n_elem_pos = 0, n_elem_neg = 0;
+    for (int i = 0; i < rows * cols; ++i) {
+        if (dense[i] == 1.0f)
+            n_elem_pos++;
+        else if (dense[i] == -1.0f)
+            n_elem_neg++;
+    }
+
+    tcsr_t *W = tcsr_create(rows, cols, n_elem_pos, n_elem_neg);
+    if (!W) return NULL;
+
+    int pos_counter = 0, neg_counter = 0;
+    for (int i = 0; i < rows; ++i) {
+        W->row_start_pos[i] = pos_counter;
+        W->row_start_neg[i] = neg_counter;
+        for (int j = 0; j < cols; ++j) {
+            float value = dense[i * cols + j];
+            if (value == 1.0f)
+                W->col_index_pos[pos_counter++] = j;
+            else if (value == -1.0f)
+                W->col_index_neg[neg_counter++] = j;
+        }
+    }
+    W->row_start_pos[rows] = pos_counter;
+    W->row_start_neg[rows] = neg_counter;
+    return W;
+}
+
+// Counting sort of the (row, col) pairs of one sign from column-major into
+// row-major order, columns stay ascending within a row
+static void transpose_index(
+    const int *col_start, const int *row_index, int rows, int cols,
+    int *row_start, int *col_index
+) {
+    for (int i = 0; i < col_start[cols]; ++i)
+        row_start[row_index[i] + 1]++;
+    for (int k = 0; k < rows; ++k)
+        row_start[k + 1] += row_start[k];
+
+    int *next = (int*) malloc(rows * sizeof(int));
+    if (!next) {
+        perror("malloc failed @ transpose_index()");
+        exit(EXIT_FAILURE);
+    }
+    for (int k = 0; k < rows; ++k)
+        next[k] = row_start[k];
+    for (int n = 0; n < cols; ++n)
+        for (int i = col_start[n]; i < col_start[n + 1]; ++i)
+            col_index[next[row_index[i]]++] = n;
+    free(next);
+}
+
+tcsr_t *tcsr_from_tcsc(const tcsc_t *W) {
+    tcsr_t *T = tcsr_create(W->rows, W->cols, W->n_elem_pos, W->n_elem_neg);
+    if (!T) return NULL;
+
+    transpose_index(W->col_start_pos, W->row_index_pos, W->rows, W->cols,
+                    T->row_start_pos, T->col_index_pos);
+    transpose_index(W->col_start_neg, W->row_index_neg, W->rows, W->cols,
+                    T->row_start_neg, T->col_index_neg);
+    return T;
+}
+
+void tcsr_sgemm_sparse_x(
+    const dense_t X, const tcsr_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+) {
+    for (int m = 0; m < M; ++m) {
+        float *y = Y + (size_t) m * N;
+        for (int n = 0; n < N; ++n)
+            y[n] = B[n];
+
+        for (int k = 0; k < K; ++k) {
+            float x = X[(size_t) m * K + k];
+            if (x == 0.0f) continue;
+
+            for (int i = W->row_start_pos[k]; i < W->row_start_pos[k + 1]; ++i)
+                y[W->col_index_pos[i]] += x;
+            for (int i = W->row_start_neg[k]; i < W->row_start_neg[k + 1]; ++i)
+                y[W->col_index_neg[i]] -= x;
+        }
+    }
+}
+
+template <class Epilogue>
+static void gemm_basic(
+    const dense_t X, const tcsr_t* W, dense_t Y, int M, int N, int K, const Epilogue &epi
+) {
+    for (int m = 0; m < M; ++m) {
+        float *y = Y + (size_t) m * N;
+        for (int n = 0; n < N; ++n)
+            y[n] = 0.0f;
+
+        for (int k = 0; k < K; ++k) {
+            float x = X[(size_t) m * K + k];
+            for (int i = W->row_start_pos[k]; i < W->row_start_pos[k + 1]; ++i)
+                y[W->col_index_pos[i]] += x;
+            for (int i = W->row_start_neg[k]; i < W->row_start_neg[k + 1]; ++i)
+                y[W->col_index_neg[i]] -= x;
+        }
+
+        // the epilogue reads each sum before its store overwrites it
+        for (int n = 0; n < N; ++n)
+            epi(y[n], m, n);
+    }
+}
+
+#ifdef __x86_64__
+#include <immintrin.h>
+
+// Copies rows m0 .. m0+rows of X into a k-major panel of mb floats per k,
+// zero padding the rows past the end
+static void pack_x_panel(const dense_t X, float *panel, int m0, int rows, int mb, int K) {
+    for (int k = 0; k < K; ++k) {
+        for (int r = 0; r < mb; ++r) {
+            panel[(size_t) k * mb + r] = (r < rows) ? X[(size_t) (m0 + r) * K + k] : 0.0f;
+        }
+    }
+}
+
+// Buffers of the SIMD kernels: the X panel, the Y accumulators of one
+// column block and per-row cursors into W. The column indices of a row are
+// ascending, so each column block resumes where the previous one stopped.
+typedef struct {
+    float *panel, *acc;
+    int *pos, *neg;
+    int nb;
+} panels_t;
+
+static panels_t panels_alloc(int N, int K, int mb) {
+    panels_t p;
+    p.nb = (N < TCSR_COL_BLOCK) ? N : TCSR_COL_BLOCK;
+    p.pos = (int*) malloc(2 * (size_t) K * sizeof(int));
+    if (!p.pos) {
+        perror("malloc failed @ panels_alloc()");
+        exit(EXIT_FAILURE);
+    }
+    p.neg = p.pos + K;
+    if (posix_memalign((void**) &p.panel, 64, (size_t) K * mb * sizeof(float)) != 0 ||
+        posix_memalign((void**) &p.acc, 64, (size_t) p.nb * mb * sizeof(float)) != 0) {
+        perror("posix_memalign failed @ panels_alloc()");
+        exit(EXIT_FAILURE);
+    }
+    return p;
+}
+
+static void panels_free(panels_t *p) {
+    free(p->pos);
+    free(p->panel);
+    free(p->acc);
+}
+
+static void reset_cursors(const tcsr_t *W, panels_t *p, int K) {
+    for (int k = 0; k < K; ++k) {
+        p->pos[k] = W->row_start_pos[k];
+        p->neg[k] = W->row_start_neg[k];
+    }
+}
+
+// Runs the columns n0 .. n1 of an N x mb accumulator panel (acc[j * mb + r]
+// for column n0 + j) through the epilogue, dropping padded rows
+template <class Epilogue>
+static inline void store_panel(
+    const float *acc, int mb, int m0, int rows, int n0, int n1, const Epilogue &epi
+) {
+    // 64 columns at a time, their accumulators stay in L1 across the rows
+    for (int c0 = n0; c0 < n1; c0 += 64) {
+        int c1 = (n1 - c0 < 64) ? n1 : c0 + 64;
+        for (int r = 0; r < rows; ++r)
+            for (int n = c0; n < c1; ++n)
+                epi(acc[(size_t) (n - n0) * mb + r], m0 + r, n);
+    }
+}
+
+template <class Epilogue>
+__attribute__((target("avx2")))
+static void gemm_avx2(
+    const dense_t X, const tcsr_t* W, int M, int N, int K, const Epilogue &epi
+) {
+    const int mb = 8;
+    panels_t p = panels_alloc(N, K, mb);
+
+    for (int m0 = 0; m0 < M; m0 += mb) {
+        int rows = (M - m0 < mb) ? M - m0 : mb;
+        pack_x_panel(X, p.panel, m0, rows, mb, K);
+        reset_cursors(W, &p, K);
+
+        for (int n0 = 0; n0 < N; n0 += p.nb) {
+            int n1 = (N - n0 < p.nb) ? N : n0 + p.nb;
+            for (int j = 0; j < n1 - n0; ++j)
+                _mm256_store_ps(&p.acc[j * mb], _mm256_setzero_ps());
+            float *y0 = p.acc - (size_t) n0 * mb;
+
+            for (int k = 0; k < K; ++k) {
+                __m256 x = _mm256_load_ps(&p.panel[(size_t) k * mb]);
+                int i = p.pos[k], end = W->row_start_pos[k + 1];
+                for (; i < end && W->col_index_pos[i] < n1; ++i) {
+                    float *y = y0 + (size_t) W->col_index_pos[i] * mb;
+                    _mm256_store_ps(y, _mm256_add_ps(_mm256_load_ps(y), x));
+                }
+                p.pos[k] = i;
+                i = p.neg[k], end = W->row_start_neg[k + 1];
+                for (; i < end && W->col_index_neg[i] < n1; ++i) {
+                    float *y = y0 + (size_t) W->col_index_neg[i] * mb;
+                    _mm256_store_ps(y, _mm256_sub_ps(_mm256_load_ps(y), x));
+                }
+                p.neg[k] = i;
+            }
+            store_panel(p.acc, mb, m0, rows, n0, n1, epi);
+        }
+    }
+    panels_free(&p);
+}
+
+template <class Epilogue>
+__attribute__((target("avx512f")))
+static void gemm_avx512(
+    const dense_t X, const tcsr_t* W, int M, int N, int K, const Epilogue &epi
+) {
+    const int mb = 16;
+    panels_t p = panels_alloc(N, K, mb);
+
+    for (int m0 = 0; m0 < M; m0 += mb) {
+        int rows = (M - m0 < mb) ? M - m0 : mb;
+        pack_x_panel(X, p.panel, m0, rows, mb, K);
+        reset_cursors(W, &p, K);
+
+        for (int n0 = 0; n0 < N; n0 += p.nb) {
+            int n1 = (N - n0 < p.nb) ? N : n0 + p.nb;
+            for (int j = 0; j < n1 - n0; ++j)
+                _mm512_store_ps(&p.acc[j * mb], _mm512_setzero_ps());
+            float *y0 = p.acc - (size_t) n0 * mb;
+
+            for (int k = 0; k < K; ++k) {
+                __m512 x = _mm512_load_ps(&p.panel[(size_t) k * mb]);
+                int i = p.pos[k], end = W->row_start_pos[k + 1];
+                for (; i < end && W->col_index_pos[i] < n1; ++i) {
+                    float *y = y0 + (size_t) W->col_index_pos[i] * mb;
+                    _mm512_store_ps(y, _mm512_add_ps(_mm512_load_ps(y), x));
+                }
+                p.pos[k] = i;
+                i = p.neg[k], end = W->row_start_neg[k + 1];
+                for (; i < end && W->col_index_neg[i] < n1; ++i) {
+                    float *y = y0 + (size_t) W->col_index_neg[i] * mb;
+                    _mm512_store_ps(y, _mm512_sub_ps(_mm512_load_ps(y), x));
+                }
+                p.neg[k] = i;
+            }
+            store_panel(p.acc, mb, m0, rows, n0, n1, epi);
+        }
+    }
+    panels_free(&p);
+}
+
+void tcsr_sgemm_avx2(
+    const dense_t X, const tcsr_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+) {
+    gemm_avx2(X, W, M, N, K, make_epilogue(ep_store_f32{Y, N}, ep_bias{B}));
+}
+
+void tcsr_sgemm_avx512(
+    const dense_t X, const tcsr_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+) {
+    gemm_avx512(X, W, M, N, K, make_epilogue(ep_store_f32{Y, N}, ep_bias{B}));
+}
+#endif
+
+template <class Epilogue>
+static void gemm_dispatch(
+    const dense_t X, const tcsr_t* W, dense_t Y, int M, int N, int K, const Epilogue &epi
+) {
+#ifdef __x86_64__
+    if (M >= 16 && __builtin_cpu_supports("avx512f")) {
+        gemm_avx512(X, W, M, N, K, epi);
+        return;
+    }
+    if (M >= 8 && __builtin_cpu_supports("avx2")) {
+        gemm_avx2(X, W, M, N, K, epi);
+        return;
+    }
+#endif
+    gemm_basic(X, W, Y, M, N, K, epi);
+}
+
+void tcsr_sgemm_basic(
+    const dense_t X, const tcsr_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+) {
+    gemm_basic(X, W, Y, M, N, K, make_epilogue(ep_store_f32{Y, N}, ep_bias{B}));
+}
+
+void tcsr_sgemm_prelu_basic(
+    const dense_t X, const tcsr_t* W, const dense_t B, float a, dense_t Y,
+    int M, int N, int K
+) {
+    gemm_basic(X, W, Y, M, N, K, make_epilogue(ep_store_f32{Y, N}, ep_bias{B}, ep_prelu{a}));
+}
+
+void tcsr_sgemm(
+    const dense_t X, const tcsr_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+) {
+    gemm_dispatch(X, W, Y, M, N, K, make_epilogue(ep_store_f32{Y, N}, ep_bias{B}));
+}
+
+void tcsr_sgemm_prelu(
+    const dense_t X, const tcsr_t* W, const dense_t B, float a, dense_t Y,
+    int M, int N, int K
+) {
+    gemm_dispatch(X, W, Y, M, N, K, make_epilogue(ep_store_f32{Y, N}, ep_bias{B}, ep_prelu{a}));
+}
+
+const char *tcsr_isa(int M) {
+#ifdef __x86_64__
+    if (M >= 16 && __builtin_cpu_supports("avx512f"))
+        return "avx512";
+    if (M >= 8 && __builtin_cpu_supports("avx2"))
+        return "avx2";
+#endif
+    return "scalar";
+}
+
+float tcsr_x_density(const dense_t X, int M, int K) {
+    size_t nnz = 0;
+    for (size_t i = 0; i < (size_t) M * K; ++i)
+        nnz += (X[i] != 0.0f);
+    return (float) nnz / ((float) M * K);
+}
+
+void tcsr_sgemm_auto(
+    const dense_t X, const tcsc_t* Wc, const tcsr_t* Wr, const dense_t B, dense_t Y,
+    int M, int N, int K
+) {
+    if (tcsr_x_density(X, M, K) < x_density_threshold) {
+        tcsr_sgemm_sparse_x(X, Wr, B, Y, M, N, K);
+    } else {
+        tcsc_sgemm_batched(X, Wc, B, Y, M, N, K);
+    }
+}
+
+void tcsr_set_x_density_threshold(float density) {
+    x_density_threshold = density;
+}
+
+void tcsr_free(tcsr_t *W) {
+    if (W) {
+        free(W->row_start_pos);
+        free(W->row_start_neg);
+        free(W->col_index_pos);
+        free(W->col_index_neg);
+        free(W);
+    }
+}
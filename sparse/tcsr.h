@@ -0,0 +1,104 @@
+#ifndef TCSR_H
+#define TCSR_H
+
+#include "../dense/dense.h"
+#include "tcsc.h"
+
+// Density of X below which tcsr_sgemm_auto picks the row-wise kernel until
+// tcsr_set_x_density_threshold is called with a measured crossover
+#define TCSR_X_DENSITY_THRESHOLD 0.1f
+// Columns of Y accumulated per pass of the SIMD kernels
+#ifndef TCSR_COL_BLOCK
+#define TCSR_COL_BLOCK 2048
+#endif
+
+// Ternary matrix in row-wise (CSR) order, the transpose of the tcsc_t
+// layout: row k lists the columns holding +1 and -1
+typedef struct {
+    int rows, cols;
+    int n_elem_pos; // number of matrix elements with value +1
+    int n_elem_neg; // number of matrix elements with value -1
+    // has rows+1 many elements
+    int* row_start_pos;
+    int* row_start_neg;
+    // has n_elem_pos many elements
+    int* col_index_pos;
+    // has n_elem_neg many elements
+    int* col_index_neg;
+} tcsr_t;
+
+tcsr_t *tcsr_from_dense(dense_t dense, int rows, int cols);
+
+// Same matrix as W, without going back through the dense form
+tcsr_t *tcsr_from_tcsc(const tcsc_t *W);
+
+// Y = XW + B skipping zero activations: each non-zero X[m, k] is added to
+// (subtracted from) the Y[m, :] entries listed in row k of W. The work is
+// proportional to the non-zeros of X instead of K.
+void tcsr_sgemm_sparse_x(
+    const dense_t X, const tcsr_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+
+// Input-stationary (outer product) dataflow: every X[m, k] is broadcast and
+// added to (subtracted from) the Y[m, :] entries listed in row k of W,
+// instead of reducing a column of W per output as the TCSC kernels do.
+void tcsr_sgemm_basic(
+    const dense_t X, const tcsr_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+
+void tcsr_sgemm_prelu_basic(
+    const dense_t X, const tcsr_t* W, const dense_t B, float a, dense_t Y,
+    int M, int N, int K
+);
+
+// SIMD kernels vectorized across M: a panel of 8/16 rows of X is packed
+// k-major so that X[m0 .. m0+mb, k] is one vector, and Y is accumulated
+// as an N x mb panel, TCSR_COL_BLOCK columns at a time so that the block
+// stays in L2. Correct for any M, padded rows are dropped at the store.
+#ifdef __x86_64__
+void tcsr_sgemm_avx2(
+    const dense_t X, const tcsr_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+
+void tcsr_sgemm_avx512(
+    const dense_t X, const tcsr_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+#endif
+
+// Picks the widest SIMD kernel the CPU and M allow at runtime (M >= 16 for
+// AVX-512, M >= 8 for AVX2), tcsr_sgemm_basic otherwise
+void tcsr_sgemm(
+    const dense_t X, const tcsr_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+
+// Same dispatch with PReLU fused into the store
+void tcsr_sgemm_prelu(
+    const dense_t X, const tcsr_t* W, const dense_t B, float a, dense_t Y,
+    int M, int N, int K
+);
+
+// Name of the instruction set tcsr_sgemm dispatches to for M rows
+const char *tcsr_isa(int M);
+
+// Fraction of non-zero entries in the M x K matrix X
+float tcsr_x_density(const dense_t X, int M, int K);
+
+// Measures the density of X and runs tcsr_sgemm_sparse_x on Wr below the
+// threshold, tcsc_sgemm_batched on Wc otherwise. Wc and Wr hold the same
+// matrix.
+void tcsr_sgemm_auto(
+    const dense_t X, const tcsc_t* Wc, const tcsr_t* Wr, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+
+// Sets the crossover density of X, e.g. from a benchmark sweep
+void tcsr_set_x_density_threshold(float density);
+
+void tcsr_free(tcsr_t *W);
+
+#endif
@@ -0,0 +1,274 @@
+#include "tdense8.h"
+#include "epilogue.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+static float min_density = TDENSE8_MIN_DENSITY;
+
+tdense8_t *tdense8_from_dense(dense_t dense, int rows, int cols) {
+    tdense8_t *W = (tdense8_t*) malloc(sizeof(tdense8_t));
+    if (!W) return NULL;
+
+    W->rows = rows;
+    W->cols = cols;
+    W->quads = (rows + 3) / 4;
+    W->cols_pad = (cols + TDENSE8_COL_BLOCK - 1) / TDENSE8_COL_BLOCK * TDENSE8_COL_BLOCK;
+
+    size_t bytes = (size_t) W->quads * W->cols_pad * 4;
+    if (posix_memalign((void**) &W->values, 64, bytes) != 0) W->values = NULL;
+    W->col_sum = (int32_t*) malloc(cols * sizeof(int32_t));
+    if (!W->values || !W->col_sum) {
+        free(W->values);
+        free(W->col_sum);
+        free(W);
+        return NULL;
+    }
+    memset(W->values, 0, bytes);
+    memset(W->col_sum, 0, cols * sizeof(int32_t));
+
+    for (int k = 0; k < rows; ++k) {
+        for (int n = 0; n < cols; ++n) {
+            float value = dense[k * cols + n];
+            int8_t w = (value == 1.0f) ? 1 : ((value == -1.0f) ? -1 : 0);
+            W->values[((size_t) (k / 4) * W->cols_pad + n) * 4 + k % 4] = w;
+            W->col_sum[n] += w;
+        }
+    }
+    return W;
+}
+
+// Dequantizes a 4 x nc tile of integer dot products with leading dimension
+// TDENSE8_COL_BLOCK through the epilogue, skipping padded rows and columns
+template <class Epilogue>
+static inline void store_tile(
+    const int32_t *tile, const tdense8_t *W, tcsc_qparams_t xq,
+    int m0, int M, int n0, int nc, const Epilogue &epi
+) {
+    int rows = (M - m0 < 4) ? M - m0 : 4;
+    int cols = (W->cols - n0 < nc) ? W->cols - n0 : nc;
+    for (int r = 0; r < rows; ++r) {
+        for (int j = 0; j < cols; ++j) {
+            int n = n0 + j;
+            int32_t sum = tile[r * TDENSE8_COL_BLOCK + j] - (128 + xq.zero_point) * W->col_sum[n];
+            epi(xq.scale * (float) sum, m0 + r, n);
+        }
+    }
+}
+
+static void gemm_scalar(
+    const int8_t *X, tcsc_qparams_t xq, const tdense8_t *W, const dense_t B, dense_t Y,
+    int M, int N, int K
+) {
+    for (int m = 0; m < M; ++m) {
+        const int8_t *x = X + (size_t) m * K;
+        for (int n = 0; n < N; ++n) {
+            int32_t acc = 0;
+            for (int k = 0; k < K; ++k) {
+                acc += x[k] * W->values[((size_t) (k / 4) * W->cols_pad + n) * 4 + k % 4];
+            }
+            Y[m * N + n] = xq.scale * (float) (acc - xq.zero_point * W->col_sum[n]) + B[n];
+        }
+    }
+}
+
+#ifdef __x86_64__
+#include <immintrin.h>
+
+// Copies X into 32-bit words of 4 uint8 (x + 128), one row of W->quads words
+// per row of X, padding K to whole quads and M to a multiple of 4 with
+// zeros (the matching W rows are zero, padded rows are never stored)
+static uint32_t *pack_x_u8(const int8_t *X, const tdense8_t *W, int M, int K) {
+    int m_pad = (M + 3) / 4 * 4;
+    uint32_t *Xu = (uint32_t*) calloc((size_t) m_pad * W->quads, sizeof(uint32_t));
+    if (!Xu) {
+        perror("calloc failed @ pack_x_u8()");
+        exit(EXIT_FAILURE);
+    }
+    for (int m = 0; m < M; ++m) {
+        uint8_t *row = (uint8_t*) (Xu + (size_t) m * W->quads);
+        for (int k = 0; k < K; ++k) {
+            row[k] = (uint8_t) (X[(size_t) m * K + k] ^ 0x80);
+        }
+    }
+    return Xu;
+}
+
+__attribute__((target("avx512f,avx512vnni")))
+void tdense8_gemm_s8_avx512vnni(
+    const int8_t *X, tcsc_qparams_t xq, const tdense8_t *W, const dense_t B, dense_t Y,
+    int M, int N, int K
+) {
+    const int quads = W->quads;
+    uint32_t *Xu = pack_x_u8(X, W, M, K);
+    auto epi = make_epilogue(ep_store_f32{Y, N}, ep_bias{B});
+    alignas(64) int32_t tile[4 * TDENSE8_COL_BLOCK];
+
+    // a 64 column block of W is reused from L2 by all row blocks
+    for (int n0 = 0; n0 < W->cols_pad; n0 += 64) {
+        for (int m0 = 0; m0 < M; m0 += 4) {
+            const int *x = (const int*) Xu + (size_t) m0 * quads;
+            __m512i acc[4][4];
+            for (int r = 0; r < 4; ++r)
+                for (int v = 0; v < 4; ++v)
+                    acc[r][v] = _mm512_setzero_si512();
+
+            for (int q = 0; q < quads; ++q) {
+                const int8_t *w = W->values + ((size_t) q * W->cols_pad + n0) * 4;
+                __m512i w0 = _mm512_load_si512(w);
+                __m512i w1 = _mm512_load_si512(w + 64);
+                __m512i w2 = _mm512_load_si512(w + 128);
+                __m512i w3 = _mm512_load_si512(w + 192);
+                for (int r = 0; r < 4; ++r) {
+                    __m512i xb = _mm512_set1_epi32(x[r * quads + q]);
+                    acc[r][0] = _mm512_dpbusd_epi32(acc[r][0], xb, w0);
+                    acc[r][1] = _mm512_dpbusd_epi32(acc[r][1], xb, w1);
+                    acc[r][2] = _mm512_dpbusd_epi32(acc[r][2], xb, w2);
+                    acc[r][3] = _mm512_dpbusd_epi32(acc[r][3], xb, w3);
+                }
+            }
+
+            for (int r = 0; r < 4; ++r)
+                for (int v = 0; v < 4; ++v)
+                    _mm512_store_si512(&tile[r * TDENSE8_COL_BLOCK + v * 16], acc[r][v]);
+            store_tile(tile, W, xq, m0, M, n0, 64, epi);
+        }
+    }
+    free(Xu);
+}
+
+// 256-bit kernels: 4 rows x 16 columns, 8 accumulators fit next to the W
+// vectors in the 16 ymm registers
+__attribute__((target("avx2,avxvnni")))
+void tdense8_gemm_s8_avxvnni(
+    const int8_t *X, tcsc_qparams_t xq, const tdense8_t *W, const dense_t B, dense_t Y,
+    int M, int N, int K
+) {
+    const int quads = W->quads;
+    uint32_t *Xu = pack_x_u8(X, W, M, K);
+    auto epi = make_epilogue(ep_store_f32{Y, N}, ep_bias{B});
+    alignas(32) int32_t tile[4 * TDENSE8_COL_BLOCK];
+
+    for (int n0 = 0; n0 < W->cols_pad; n0 += 16) {
+        for (int m0 = 0; m0 < M; m0 += 4) {
+            const int *x = (const int*) Xu + (size_t) m0 * quads;
+            __m256i acc[4][2];
+            for (int r = 0; r < 4; ++r)
+                acc[r][0] = acc[r][1] = _mm256_setzero_si256();
+
+            for (int q = 0; q < quads; ++q) {
+                const int8_t *w = W->values + ((size_t) q * W->cols_pad + n0) * 4;
+                __m256i w0 = _mm256_load_si256((const __m256i*) w);
+                __m256i w1 = _mm256_load_si256((const __m256i*) (w + 32));
+                for (int r = 0; r < 4; ++r) {
+                    __m256i xb = _mm256_set1_epi32(x[r * quads + q]);
+                    acc[r][0] = _mm256_dpbusd_avx_epi32(acc[r][0], xb, w0);
+                    acc[r][1] = _mm256_dpbusd_avx_epi32(acc[r][1], xb, w1);
+                }
+            }
+
+            for (int r = 0; r < 4; ++r) {
+                _mm256_store_si256((__m256i*) &tile[r * TDENSE8_COL_BLOCK], acc[r][0]);
+                _mm256_store_si256((__m256i*) &tile[r * TDENSE8_COL_BLOCK + 8], acc[r][1]);
+            }
+            store_tile(tile, W, xq, m0, M, n0, 16, epi);
+        }
+    }
+    free(Xu);
+}
+
+__attribute__((target("avx2")))
+void tdense8_gemm_s8_avx2(
+    const int8_t *X, tcsc_qparams_t xq, const tdense8_t *W, const dense_t B, dense_t Y,
+    int M, int N, int K
+) {
+    const int quads = W->quads;
+    uint32_t *Xu = pack_x_u8(X, W, M, K);
+    auto epi = make_epilogue(ep_store_f32{Y, N}, ep_bias{B});
+    alignas(32) int32_t tile[4 * TDENSE8_COL_BLOCK];
+    const __m256i ones = _mm256_set1_epi16(1);
+
+    for (int n0 = 0; n0 < W->cols_pad; n0 += 16) {
+        for (int m0 = 0; m0 < M; m0 += 4) {
+            const int *x = (const int*) Xu + (size_t) m0 * quads;
+            __m256i acc[4][2];
+            for (int r = 0; r < 4; ++r)
+                acc[r][0] = acc[r][1] = _mm256_setzero_si256();
+
+            for (int q = 0; q < quads; ++q) {
+                const int8_t *w = W->values + ((size_t) q * W->cols_pad + n0) * 4;
+                __m256i w0 = _mm256_load_si256((const __m256i*) w);
+                __m256i w1 = _mm256_load_si256((const __m256i*) (w + 32));
+                for (int r = 0; r < 4; ++r) {
+                    __m256i xb = _mm256_set1_epi32(x[r * quads + q]);
+                    // pairs of u8 * s8 products into int16, then pairs of
+                    // int16 into the int32 lane of the quad
+                    __m256i p0 = _mm256_madd_epi16(_mm256_maddubs_epi16(xb, w0), ones);
+                    __m256i p1 = _mm256_madd_epi16(_mm256_maddubs_epi16(xb, w1), ones);
+                    acc[r][0] = _mm256_add_epi32(acc[r][0], p0);
+                    acc[r][1] = _mm256_add_epi32(acc[r][1], p1);
+                }
+            }
+
+            for (int r = 0; r < 4; ++r) {
+                _mm256_store_si256((__m256i*) &tile[r * TDENSE8_COL_BLOCK], acc[r][0]);
+                _mm256_store_si256((__m256i*) &tile[r * TDENSE8_COL_BLOCK + 8], acc[r][1]);
+            }
+            store_tile(tile, W, xq, m0, M, n0, 16, epi);
+        }
+    }
+    free(Xu);
+}
+#endif
+
+// Runtime dispatch on CPUID
+void tdense8_gemm_s8(
+    const int8_t *X, tcsc_qparams_t xq, const tdense8_t *W, const dense_t B, dense_t Y,
+    int M, int N, int K
+) {
+#ifdef __x86_64__
+    if (__builtin_cpu_supports("avx512vnni")) {
+        tdense8_gemm_s8_avx512vnni(X, xq, W, B, Y, M, N, K);
+        return;
+    }
+    if (__builtin_cpu_supports("avxvnni")) {
+        tdense8_gemm_s8_avxvnni(X, xq, W, B, Y, M, N, K);
+        return;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        tdense8_gemm_s8_avx2(X, xq, W, B, Y, M, N, K);
+        return;
+    }
+#endif
+    gemm_scalar(X, xq, W, B, Y, M, N, K);
+}
+
+const char *tdense8_isa(void) {
+#ifdef __x86_64__
+    if (__builtin_cpu_supports("avx512vnni"))
+        return "avx512vnni";
+    if (__builtin_cpu_supports("avxvnni"))
+        return "avxvnni";
+    if (__builtin_cpu_supports("avx2"))
+        return "avx2";
+#endif
+    return "scalar";
+}
+
+bool tdense8_preferred(long nnz, int K, int N) {
+    // the scalar fallback never beats the index based kernels
+    if (strcmp(tdense8_isa(), "scalar") == 0) return false;
+    return (double) nnz >= (double) min_density * K * N;
+}
+
+void tdense8_set_min_density(float density) {
+    min_density = density;
+}
+
+void tdense8_free(tdense8_t *W) {
+    if (W) {
+        free(W->values);
+        free(W->col_sum);
+        free(W);
+    }
+}
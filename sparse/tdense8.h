@@ -0,0 +1,76 @@
+#ifndef TDENSE8_H
+#define TDENSE8_H
+
+#include <stdint.h>
+#include "../dense/dense.h"
+#include "tcsc.h"
+#include "tcsc_int.h"
+
+// Columns are padded to a multiple of this (4 AVX-512 vectors of int32)
+#define TDENSE8_COL_BLOCK 64
+// Density of W above which tdense8_preferred picks the dense kernel until
+// tdense8_set_min_density is called with a measured crossover
+#define TDENSE8_MIN_DENSITY 0.25f
+
+// Dense ternary matrix as packed int8 {-1, 0, +1} for dot-product
+// instructions: the 4 entries W[4q .. 4q+3, n] form one 32-bit word, and
+// the words of quad q are stored for all columns in a row so that a vector
+// holds consecutive columns of one quad.
+typedef struct {
+    int rows, cols;
+    int quads;     // ceil(rows / 4), rows past the end are zero
+    int cols_pad;  // cols rounded up to TDENSE8_COL_BLOCK, zero padded
+    // has quads * cols_pad * 4 elements, word (q, n) at (q * cols_pad + n) * 4
+    int8_t* values;
+    // has cols elements: number of +1 minus number of -1 entries
+    int32_t* col_sum;
+} tdense8_t;
+
+// Packs the same dense {-1, 0, +1} matrix tcsc_from_dense consumes
+tdense8_t *tdense8_from_dense(dense_t dense, int rows, int cols);
+
+// Y = XW + B for int8 X quantized with xq (see tcsc_int.h). X is offset to
+// uint8 (x + 128) for the unsigned operand of the dot products, the offset
+// and the zero point are removed once per output as
+// (128 + x_zero) * col_sum[n]. Rows of X are processed 4 at a time
+// against 64 columns.
+#ifdef __x86_64__
+// vpdpbusd on 512-bit vectors
+void tdense8_gemm_s8_avx512vnni(
+    const int8_t *X, tcsc_qparams_t xq, const tdense8_t *W, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+
+// vpdpbusd on 256-bit vectors (VEX encoded AVX-VNNI)
+void tdense8_gemm_s8_avxvnni(
+    const int8_t *X, tcsc_qparams_t xq, const tdense8_t *W, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+
+// vpmaddubsw + vpmaddwd, exact since |x * w| <= 255 cannot saturate
+void tdense8_gemm_s8_avx2(
+    const int8_t *X, tcsc_qparams_t xq, const tdense8_t *W, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+#endif
+
+// Picks the widest dot-product kernel supported by the CPU at runtime, a
+// scalar loop otherwise
+void tdense8_gemm_s8(
+    const int8_t *X, tcsc_qparams_t xq, const tdense8_t *W, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+
+// Name of the instruction set tdense8_gemm_s8 dispatches to
+const char *tdense8_isa(void);
+
+// Crossover against the int8 TCSC kernel: true if a K x N ternary matrix
+// with nnz non-zeros should use the dense kernel
+bool tdense8_preferred(long nnz, int K, int N);
+
+// Sets the crossover density, e.g. from a benchmark sweep
+void tdense8_set_min_density(float density);
+
+void tdense8_free(tdense8_t *W);
+
+#endif
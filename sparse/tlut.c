@@ -0,0 +1,243 @@
+#include "tlut.h"
+#include <stdlib.h>
+#include <stdio.h>
+
+static tlut_t *tlut_alloc(int rows, int cols, int g) {
+    if (g < TLUT_MIN_GROUP || g > TLUT_MAX_GROUP)
+        return NULL;
+
+    tlut_t* sparse = (tlut_t*) malloc(sizeof(tlut_t));
+    if (!sparse) return NULL;
+
+    sparse->rows = rows;
+    sparse->cols = cols;
+    sparse->g = g;
+    sparse->n_groups = (rows + g - 1) / g;
+    sparse->code = (uint8_t*) calloc((size_t) sparse->n_groups * cols, sizeof(uint8_t));
+
+    if (!sparse->code) {
+        free(sparse);
+        return NULL;
+    }
+    return sparse;
+}
+
+tlut_t *tlut_from_dense(dense_t dense, int rows, int cols, int g) {
+    tlut_t* sparse = tlut_alloc(rows, cols, g);
+    if (!sparse) return NULL;
+
+    for (int i = 0; i < rows; ++i) {
+        for (int j = 0; j < cols; ++j) {
+            float value = dense[i * cols + j];
+            uint8_t *code = &sparse->code[(size_t) (i / g) * cols + j];
+            if (value == 1.0f)
+                *code |= 1 << (i % g);
+            else if (value == -1.0f)
+                *code |= 1 << (4 + i % g);
+        }
+    }
+    return sparse;
+}
+
+tlut_t *tlut_from_tcsc(const tcsc_t *W, int g) {
+    tlut_t* sparse = tlut_alloc(W->rows, W->cols, g);
+    if (!sparse) return NULL;
+
+    for (int j = 0; j < W->cols; ++j) {
+        for (int k = W->col_start_pos[j]; k < W->col_start_pos[j + 1]; ++k) {
+            int i = W->row_index_pos[k];
+            sparse->code[(size_t) (i / g) * W->cols + j] |= 1 << (i % g);
+        }
+        for (int k = W->col_start_neg[j]; k < W->col_start_neg[j + 1]; ++k) {
+            int i = W->row_index_neg[k];
+            sparse->code[(size_t) (i / g) * W->cols + j] |= 1 << (4 + i % g);
+        }
+    }
+    return sparse;
+}
+
+// Builds the subset-sum tables of one row x of X: table[j * 16 + s] is the
+// sum of the X values of group j selected by the bits of s. Rows past K
+// count as zero, entries s >= 2^g stay unused.
+static void build_tables(const float *x, float *table, int g, int n_groups, int K) {
+    for (int j = 0; j < n_groups; ++j) {
+        float xg[TLUT_MAX_GROUP];
+        for (int r = 0; r < g; ++r) {
+            int k = j * g + r;
+            xg[r] = (k < K) ? x[k] : 0.0f;
+        }
+        float *t = table + (size_t) j * TLUT_TABLE_SIZE;
+        t[0] = 0.0f;
+        for (int s = 1; s < (1 << g); ++s) {
+            // extend the subset without its lowest bit by that bit's value
+            t[s] = t[s & (s - 1)] + xg[__builtin_ctz(s)];
+        }
+        for (int s = 1 << g; s < TLUT_TABLE_SIZE; ++s) {
+            t[s] = 0.0f;
+        }
+    }
+}
+
+static float *alloc_tables(int n_groups, const char *caller) {
+    float *table;
+    if (posix_memalign((void**) &table, 64, (size_t) n_groups * TLUT_TABLE_SIZE * sizeof(float)) != 0) {
+        char msg[64];
+        snprintf(msg, sizeof(msg), "posix_memalign failed @ %s()", caller);
+        perror(msg);
+        exit(EXIT_FAILURE);
+    }
+    return table;
+}
+
+// Scalar lookup of the columns [n0, N) of one row
+static void lookup_columns(
+    const float *table, const tlut_t* W, const dense_t B, float *y, int n0, int N
+) {
+    for (int n = n0; n < N; ++n) {
+        float acc = B[n];
+        for (int j = 0; j < W->n_groups; ++j) {
+            uint8_t c = W->code[(size_t) j * N + n];
+            const float *t = table + (size_t) j * TLUT_TABLE_SIZE;
+            acc += t[c & 0xf] - t[c >> 4];
+        }
+        y[n] = acc;
+    }
+}
+
+// Basic lookup-table SGEMM
+void tlut_sgemm_basic(
+    const dense_t X, const tlut_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+) {
+    float *table = alloc_tables(W->n_groups, "tlut_sgemm_basic");
+    for (int m = 0; m < M; ++m) {
+        build_tables(X + (size_t) m * K, table, W->g, W->n_groups, K);
+        lookup_columns(table, W, B, Y + (size_t) m * N, 0, N);
+    }
+    free(table);
+}
+
+size_t tlut_bytes(const tlut_t *W) {
+    return (size_t) W->n_groups * W->cols * sizeof(uint8_t);
+}
+
+double tlut_bits_per_weight(const tlut_t *W) {
+    return 8.0 * tlut_bytes(W) / ((double) W->rows * W->cols);
+}
+
+void tlut_free(tlut_t *W) {
+    if (W) {
+        free(W->code);
+        free(W);
+    }
+}
+
+#ifdef __x86_64__
+#include <immintrin.h>
+
+// AVX2 lookup-table SGEMM, 8 columns per step
+__attribute__((target("avx2")))
+void tlut_sgemm_avx2(
+    const dense_t X, const tlut_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+) {
+    float *table = alloc_tables(W->n_groups, "tlut_sgemm_avx2");
+    const __m256i nibble = _mm256_set1_epi32(0xf);
+    // with g <= 3 all subset sums fit into the lower 8 table entries
+    bool two_halves = W->g > 3;
+
+    for (int m = 0; m < M; ++m) {
+        build_tables(X + (size_t) m * K, table, W->g, W->n_groups, K);
+        float *y = Y + (size_t) m * N;
+
+        int n = 0;
+        for (; n + 8 <= N; n += 8) {
+            __m256 acc = _mm256_loadu_ps(&B[n]);
+            for (int j = 0; j < W->n_groups; ++j) {
+                const float *t = table + (size_t) j * TLUT_TABLE_SIZE;
+                __m128i c8 = _mm_loadl_epi64((const __m128i*) &W->code[(size_t) j * N + n]);
+                __m256i c = _mm256_cvtepu8_epi32(c8);
+                __m256i p = _mm256_and_si256(c, nibble);
+                __m256i q = _mm256_srli_epi32(c, 4);
+
+                __m256 t_lo = _mm256_load_ps(t);
+                __m256 vp = _mm256_permutevar8x32_ps(t_lo, p);
+                __m256 vq = _mm256_permutevar8x32_ps(t_lo, q);
+                if (two_halves) {
+                    // bit 3 of the code selects the upper half of the table
+                    __m256 t_hi = _mm256_load_ps(t + 8);
+                    vp = _mm256_blendv_ps(vp, _mm256_permutevar8x32_ps(t_hi, p),
+                                          _mm256_castsi256_ps(_mm256_slli_epi32(p, 28)));
+                    vq = _mm256_blendv_ps(vq, _mm256_permutevar8x32_ps(t_hi, q),
+                                          _mm256_castsi256_ps(_mm256_slli_epi32(q, 28)));
+                }
+                acc = _mm256_add_ps(acc, _mm256_sub_ps(vp, vq));
+            }
+            _mm256_storeu_ps(&y[n], acc);
+        }
+        lookup_columns(table, W, B, y, n, N);
+    }
+    free(table);
+}
+
+// AVX-512 lookup-table SGEMM, 16 columns per step
+__attribute__((target("avx512f")))
+void tlut_sgemm_avx512(
+    const dense_t X, const tlut_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+) {
+    float *table = alloc_tables(W->n_groups, "tlut_sgemm_avx512");
+    const __m512i nibble = _mm512_set1_epi32(0xf);
+
+    for (int m = 0; m < M; ++m) {
+        build_tables(X + (size_t) m * K, table, W->g, W->n_groups, K);
+        float *y = Y + (size_t) m * N;
+
+        int n = 0;
+        for (; n + 16 <= N; n += 16) {
+            __m512 acc0 = _mm512_loadu_ps(&B[n]);
+            __m512 acc1 = _mm512_setzero_ps();
+            for (int j = 0; j < W->n_groups; ++j) {
+                // the whole 16-entry table fits one register
+                __m512 t = _mm512_load_ps(table + (size_t) j * TLUT_TABLE_SIZE);
+                __m128i c8 = _mm_loadu_si128((const __m128i*) &W->code[(size_t) j * N + n]);
+                __m512i c = _mm512_cvtepu8_epi32(c8);
+                __m512i p = _mm512_and_si512(c, nibble);
+                __m512i q = _mm512_srli_epi32(c, 4);
+                acc0 = _mm512_add_ps(acc0, _mm512_permutexvar_ps(p, t));
+                acc1 = _mm512_sub_ps(acc1, _mm512_permutexvar_ps(q, t));
+            }
+            _mm512_storeu_ps(&y[n], _mm512_add_ps(acc0, acc1));
+        }
+        lookup_columns(table, W, B, y, n, N);
+    }
+    free(table);
+}
+#endif
+
+void tlut_sgemm(
+    const dense_t X, const tlut_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+) {
+#ifdef __x86_64__
+    if (__builtin_cpu_supports("avx512f")) {
+        tlut_sgemm_avx512(X, W, B, Y, M, N, K);
+        return;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        tlut_sgemm_avx2(X, W, B, Y, M, N, K);
+        return;
+    }
+#endif
+    tlut_sgemm_basic(X, W, B, Y, M, N, K);
+}
+
+int tlut_preferred_group(void) {
+#ifdef __x86_64__
+    if (__builtin_cpu_supports("avx512f"))
+        return 4;
+    if (__builtin_cpu_supports("avx2"))
+        return 3;
+#endif
+    return TLUT_MAX_GROUP;
+}
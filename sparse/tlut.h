@@ -0,0 +1,71 @@
+#ifndef TLUT_H
+#define TLUT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "../dense/dense.h"
+#include "tcsc.h"
+
+// supported number of rows per lookup group
+#define TLUT_MIN_GROUP 2
+#define TLUT_MAX_GROUP 4
+// table entries per group, 2^TLUT_MAX_GROUP subset sums
+#define TLUT_TABLE_SIZE 16
+
+// Packed ternary format for the lookup-table kernels: every group of g
+// consecutive rows of a column is one byte holding a +1 and a -1 bit per
+// row. A code is one byte whatever g is, so a weight costs 8 / g bits:
+// 4 for g = 2, 2.67 for g = 3 and 2 only for g = 4.
+typedef struct {
+    int rows, cols;
+    int g;        // rows per group, TLUT_MIN_GROUP..TLUT_MAX_GROUP
+    int n_groups; // ceil(rows / g)
+    // has n_groups*cols many elements, group-major: the code of group j of
+    // column n is code[j * cols + n], the low nibble holds the g-bit mask
+    // of the +1 rows and the high nibble the mask of the -1 rows
+    uint8_t* code;
+} tlut_t;
+
+tlut_t *tlut_from_dense(dense_t dense, int rows, int cols, int g);
+tlut_t *tlut_from_tcsc(const tcsc_t *W, int g);
+
+// For every row of X the subset sums of each group of g X values are
+// tabulated once, each group of a column then costs two table lookups
+// (+1 subset minus -1 subset) instead of up to g adds
+void tlut_sgemm_basic(
+    const dense_t X, const tlut_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+
+// SIMD kernels looking up 8 (vpermps) or 16 (vpermps zmm) columns at once
+#ifdef __x86_64__
+void tlut_sgemm_avx2(
+    const dense_t X, const tlut_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+
+void tlut_sgemm_avx512(
+    const dense_t X, const tlut_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+#endif
+
+// Runtime dispatch to the widest SIMD kernel, tlut_sgemm_basic otherwise
+void tlut_sgemm(
+    const dense_t X, const tlut_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+
+// Group size that suits the lookup instructions of the CPU: 4 when a whole
+// 16-entry table fits one AVX-512 register, 3 for the 8-entry AVX2 permute
+int tlut_preferred_group(void);
+
+// Bytes occupied by the packed codes
+size_t tlut_bytes(const tlut_t *W);
+
+// Storage bits per weight of W, 8 / g plus the padding of the last group
+double tlut_bits_per_weight(const tlut_t *W);
+
+void tlut_free(tlut_t *W);
+
+#endif
@@ -0,0 +1,214 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+#ifdef __x86_64__
+#include <immintrin.h>
+#endif
+#include "tpool.h"
+
+// One published run. claim packs the low 32 bits of the run sequence
+// number with the next unclaimed task index, so a worker that still holds
+// an old sequence number can never claim a task of a newer run.
+typedef struct {
+    alignas(64) std::atomic<uint64_t> claim;
+    std::atomic<int> remaining; // tasks not finished yet
+    std::atomic<int> ntasks;
+    std::atomic<tpool_task_fn> fn;
+    std::atomic<void*> arg;
+} tpool_desc_t;
+
+struct tpool {
+    int nthreads;
+    std::thread *workers; // nthreads-1 many, the caller is the last thread
+    uint64_t submitted;   // sequence number of the last run, caller only
+
+    alignas(64) std::atomic<uint64_t> published;
+    alignas(64) std::atomic<int> sleepers;
+    std::atomic<bool> stop;
+    std::mutex lock;
+    std::condition_variable wake;
+
+    tpool_desc_t ring[TPOOL_RING_SIZE];
+};
+
+static inline void cpu_relax(void) {
+#if defined(__x86_64__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+// Claims and runs tasks of run seq until none are left
+static void run_tasks(tpool_desc_t *desc, uint64_t seq) {
+    for (;;) {
+        uint64_t claim = desc->claim.load(std::memory_order_acquire);
+        if ((claim >> 32) != (seq & 0xffffffffu)) return;
+        int task = (int) (claim & 0xffffffffu);
+        if (task >= desc->ntasks.load(std::memory_order_relaxed)) return;
+
+        tpool_task_fn fn = desc->fn.load(std::memory_order_relaxed);
+        void *arg = desc->arg.load(std::memory_order_relaxed);
+        if (desc->claim.compare_exchange_weak(claim, claim + 1, std::memory_order_acq_rel)) {
+            fn(arg, task);
+            desc->remaining.fetch_sub(1, std::memory_order_release);
+        }
+    }
+}
+
+#ifdef __linux__
+// Pins the calling thread to the index-th core of the allowed set
+static void pin_to_core(int index) {
+    cpu_set_t allowed;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return;
+    int count = CPU_COUNT(&allowed);
+    if (count == 0) return;
+
+    int target = index % count;
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &allowed) && target-- == 0) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpu, &set);
+            pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+            return;
+        }
+    }
+}
+#endif
+
+// Pool thread of the current thread, workers are 1 .. nthreads-1 and the
+// caller of tpool_run is 0 for the duration of the run
+static thread_local int thread_index = 0;
+
+static void worker_main(tpool_t *pool, int index, bool pin) {
+    thread_index = index + 1;
+#ifdef __linux__
+    if (pin) pin_to_core(index + 1);
+#else
+    (void) pin;
+#endif
+
+    uint64_t seen = 0;
+    for (;;) {
+        // spin first, most calls arrive back to back
+        uint64_t seq = pool->published.load(std::memory_order_acquire);
+        for (int spin = 0; seq == seen && spin < TPOOL_SPIN; ++spin) {
+            if (pool->stop.load(std::memory_order_relaxed)) return;
+            cpu_relax();
+            seq = pool->published.load(std::memory_order_acquire);
+        }
+
+        // then park; sleepers is raised before published is checked again
+        // so that tpool_run cannot miss a parked worker
+        if (seq == seen) {
+            pool->sleepers.fetch_add(1);
+            {
+                std::unique_lock<std::mutex> guard(pool->lock);
+                pool->wake.wait(guard, [&] {
+                    return pool->published.load() != seen || pool->stop.load();
+                });
+            }
+            pool->sleepers.fetch_sub(1);
+            if (pool->stop.load()) return;
+            seq = pool->published.load(std::memory_order_acquire);
+        }
+
+        // runs are synchronous, so only the newest one can have work left
+        run_tasks(&pool->ring[seq % TPOOL_RING_SIZE], seq);
+        seen = seq;
+    }
+}
+
+tpool_t *tpool_create(int nthreads, bool pin) {
+    if (nthreads <= 0) {
+        nthreads = (int) std::thread::hardware_concurrency();
+        if (nthreads <= 0) nthreads = 1;
+    }
+
+    tpool_t *pool = new (std::nothrow) tpool_t();
+    if (!pool) return NULL;
+    pool->nthreads = nthreads;
+    pool->submitted = 0;
+    pool->published.store(0);
+    pool->sleepers.store(0);
+    pool->stop.store(false);
+    for (int i = 0; i < TPOOL_RING_SIZE; ++i) {
+        pool->ring[i].claim.store(0);
+        pool->ring[i].remaining.store(0);
+        pool->ring[i].ntasks.store(0);
+    }
+
+    pool->workers = new (std::nothrow) std::thread[nthreads - 1];
+    if (!pool->workers) {
+        delete pool;
+        return NULL;
+    }
+    for (int i = 0; i < nthreads - 1; ++i) {
+        pool->workers[i] = std::thread(worker_main, pool, i, pin);
+    }
+    return pool;
+}
+
+int tpool_threads(const tpool_t *pool) {
+    return pool->nthreads;
+}
+
+int tpool_thread_index(void) {
+    return thread_index;
+}
+
+void tpool_run(tpool_t *pool, tpool_task_fn fn, void *arg, int ntasks) {
+    if (ntasks <= 0) return;
+    // the caller is thread 0 of this pool, even if it is a worker of another
+    int outer = thread_index;
+    thread_index = 0;
+    // nothing to share, skip the round trip through the ring
+    if (ntasks == 1 || pool->nthreads == 1) {
+        for (int task = 0; task < ntasks; ++task) fn(arg, task);
+        thread_index = outer;
+        return;
+    }
+
+    uint64_t seq = ++pool->submitted;
+    tpool_desc_t *desc = &pool->ring[seq % TPOOL_RING_SIZE];
+    desc->fn.store(fn, std::memory_order_relaxed);
+    desc->arg.store(arg, std::memory_order_relaxed);
+    desc->ntasks.store(ntasks, std::memory_order_relaxed);
+    desc->remaining.store(ntasks, std::memory_order_relaxed);
+    desc->claim.store((seq & 0xffffffffu) << 32, std::memory_order_release);
+
+    pool->published.store(seq);
+    if (pool->sleepers.load() > 0) {
+        std::lock_guard<std::mutex> guard(pool->lock);
+        pool->wake.notify_all();
+    }
+
+    run_tasks(desc, seq);
+    while (desc->remaining.load(std::memory_order_acquire) > 0) {
+        cpu_relax();
+    }
+    thread_index = outer;
+}
+
+void tpool_free(tpool_t *pool) {
+    if (pool) {
+        pool->stop.store(true);
+        {
+            std::lock_guard<std::mutex> guard(pool->lock);
+            pool->wake.notify_all();
+        }
+        for (int i = 0; i < pool->nthreads - 1; ++i) {
+            pool->workers[i].join();
+        }
+        delete[] pool->workers;
+        delete pool;
+    }
+}
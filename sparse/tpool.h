@@ -0,0 +1,41 @@
+#ifndef TPOOL_H
+#define TPOOL_H
+
+#include <stdbool.h>
+
+// descriptors in the ring, a worker that lags behind by fewer runs than
+// this never sees its descriptor overwritten
+#define TPOOL_RING_SIZE 64
+// polls of the ring before an idle worker parks on the condition variable
+#define TPOOL_SPIN 20000
+
+// Persistent worker pool. Workers are created once, optionally pinned to
+// one core each, and wait for work by spinning for TPOOL_SPIN polls before
+// they park. Every tpool_run publishes one descriptor in a lock-free ring,
+// tasks are claimed with an atomic counter by the workers and the caller.
+typedef struct tpool tpool_t;
+
+// Body of one task, called with the argument of tpool_run and the task
+// index in [0, ntasks)
+typedef void (*tpool_task_fn)(void *arg, int task);
+
+// nthreads counts the calling thread, 0 means one per available core.
+// Returns NULL on failure.
+tpool_t *tpool_create(int nthreads, bool pin);
+
+int tpool_threads(const tpool_t *pool);
+
+// Index in [0, tpool_threads) of the thread running the current task: 0
+// for the calling thread of tpool_run, 1 .. nthreads-1 for the workers.
+// Tasks are claimed by whichever thread is free, so this is not the task
+// index.
+int tpool_thread_index(void);
+
+// Runs fn(arg, 0 .. ntasks-1) on the pool and the calling thread and
+// returns once all tasks are done. Must not be called concurrently on the
+// same pool.
+void tpool_run(tpool_t *pool, tpool_task_fn fn, void *arg, int ntasks);
+
+void tpool_free(tpool_t *pool);
+
+#endif
@@ -0,0 +1,206 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include "tsched.h"
+
+tsched_tile_t *tsched_tiles(int M, int N, int mb, int nb, int *ntiles) {
+    int m_tiles = (M + mb - 1) / mb;
+    int n_tiles = (N + nb - 1) / nb;
+    tsched_tile_t *tiles = (tsched_tile_t*) malloc((size_t) m_tiles * n_tiles * sizeof(tsched_tile_t));
+    if (!tiles) return NULL;
+
+    int i = 0;
+    for (int n0 = 0; n0 < N; n0 += nb) {
+        for (int m0 = 0; m0 < M; m0 += mb) {
+            tiles[i].m0 = m0;
+            tiles[i].m1 = (m0 + mb < M) ? m0 + mb : M;
+            tiles[i].n0 = n0;
+            tiles[i].n1 = (n0 + nb < N) ? n0 + nb : N;
+            ++i;
+        }
+    }
+    *ntiles = i;
+    return tiles;
+}
+
+// Chase-Lev deque of tile indices with a fixed capacity. The owner pushes
+// and takes at the bottom, thieves steal at the top. The capacity never
+// needs to grow, all tiles are pushed before the run starts.
+typedef struct {
+    alignas(64) std::atomic<long> top;
+    alignas(64) std::atomic<long> bottom;
+    std::atomic<int> *buf;
+    long cap;
+} deque_t;
+
+#define DEQUE_EMPTY (-1)
+#define DEQUE_ABORT (-2)
+
+static void deque_push(deque_t *q, int tile) {
+    long b = q->bottom.load(std::memory_order_relaxed);
+    q->buf[b % q->cap].store(tile, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    q->bottom.store(b + 1, std::memory_order_relaxed);
+}
+
+static int deque_take(deque_t *q) {
+    long b = q->bottom.load(std::memory_order_relaxed) - 1;
+    q->bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    long t = q->top.load(std::memory_order_relaxed);
+
+    if (t > b) {
+        q->bottom.store(b + 1, std::memory_order_relaxed);
+        return DEQUE_EMPTY;
+    }
+    int tile = q->buf[b % q->cap].load(std::memory_order_relaxed);
+    if (t == b) {
+        // last element, race against thieves for it
+        if (!q->top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            tile = DEQUE_EMPTY;
+        }
+        q->bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    return tile;
+}
+
+static int deque_steal(deque_t *q) {
+    long t = q->top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    long b = q->bottom.load(std::memory_order_acquire);
+    if (t >= b) return DEQUE_EMPTY;
+
+    int tile = q->buf[t % q->cap].load(std::memory_order_relaxed);
+    if (!q->top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return DEQUE_ABORT;
+    }
+    return tile;
+}
+
+// State shared by the workers of one tsched_run
+typedef struct {
+    const tsched_tile_t *tiles;
+    tsched_exec_fn exec;
+    void *arg;
+    int workers;
+    deque_t *deques;   // TSCHED_STEAL
+    const int *bounds; // TSCHED_STATIC: worker p runs [bounds[p], bounds[p + 1])
+    double *busy_ns;
+} run_t;
+
+static inline double exec_timed(const run_t *run, int tile) {
+    auto start = std::chrono::steady_clock::now();
+    run->exec(run->arg, &run->tiles[tile]);
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void static_worker(void *arg, int worker) {
+    const run_t *run = (const run_t*) arg;
+    double busy = 0.0;
+    for (int i = run->bounds[worker]; i < run->bounds[worker + 1]; ++i) {
+        busy += exec_timed(run, i);
+    }
+    if (run->busy_ns) run->busy_ns[tpool_thread_index()] += busy;
+}
+
+static void steal_worker(void *arg, int worker) {
+    const run_t *run = (const run_t*) arg;
+    double busy = 0.0;
+
+    // own deque first, heaviest tiles at the bottom
+    int tile;
+    while ((tile = deque_take(&run->deques[worker])) >= 0) {
+        busy += exec_timed(run, tile);
+    }
+
+    // then steal until a full pass over all victims finds nothing; no
+    // tiles are added during the run, so empty deques stay empty
+    bool retry = true;
+    while (retry) {
+        retry = false;
+        for (int i = 1; i < run->workers; ++i) {
+            deque_t *victim = &run->deques[(worker + i) % run->workers];
+            while ((tile = deque_steal(victim)) != DEQUE_EMPTY) {
+                if (tile == DEQUE_ABORT) {
+                    retry = true;
+                    continue;
+                }
+                busy += exec_timed(run, tile);
+            }
+        }
+    }
+    if (run->busy_ns) run->busy_ns[tpool_thread_index()] += busy;
+}
+
+void tsched_run(
+    tpool_t *pool, const tsched_tile_t *tiles, const long *cost, int ntiles,
+    tsched_mode_t mode, tsched_exec_fn exec, void *arg, double *busy_ns
+) {
+    int workers = tpool_threads(pool);
+    run_t run = {tiles, exec, arg, workers, NULL, NULL, busy_ns};
+    // a thread may run several workers, their time is added up
+    if (busy_ns) {
+        for (int t = 0; t < workers; ++t) busy_ns[t] = 0.0;
+    }
+
+    if (mode == TSCHED_STATIC) {
+        int *bounds = (int*) malloc((workers + 1) * sizeof(int));
+        if (!bounds) {
+            perror("malloc failed @ tsched_run()");
+            exit(EXIT_FAILURE);
+        }
+        long total = 0;
+        for (int i = 0; i < ntiles; ++i) total += cost[i];
+
+        // cut where the running cost crosses p / workers of the total
+        long prefix = 0;
+        int p = 1;
+        bounds[0] = 0;
+        for (int i = 0; i < ntiles && p < workers; ++i) {
+            prefix += cost[i];
+            while (p < workers && prefix * workers >= total * p) {
+                bounds[p++] = i + 1;
+            }
+        }
+        while (p <= workers) bounds[p++] = ntiles;
+
+        run.bounds = bounds;
+        tpool_run(pool, static_worker, &run, workers);
+        free(bounds);
+        return;
+    }
+
+    int *order = (int*) malloc(ntiles * sizeof(int));
+    deque_t *deques = new (std::nothrow) deque_t[workers];
+    std::atomic<int> *buf = new (std::nothrow) std::atomic<int>[(size_t) workers * ntiles];
+    if (!order || !deques || !buf) {
+        perror("malloc failed @ tsched_run()");
+        exit(EXIT_FAILURE);
+    }
+
+    // ascending cost, so dealing from the back hands every worker its
+    // heaviest tiles first and pushes them last (to the bottom)
+    for (int i = 0; i < ntiles; ++i) order[i] = i;
+    std::stable_sort(order, order + ntiles, [&](int x, int y) { return cost[x] < cost[y]; });
+
+    for (int w = 0; w < workers; ++w) {
+        deques[w].top.store(0);
+        deques[w].bottom.store(0);
+        deques[w].buf = buf + (size_t) w * ntiles;
+        deques[w].cap = ntiles;
+    }
+    // the tile with rank r from the top goes to worker r % workers
+    for (int i = 0; i < ntiles; ++i) {
+        int rank = ntiles - 1 - i;
+        deque_push(&deques[rank % workers], order[i]);
+    }
+
+    run.deques = deques;
+    tpool_run(pool, steal_worker, &run, workers);
+
+    free(order);
+    delete[] deques;
+    delete[] buf;
+}
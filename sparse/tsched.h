@@ -0,0 +1,48 @@
+#ifndef TSCHED_H
+#define TSCHED_H
+
+#include "tpool.h"
+
+// Default tile size of the scheduled kernels: rows of Y per tile and
+// columns of Y per tile (four cache lines of a Y row)
+#define TSCHED_TILE_M 32
+#define TSCHED_TILE_N 64
+// Column tiles per thread for formats that prefer wide tiles (BCSR)
+#define TSCHED_TILES_PER_THREAD 8
+
+// Rectangle [m0, m1) x [n0, n1) of Y
+typedef struct {
+    int m0, m1, n0, n1;
+} tsched_tile_t;
+
+typedef enum {
+    TSCHED_STATIC, // contiguous tile ranges of equal cost, one per thread
+    TSCHED_STEAL   // per-thread Chase-Lev deques with work stealing
+} tsched_mode_t;
+
+// Computes one tile of Y
+typedef void (*tsched_exec_fn)(void *arg, const tsched_tile_t *tile);
+
+// Cuts M x N into tiles of mb x nb, column tile major (all row tiles of the
+// first nb columns come first). Returns a malloc'd array of *ntiles tiles,
+// NULL on failure.
+tsched_tile_t *tsched_tiles(int M, int N, int mb, int nb, int *ntiles);
+
+// Executes all tiles on the pool. cost[i] is the estimated work of tile i
+// (e.g. its non-zeros times its rows).
+//  TSCHED_STATIC: thread p runs a contiguous range of tiles of about equal
+//                 cost, the tile analogue of tcsc_partition_columns
+//  TSCHED_STEAL:  tiles are sorted by cost and dealt round-robin into one
+//                 deque per thread so that each owner starts with its
+//                 heaviest tile; idle threads steal the lightest tiles
+//                 from the top of the other deques
+// If busy_ns is not NULL it receives, per pool thread, the nanoseconds
+// spent executing tiles (tpool_threads(pool) entries, indexed by
+// tpool_thread_index of the thread that ran them, so stolen tiles count
+// for the thief).
+void tsched_run(
+    tpool_t *pool, const tsched_tile_t *tiles, const long *cost, int ntiles,
+    tsched_mode_t mode, tsched_exec_fn exec, void *arg, double *busy_ns
+);
+
+#endif
@@ -0,0 +1,263 @@
+#include "tsell.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <algorithm>
+
+// Lays out the indices of one sign: chunk_start gets the prefix sums of
+// the padded chunk sizes, index the interleaved row indices
+static int *fill_chunks(
+    const int *col_start, const int *row_index, const int *perm,
+    int n_chunks, int C, int rows, int *chunk_start
+) {
+    chunk_start[0] = 0;
+    for (int c = 0; c < n_chunks; ++c) {
+        int len = 0;
+        for (int l = 0; l < C; ++l) {
+            int n = perm[c * C + l];
+            if (n >= 0 && col_start[n + 1] - col_start[n] > len)
+                len = col_start[n + 1] - col_start[n];
+        }
+        chunk_start[c + 1] = chunk_start[c] + len * C;
+    }
+
+    // one extra element so that empty matrices get a valid pointer too
+    int *index = (int*) malloc(((size_t) chunk_start[n_chunks] + 1) * sizeof(int));
+    if (!index) return NULL;
+
+    for (int c = 0; c < n_chunks; ++c) {
+        int len = (chunk_start[c + 1] - chunk_start[c]) / C;
+        for (int l = 0; l < C; ++l) {
+            int n = perm[c * C + l];
+            int count = (n >= 0) ? col_start[n + 1] - col_start[n] : 0;
+            for (int j = 0; j < len; ++j)
+                index[chunk_start[c] + j * C + l] = (j < count) ? row_index[col_start[n] + j] : rows;
+        }
+    }
+    return index;
+}
+
+tsell_t *tsell_from_tcsc(const tcsc_t *W, int C, int sigma) {
+    if (C < 1) return NULL;
+    tsell_t *S = (tsell_t*) malloc(sizeof(tsell_t));
+    if (!S) return NULL;
+
+    S->rows = W->rows;
+    S->cols = W->cols;
+    S->C = C;
+    S->sigma = (sigma <= C) ? C : (sigma + C - 1) / C * C;
+    S->n_chunks = (W->cols + C - 1) / C;
+    S->n_elem_pos = W->n_elem_pos;
+    S->n_elem_neg = W->n_elem_neg;
+    S->perm = (int*) malloc((size_t) S->n_chunks * C * sizeof(int));
+    S->chunk_start_pos = (int*) malloc((S->n_chunks + 1) * sizeof(int));
+    S->chunk_start_neg = (int*) malloc((S->n_chunks + 1) * sizeof(int));
+    S->row_index_pos = NULL;
+    S->row_index_neg = NULL;
+    if (!S->perm || !S->chunk_start_pos || !S->chunk_start_neg) {
+        tsell_free(S);
+        return NULL;
+    }
+
+    // sort each window by decreasing length, ties keep the column order
+    for (int n = 0; n < S->n_chunks * C; ++n)
+        S->perm[n] = (n < W->cols) ? n : -1;
+    auto nnz = [W](int n) {
+        return (W->col_start_pos[n + 1] - W->col_start_pos[n]) +
+               (W->col_start_neg[n + 1] - W->col_start_neg[n]);
+    };
+    for (int n0 = 0; n0 < W->cols; n0 += S->sigma) {
+        int n1 = std::min(n0 + S->sigma, W->cols);
+        std::stable_sort(S->perm + n0, S->perm + n1, [&](int a, int b) { return nnz(a) > nnz(b); });
+    }
+
+    S->row_index_pos = fill_chunks(W->col_start_pos, W->row_index_pos, S->perm,
+                                   S->n_chunks, C, W->rows, S->chunk_start_pos);
+    S->row_index_neg = fill_chunks(W->col_start_neg, W->row_index_neg, S->perm,
+                                   S->n_chunks, C, W->rows, S->chunk_start_neg);
+    if (!S->row_index_pos || !S->row_index_neg) {
+        tsell_free(S);
+        return NULL;
+    }
+    return S;
+}
+
+void tsell_sgemm_basic(
+    const dense_t X, const tsell_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+) {
+    const int C = W->C;
+
+    for (int c = 0; c < W->n_chunks; ++c) {
+        int pos = W->chunk_start_pos[c], len_pos = (W->chunk_start_pos[c + 1] - pos) / C;
+        int neg = W->chunk_start_neg[c], len_neg = (W->chunk_start_neg[c + 1] - neg) / C;
+        for (int m = 0; m < M; ++m) {
+            const float *x = X + (size_t) m * K;
+            for (int l = 0; l < C; ++l) {
+                int n = W->perm[c * C + l];
+                if (n < 0) continue;
+                // padded slots (row index K) come last in a lane
+                float y = 0.0f;
+                for (int j = 0; j < len_pos && W->row_index_pos[pos + j * C + l] < K; ++j)
+                    y += x[W->row_index_pos[pos + j * C + l]];
+                for (int j = 0; j < len_neg && W->row_index_neg[neg + j * C + l] < K; ++j)
+                    y -= x[W->row_index_neg[neg + j * C + l]];
+                Y[(size_t) m * N + n] = y + B[n];
+            }
+        }
+    }
+}
+
+#ifdef __x86_64__
+#include <immintrin.h>
+
+// Gathers the 8 lanes of one step, padded slots (row index K) are masked
+// off and read as zero, so X is used in place
+__attribute__((target("avx2")))
+static inline __m256 gather8(const float *x, const int *index, __m256i k) {
+    __m256i idx = _mm256_loadu_si256((const __m256i*) index);
+    __m256 live = _mm256_castsi256_ps(_mm256_cmpgt_epi32(k, idx));
+    return _mm256_mask_i32gather_ps(_mm256_setzero_ps(), x, idx, live, 4);
+}
+
+__attribute__((target("avx512f")))
+static inline __m512 gather16(const float *x, const int *index, __m512i k) {
+    __m512i idx = _mm512_loadu_si512(index);
+    return _mm512_mask_i32gather_ps(_mm512_setzero_ps(), _mm512_cmplt_epi32_mask(idx, k), idx, x, 4);
+}
+
+// Chunks are the outer loop so that their indices stay in L1 for all rows
+// of X. Two accumulators per sign break the dependency on the gathers.
+__attribute__((target("avx2")))
+void tsell_sgemm_avx2(
+    const dense_t X, const tsell_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+) {
+    const int C = 8;
+    const __m256i k = _mm256_set1_epi32(K);
+    alignas(32) float tile[8];
+
+    for (int c = 0; c < W->n_chunks; ++c) {
+        const int *pos = W->row_index_pos + W->chunk_start_pos[c];
+        const int *neg = W->row_index_neg + W->chunk_start_neg[c];
+        int len_pos = (W->chunk_start_pos[c + 1] - W->chunk_start_pos[c]) / C;
+        int len_neg = (W->chunk_start_neg[c + 1] - W->chunk_start_neg[c]) / C;
+        for (int m = 0; m < M; ++m) {
+            const float *x = X + (size_t) m * K;
+            __m256 acc0 = _mm256_setzero_ps();
+            __m256 acc1 = _mm256_setzero_ps();
+            int j = 0;
+            for (; j + 2 <= len_pos; j += 2) {
+                acc0 = _mm256_add_ps(acc0, gather8(x, &pos[j * C], k));
+                acc1 = _mm256_add_ps(acc1, gather8(x, &pos[j * C + C], k));
+            }
+            if (j < len_pos)
+                acc0 = _mm256_add_ps(acc0, gather8(x, &pos[j * C], k));
+            j = 0;
+            for (; j + 2 <= len_neg; j += 2) {
+                acc0 = _mm256_sub_ps(acc0, gather8(x, &neg[j * C], k));
+                acc1 = _mm256_sub_ps(acc1, gather8(x, &neg[j * C + C], k));
+            }
+            if (j < len_neg)
+                acc0 = _mm256_sub_ps(acc0, gather8(x, &neg[j * C], k));
+
+            _mm256_store_ps(tile, _mm256_add_ps(acc0, acc1));
+            for (int l = 0; l < C; ++l) {
+                int n = W->perm[c * C + l];
+                if (n >= 0) Y[(size_t) m * N + n] = tile[l] + B[n];
+            }
+        }
+    }
+}
+
+__attribute__((target("avx512f")))
+void tsell_sgemm_avx512(
+    const dense_t X, const tsell_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+) {
+    const int C = 16;
+    const __m512i k = _mm512_set1_epi32(K);
+    alignas(64) float tile[16];
+
+    for (int c = 0; c < W->n_chunks; ++c) {
+        const int *pos = W->row_index_pos + W->chunk_start_pos[c];
+        const int *neg = W->row_index_neg + W->chunk_start_neg[c];
+        int len_pos = (W->chunk_start_pos[c + 1] - W->chunk_start_pos[c]) / C;
+        int len_neg = (W->chunk_start_neg[c + 1] - W->chunk_start_neg[c]) / C;
+        for (int m = 0; m < M; ++m) {
+            const float *x = X + (size_t) m * K;
+            __m512 acc0 = _mm512_setzero_ps();
+            __m512 acc1 = _mm512_setzero_ps();
+            int j = 0;
+            for (; j + 2 <= len_pos; j += 2) {
+                acc0 = _mm512_add_ps(acc0, gather16(x, &pos[j * C], k));
+                acc1 = _mm512_add_ps(acc1, gather16(x, &pos[j * C + C], k));
+            }
+            if (j < len_pos)
+                acc0 = _mm512_add_ps(acc0, gather16(x, &pos[j * C], k));
+            j = 0;
+            for (; j + 2 <= len_neg; j += 2) {
+                acc0 = _mm512_sub_ps(acc0, gather16(x, &neg[j * C], k));
+                acc1 = _mm512_sub_ps(acc1, gather16(x, &neg[j * C + C], k));
+            }
+            if (j < len_neg)
+                acc0 = _mm512_sub_ps(acc0, gather16(x, &neg[j * C], k));
+
+            _mm512_store_ps(tile, _mm512_add_ps(acc0, acc1));
+            for (int l = 0; l < C; ++l) {
+                int n = W->perm[c * C + l];
+                if (n >= 0) Y[(size_t) m * N + n] = tile[l] + B[n];
+            }
+        }
+    }
+}
+#endif
+
+void tsell_sgemm(
+    const dense_t X, const tsell_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+) {
+#ifdef __x86_64__
+    if (W->C == 16 && __builtin_cpu_supports("avx512f")) {
+        tsell_sgemm_avx512(X, W, B, Y, M, N, K);
+        return;
+    }
+    if (W->C == 8 && __builtin_cpu_supports("avx2")) {
+        tsell_sgemm_avx2(X, W, B, Y, M, N, K);
+        return;
+    }
+#endif
+    tsell_sgemm_basic(X, W, B, Y, M, N, K);
+}
+
+const char *tsell_isa(const tsell_t *W) {
+#ifdef __x86_64__
+    if (W->C == 16 && __builtin_cpu_supports("avx512f"))
+        return "avx512";
+    if (W->C == 8 && __builtin_cpu_supports("avx2"))
+        return "avx2";
+#endif
+    return "scalar";
+}
+
+float tsell_padding_overhead(const tsell_t *W) {
+    long nnz = (long) W->n_elem_pos + W->n_elem_neg;
+    long stored = (long) W->chunk_start_pos[W->n_chunks] + W->chunk_start_neg[W->n_chunks];
+    return (nnz > 0) ? (float) (stored - nnz) / nnz : 0.0f;
+}
+
+size_t tsell_bytes(const tsell_t *W) {
+    size_t elems = (size_t) W->n_chunks * W->C + 2 * ((size_t) W->n_chunks + 1) +
+                   W->chunk_start_pos[W->n_chunks] + W->chunk_start_neg[W->n_chunks];
+    return elems * sizeof(int);
+}
+
+void tsell_free(tsell_t *W) {
+    if (W) {
+        free(W->perm);
+        free(W->chunk_start_pos);
+        free(W->chunk_start_neg);
+        free(W->row_index_pos);
+        free(W->row_index_neg);
+        free(W);
+    }
+}
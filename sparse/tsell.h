@@ -0,0 +1,77 @@
+#ifndef TSELL_H
+#define TSELL_H
+
+#include <stddef.h>
+#include "../dense/dense.h"
+#include "tcsc.h"
+
+// Ternary SELL-C-sigma (sliced ELLPACK): columns are sorted by decreasing
+// number of non-zeros within windows of sigma columns and grouped into
+// chunks of C columns. The row indices of a chunk are padded to its longest
+// column and stored interleaved, step j of the C columns is one run of C
+// indices, so one SIMD lane accumulates one output column. Padded slots
+// hold the row index rows, which the kernels mask off, so X is read in
+// place without a padded copy.
+typedef struct {
+    int rows, cols;
+    int C, sigma;
+    int n_chunks;   // ceil(cols / C), the last chunk is padded with empty columns
+    int n_elem_pos; // number of matrix elements with value +1
+    int n_elem_neg; // number of matrix elements with value -1
+    // has n_chunks * C elements: column of W held by slot s, -1 for the
+    // padding of the last chunk
+    int* perm;
+    // have n_chunks+1 many elements, offsets into the index arrays. Chunk c
+    // has (chunk_start[c+1] - chunk_start[c]) / C steps.
+    int* chunk_start_pos;
+    int* chunk_start_neg;
+    // step j of lane l of chunk c is at chunk_start[c] + j * C + l
+    int* row_index_pos;
+    int* row_index_neg;
+} tsell_t;
+
+// Builds the sliced layout of W with chunks of C columns, sigma is rounded
+// up to a multiple of C (sigma = C keeps the column order, sigma >= cols
+// sorts all columns). Returns NULL for C < 1 or if out of memory.
+tsell_t *tsell_from_tcsc(const tcsc_t *W, int C, int sigma);
+
+// Scalar kernel for any C
+void tsell_sgemm_basic(
+    const dense_t X, const tsell_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+
+// One gather of X per step and chunk, 8 columns per ymm register (needs
+// C == 8) or 16 columns per zmm register (needs C == 16)
+#ifdef __x86_64__
+void tsell_sgemm_avx2(
+    const dense_t X, const tsell_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+
+void tsell_sgemm_avx512(
+    const dense_t X, const tsell_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+#endif
+
+// Runs the SIMD kernel matching W->C if the CPU supports it,
+// tsell_sgemm_basic otherwise
+void tsell_sgemm(
+    const dense_t X, const tsell_t* W, const dense_t B, dense_t Y,
+    int M, int N, int K
+);
+
+// Name of the instruction set tsell_sgemm dispatches to for W
+const char *tsell_isa(const tsell_t *W);
+
+// Padded slots over non-zeros: 0 means no padding, 1 means every stored
+// index is matched by a padded one
+float tsell_padding_overhead(const tsell_t *W);
+
+// Bytes occupied by the permutation and the index arrays
+size_t tsell_bytes(const tsell_t *W);
+
+void tsell_free(tsell_t *W);
+
+#endif
@@ -1,5 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <math.h>
+#include <initializer_list>
 #include "../dense/dense.h"
 #include "../sparse/bcsr.h"
 
@@ -20,7 +22,8 @@ int main() {
     dense_t X = init_rand_dense(M, K);
     dense_t W_dense = init_rand_sparse(K, N, 2); // 1/8 non-zero elements
     dense_t B = init_rand_dense(N, 1);  // Bias vector
-    dense_t Y = (dense_t)malloc(M * N * sizeof(dense_elem_t));
+    // the AVX kernels need 32-byte aligned rows of Y
+    dense_t Y = (dense_t)aligned_alloc(32, M * N * sizeof(dense_elem_t));
     dense_t Y_ref = (dense_t)malloc(M * N * sizeof(dense_elem_t));
     
     // Convert dense W to BCSR format
@@ -31,9 +34,112 @@ int main() {
     
     // Compute result using BCSR GEMM
     bcsr_sgemm_basic(X, *W_bcsr, B, Y, M, N, K);
-    
+    bool passed = compare(Y, Y_ref, M, N);
+
+    // PReLU on the finished sums
+    float a = 0.2f;
+    for (int i = 0; i < M * N; i++) Y_ref[i] = (Y_ref[i] < 0.0f) ? a * Y_ref[i] : Y_ref[i];
+    bcsr_sgemm_prelu_basic(X, *W_bcsr, B, a, Y, M, N, K);
+    passed = compare(Y, Y_ref, M, N) && passed;
+    bcsr_sgemm_prelu_avx(X, *W_bcsr, B, a, Y, M, N, K);
+    passed = compare(Y, Y_ref, M, N) && passed;
+    bcsc_t* W_bcsc = bcsc_from_bcsr(W_bcsr);
+    bcsc_sgemm_prelu(X, W_bcsc, B, a, Y, M, N, K);
+    passed = compare(Y, Y_ref, M, N) && passed;
+    bcsc_free(W_bcsc);
+
+    // Every specialized block shape on dimensions that are multiples of
+    // none of them, with an empty band of rows for empty block rows
+    int M2 = 11, K2 = 203, N2 = 301;
+    dense_t X2 = init_rand_dense(M2, K2);
+    dense_t W2_dense = init_rand_sparse(K2, N2, 8);
+    dense_t B2 = init_rand_dense(N2, 1);
+    dense_t Y2 = (dense_t)malloc(M2 * N2 * sizeof(dense_elem_t));
+    dense_t Y2_ref = (dense_t)malloc(M2 * N2 * sizeof(dense_elem_t));
+    for (int i = 40 * N2; i < 72 * N2; i++) W2_dense[i] = 0.0f;
+    gemm_basic(X2, W2_dense, B2, Y2_ref, M2, N2, K2);
+    tpool_t *pool = tpool_create(2, false);
+    for (int r2 : {1, 2, 3, 4, 8}) {
+        for (int c2 : {8, 16, 32}) {
+            bcsr_t* W2 = bcsr_from_dense(W2_dense, K2, N2, r2, c2);
+            bcsr_sgemm_generic(X2, *W2, B2, Y2, M2, N2, K2);
+            passed = compare(Y2, Y2_ref, M2, N2) && passed;
+            bcsr_sgemm(X2, *W2, B2, Y2, M2, N2, K2);
+            passed = compare(Y2, Y2_ref, M2, N2) && passed;
+            bcsr_sgemm_fused_bias(X2, *W2, B2, Y2, M2, N2, K2);
+            passed = compare(Y2, Y2_ref, M2, N2) && passed;
+            if (pool) {
+                bcsr_sgemm_pool(pool, X2, *W2, B2, Y2, M2, N2, K2);
+                passed = compare(Y2, Y2_ref, M2, N2) && passed;
+                bcsr_sgemm_sched(pool, X2, *W2, B2, Y2, M2, N2, K2, TSCHED_STEAL, NULL);
+                passed = compare(Y2, Y2_ref, M2, N2) && passed;
+            }
+
+            // block-column traversal, plain and with PReLU
+            bcsc_t* V2 = bcsc_from_bcsr(W2);
+            bcsc_sgemm(X2, V2, B2, Y2, M2, N2, K2);
+            passed = compare(Y2, Y2_ref, M2, N2) && passed;
+            bcsc_sgemm_prelu(X2, V2, B2, a, Y2, M2, N2, K2);
+            for (int i = 0; i < M2 * N2; i++) {
+                float y = (Y2_ref[i] < 0.0f) ? a * Y2_ref[i] : Y2_ref[i];
+                passed = passed && fabsf(Y2[i] - y) <= 1e-4f;
+            }
+            bcsc_free(V2);
+
+            // block-row kernels with PReLU on the finished sums
+            bcsr_sgemm_prelu_basic(X2, *W2, B2, a, Y2, M2, N2, K2);
+            for (int i = 0; i < M2 * N2; i++) {
+                float y = (Y2_ref[i] < 0.0f) ? a * Y2_ref[i] : Y2_ref[i];
+                passed = passed && fabsf(Y2[i] - y) <= 1e-4f;
+            }
+            bcsr_sgemm_prelu_avx(X2, *W2, B2, a, Y2, M2, N2, K2);
+            for (int i = 0; i < M2 * N2; i++) {
+                float y = (Y2_ref[i] < 0.0f) ? a * Y2_ref[i] : Y2_ref[i];
+                passed = passed && fabsf(Y2[i] - y) <= 1e-4f;
+            }
+            free(W2->b_values);
+            free(W2->b_row_start);
+            free(W2->b_col_idx);
+            free(W2);
+        }
+    }
+
+    tpool_free(pool);
+
+    // The analysis samples all of a matrix this small, so its block counts
+    // are exact, and the shape it picks computes the same product
+    bcsr_analysis_t stats;
+    bcsr_t* W2_auto = bcsr_from_dense_auto(W2_dense, K2, N2, &stats);
+    for (int i = 0; i < BCSR_N_SHAPES; i++) {
+        bcsr_t* W2 = bcsr_from_dense(W2_dense, K2, N2, stats.shapes[i].r, stats.shapes[i].c);
+        passed = passed && stats.shapes[i].blocks == W2->k && stats.shapes[i].bytes == bcsr_bytes(W2);
+        free(W2->b_values);
+        free(W2->b_row_start);
+        free(W2->b_col_idx);
+        free(W2);
+    }
+    passed = passed && W2_auto->r == stats.shapes[stats.best].r && W2_auto->c == stats.shapes[stats.best].c;
+    bcsr_sgemm(X2, *W2_auto, B2, Y2, M2, N2, K2);
+    passed = compare(Y2, Y2_ref, M2, N2) && passed;
+    free(W2_auto->b_values);
+    free(W2_auto->b_row_start);
+    free(W2_auto->b_col_idx);
+    free(W2_auto);
+
+    // Weights made of whole 4 x 16 blocks get a shape without padding
+    int K3 = 64, N3 = 256;
+    dense_t W3_dense = init_rand_dense(K3, N3);
+    for (int i = 0; i < K3; i++) {
+        for (int j = 0; j < N3; j++) {
+            bool in_block = (i / 4 + j / 16) % 3 == 0;
+            W3_dense[i * N3 + j] = in_block ? ((W3_dense[i * N3 + j] < 0.0f) ? -1.0f : 1.0f) : 0.0f;
+        }
+    }
+    bcsr_analyze(W3_dense, K3, N3, &stats);
+    passed = passed && stats.shapes[stats.best].fill == 1.0f;
+
     // Compare results
-    if (compare(Y, Y_ref, M, N)) {
+    if (passed) {
         printf("Test passed! Results match.\n");
     } else {
         printf("Test failed! Results don't match.\n");
@@ -49,6 +155,12 @@ int main() {
     free(W_bcsr->b_row_start);
     free(W_bcsr->b_col_idx);
     free(W_bcsr);
+    free(X2);
+    free(W2_dense);
+    free(B2);
+    free(Y2);
+    free(Y2_ref);
+    free(W3_dense);
     
-    return 0;
+    return passed ? 0 : 1;
 }
\ No newline at end of file
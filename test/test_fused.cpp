@@ -0,0 +1,111 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "../dense/dense.h"
+#include "../sparse/tcsc.h"
+#include "../sparse/tcsc_fused.h"
+#include "../sparse/bcsr.h"
+
+int main() {
+    // Test dimensions, N is not a multiple of 8 for the TCSC tails
+    int M = 3;     // Number of rows in X
+    int K = 256;   // Columns in X, Rows in W
+    int N = 203;   // Columns in W/Y
+    float a = 0.2f; // PReLU parameter
+
+    // Initialize matrices
+    dense_t X = init_rand_dense(M, K);
+    dense_t W_dense = init_rand_sparse(K, N, 4); // 1/4 non-zero elements
+    dense_t B = init_rand_dense(N, 1);  // Bias vector
+    dense_t alpha = init_rand_dense(N, 1); // per-channel slopes
+    dense_t R = init_rand_dense(M, N);  // residual
+    dense_t Y = (dense_t)malloc(M * N * sizeof(dense_elem_t));
+    dense_t Y_lin = (dense_t)malloc(M * N * sizeof(dense_elem_t));
+    dense_t Y_ref = (dense_t)malloc(M * N * sizeof(dense_elem_t));
+    int8_t *Q = (int8_t*)malloc(M * N);
+
+    tcsc_t* W_tcsc = tcsc_from_dense(W_dense, K, N);
+
+    // Y_lin = XW + B, all references apply the epilogue to it
+    gemm_basic(X, W_dense, B, Y_lin, M, N, K);
+
+    bool passed = true;
+
+    tcsc_sgemm_fused_bias(X, W_tcsc, B, Y, M, N, K);
+    passed = compare(Y, Y_lin, M, N) && passed;
+
+    for (int i = 0; i < M * N; ++i) Y_ref[i] = fmaxf(Y_lin[i], 0.0f);
+    tcsc_sgemm_fused_bias_relu(X, W_tcsc, B, Y, M, N, K);
+    passed = compare(Y, Y_ref, M, N) && passed;
+
+    for (int i = 0; i < M * N; ++i) Y_ref[i] = (Y_lin[i] < 0.0f) ? a * Y_lin[i] : Y_lin[i];
+    tcsc_sgemm_fused_bias_prelu(X, W_tcsc, B, a, Y, M, N, K);
+    passed = compare(Y, Y_ref, M, N) && passed;
+
+    // quantized output may differ by one step where the reference rounds
+    // differently within the tolerance of the float result
+    float q_scale = 0.05f;
+    tcsc_sgemm_fused_bias_prelu_q8(X, W_tcsc, B, a, q_scale, 3, Q, M, N, K);
+    for (int i = 0; i < M * N; ++i) {
+        float q = fminf(fmaxf(rintf(Y_ref[i] / q_scale) + 3, -128.0f), 127.0f);
+        passed = passed && fabsf(Q[i] - q) <= 1.0f;
+    }
+
+    for (int i = 0; i < M * N; ++i) {
+        int n = i % N;
+        Y_ref[i] = (Y_lin[i] < 0.0f) ? alpha[n] * Y_lin[i] : Y_lin[i];
+    }
+    tcsc_sgemm_fused_bias_prelu_channel(X, W_tcsc, B, alpha, Y, M, N, K);
+    passed = compare(Y, Y_ref, M, N) && passed;
+
+    for (int i = 0; i < M * N; ++i) Y_ref[i] = fminf(fmaxf(Y_lin[i], -0.5f), 0.5f);
+    tcsc_sgemm_fused_bias_clamp(X, W_tcsc, B, -0.5f, 0.5f, Y, M, N, K);
+    passed = compare(Y, Y_ref, M, N) && passed;
+
+    for (int i = 0; i < M * N; ++i) Y_ref[i] = Y_lin[i] + R[i];
+    tcsc_sgemm_fused_bias_residual(X, W_tcsc, B, R, Y, M, N, K);
+    passed = compare(Y, Y_ref, M, N) && passed;
+
+    for (int i = 0; i < M * N; ++i) Y_ref[i] = 2.0f * (Y_lin[i] - B[i % N]) + B[i % N];
+    tcsc_sgemm_fused_scale_bias(X, W_tcsc, 2.0f, B, Y, M, N, K);
+    passed = compare(Y, Y_ref, M, N) && passed;
+
+    // BCSR with 1x8 blocks and with 3x16 blocks, whose last block row and
+    // block column are partial, PReLU on the finished sums
+    for (int shape = 0; shape < 2; ++shape) {
+        bcsr_t* W_bcsr = (shape == 0) ? bcsr_from_dense(W_dense, K, N, 1, 8) : bcsr_from_dense(W_dense, K, N, 3, 16);
+        bcsr_sgemm_fused_bias(X, *W_bcsr, B, Y, M, N, K);
+        passed = compare(Y, Y_lin, M, N) && passed;
+        for (int i = 0; i < M * N; ++i) Y_ref[i] = fmaxf(Y_lin[i], 0.0f);
+        bcsr_sgemm_fused_bias_relu(X, *W_bcsr, B, Y, M, N, K);
+        passed = compare(Y, Y_ref, M, N) && passed;
+        for (int i = 0; i < M * N; ++i) Y_ref[i] = (Y_lin[i] < 0.0f) ? a * Y_lin[i] : Y_lin[i];
+        bcsr_sgemm_fused_bias_prelu(X, *W_bcsr, B, a, Y, M, N, K);
+        passed = compare(Y, Y_ref, M, N) && passed;
+        free(W_bcsr->b_values);
+        free(W_bcsr->b_row_start);
+        free(W_bcsr->b_col_idx);
+        free(W_bcsr);
+    }
+
+    // Compare results
+    if (passed) {
+        printf("Test passed! Results match.\n");
+    } else {
+        printf("Test failed! Results don't match.\n");
+    }
+
+    // Free memory
+    free(X);
+    free(W_dense);
+    free(B);
+    free(alpha);
+    free(R);
+    free(Y);
+    free(Y_lin);
+    free(Y_ref);
+    free(Q);
+    tcsc_free(W_tcsc);
+
+    return passed ? 0 : 1;
+}
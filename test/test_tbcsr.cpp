@@ -0,0 +1,72 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <initializer_list>
+#include "../dense/dense.h"
+#include "../sparse/bcsr.h"
+#include "../sparse/tbcsr.h"
+
+int main() {
+    // Test dimensions, K and N are not multiples of the block shape for the
+    // padded last block row and column
+    int M = 3;     // Number of rows in X
+    int K = 203;   // Columns in X, Rows in W
+    int N = 301;   // Columns in W/Y
+
+    // Initialize matrices
+    dense_t X = init_rand_dense(M, K);
+    dense_t W_dense = init_rand_sparse(K, N, 4); // 1/4 non-zero elements
+    dense_t B = init_rand_dense(N, 1);  // Bias vector
+    dense_t Y = (dense_t)malloc(M * N * sizeof(dense_elem_t));
+    dense_t Y_ref = (dense_t)malloc(M * N * sizeof(dense_elem_t));
+
+    gemm_basic(X, W_dense, B, Y_ref, M, N, K);
+
+    bool passed = true;
+
+    for (int r : {1, 2, 3, 4, 8}) {
+        for (int c : {8, 16, 32}) {
+            tbcsr_t* W = tbcsr_from_dense(W_dense, K, N, r, c);
+            if (!W) return 1;
+
+            tbcsr_sgemm_basic(X, W, B, Y, M, N, K);
+            passed = compare(Y, Y_ref, M, N) && passed;
+            tbcsr_sgemm(X, W, B, Y, M, N, K);
+            passed = compare(Y, Y_ref, M, N) && passed;
+#ifdef __x86_64__
+            if (__builtin_cpu_supports("avx2")) {
+                tbcsr_sgemm_avx2(X, W, B, Y, M, N, K);
+                passed = compare(Y, Y_ref, M, N) && passed;
+            }
+#endif
+            tbcsr_free(W);
+        }
+    }
+
+    // only ternary values and whole bytes per block row have a bitmask payload
+    W_dense[0] = 0.5f;
+    tbcsr_t* W_bad = tbcsr_from_dense(W_dense, K, N, 1, 8);
+    passed = passed && W_bad == NULL;
+    // also when it is the only non-zero of its block
+    for (int j = 1; j < 8; ++j) W_dense[j] = 0.0f;
+    W_bad = tbcsr_from_dense(W_dense, K, N, 1, 8);
+    passed = passed && W_bad == NULL;
+    W_dense[0] = 1.0f;
+    W_bad = tbcsr_from_dense(W_dense, K, N, 1, 4);
+    passed = passed && W_bad == NULL;
+
+    // Compare results
+    if (passed) {
+        printf("Test passed! Results match.\n");
+    } else {
+        printf("Test failed! Results don't match.\n");
+    }
+
+    // Free memory
+    free(X);
+    free(W_dense);
+    free(B);
+    free(Y);
+    free(Y_ref);
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,74 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "../dense/dense.h"
+#include "../sparse/tcsc.h"
+#include "../sparse/tbitmap.h"
+#include "../sparse/tbitact.h"
+
+int main() {
+    // Test dimensions, K needs whole and partial groups of 8 words
+    int M = 5;     // Number of rows in X
+    int K = 1100;  // Columns in X, Rows in W
+    int N = 67;    // Columns in W/Y
+    float threshold = 2.5f;
+
+    // Initialize matrices, X is ternary as well
+    dense_t X = init_rand_sparse(M, K, 2);      // 1/2 non-zero activations
+    dense_t W_dense = init_rand_sparse(K, N, 4); // 1/4 non-zero elements
+    dense_t B = init_rand_dense(N, 1);  // Bias vector
+    dense_t Y = (dense_t)malloc(M * N * sizeof(dense_elem_t));
+    dense_t Y_ref = (dense_t)malloc(M * N * sizeof(dense_elem_t));
+    dense_t X_back = (dense_t)malloc(M * K * sizeof(dense_elem_t));
+
+    tbitact_t* X_bits = tbitact_from_dense(X, M, K, 0.5f);
+    tcsc_t* W_tcsc = tcsc_from_dense(W_dense, K, N);
+    tbitmap_t* W_bitmap = tbitmap_from_tcsc(W_tcsc);
+    tbitact_t* Z = tbitact_create(M, N);
+
+    // Compute reference result using dense GEMM
+    gemm_basic(X, W_dense, B, Y_ref, M, N, K);
+
+    bool passed = true;
+    tbitact_to_dense(X_bits, X_back);
+    passed = compare(X_back, X, M, K) && passed;
+
+    tbitact_sgemm_basic(X_bits, W_bitmap, B, Y, M, N, K);
+    passed = compare(Y, Y_ref, M, N) && passed;
+#ifdef __x86_64__
+    if (__builtin_cpu_supports("avx512vpopcntdq")) {
+        tbitact_sgemm_avx512(X_bits, W_bitmap, B, Y, M, N, K);
+        passed = compare(Y, Y_ref, M, N) && passed;
+    }
+#endif
+    tbitact_sgemm(X_bits, W_bitmap, B, Y, M, N, K);
+    passed = compare(Y, Y_ref, M, N) && passed;
+
+    // the fused threshold has to match ternarizing the float result
+    tbitact_t* Z_ref = tbitact_from_dense(Y_ref, M, N, threshold);
+    tbitact_gemm_ternary(X_bits, W_bitmap, B, threshold, Z, M, N, K);
+    for (int i = 0; i < M * Z->n_words; ++i) {
+        passed = passed && Z->pos[i] == Z_ref->pos[i] && Z->neg[i] == Z_ref->neg[i];
+    }
+
+    // Compare results
+    if (passed) {
+        printf("Test passed! Results match (%s).\n", tbitact_isa());
+    } else {
+        printf("Test failed! Results don't match.\n");
+    }
+
+    // Free memory
+    free(X);
+    free(W_dense);
+    free(B);
+    free(Y);
+    free(Y_ref);
+    free(X_back);
+    tbitact_free(X_bits);
+    tbitact_free(Z);
+    tbitact_free(Z_ref);
+    tcsc_free(W_tcsc);
+    tbitmap_free(W_bitmap);
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,58 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "../dense/dense.h"
+#include "../sparse/tcsc.h"
+#include "../sparse/tbitmap.h"
+
+int main() {
+    // Test dimensions, K ends in a partial 64-row word
+    int M = 2;     // Number of rows in X
+    int K = 300;   // Columns in X, Rows in W
+    int N = 45;    // Columns in W/Y
+
+    // Initialize matrices
+    dense_t X = init_rand_dense(M, K);
+    dense_t W_dense = init_rand_sparse(K, N, 2); // 1/2 non-zero elements
+    dense_t B = init_rand_dense(N, 1);  // Bias vector
+    dense_t Y = (dense_t)malloc(M * N * sizeof(dense_elem_t));
+    dense_t Y_ref = (dense_t)malloc(M * N * sizeof(dense_elem_t));
+
+    // Convert dense W to bitmap format, directly and through TCSC
+    tbitmap_t* W_bitmap = tbitmap_from_dense(W_dense, K, N);
+    tcsc_t* W_tcsc = tcsc_from_dense(W_dense, K, N);
+    tbitmap_t* W_bitmap_tcsc = tbitmap_from_tcsc(W_tcsc);
+
+    bool passed = W_bitmap->n_elem_pos == W_tcsc->n_elem_pos
+               && W_bitmap->n_elem_neg == W_tcsc->n_elem_neg;
+    for (int i = 0; i < N * W_bitmap->n_words; i++) {
+        passed = passed && W_bitmap->pos[i] == W_bitmap_tcsc->pos[i]
+                        && W_bitmap->neg[i] == W_bitmap_tcsc->neg[i];
+    }
+
+    // Compute reference result using dense GEMM
+    gemm_basic(X, W_dense, B, Y_ref, M, N, K);
+
+    tbitmap_sgemm_basic(X, W_bitmap, B, Y, M, N, K);
+    passed = compare(Y, Y_ref, M, N) && passed;
+    tbitmap_sgemm(X, W_bitmap, B, Y, M, N, K);
+    passed = compare(Y, Y_ref, M, N) && passed;
+
+    // Compare results
+    if (passed) {
+        printf("Test passed! Results match.\n");
+    } else {
+        printf("Test failed! Results don't match.\n");
+    }
+
+    // Free memory
+    free(X);
+    free(W_dense);
+    free(B);
+    free(Y);
+    free(Y_ref);
+    tcsc_free(W_tcsc);
+    tbitmap_free(W_bitmap);
+    tbitmap_free(W_bitmap_tcsc);
+
+    return passed ? 0 : 1;
+}
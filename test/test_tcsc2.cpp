@@ -0,0 +1,57 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "../dense/dense.h"
+#include "../sparse/tcsc.h"
+#include "../sparse/tcsc2.h"
+
+int main() {
+    // Test dimensions, deliberately not multiples of the SIMD width
+    int M = 3;     // Number of rows in X
+    int K = 517;   // Columns in X, Rows in W
+    int N = 131;   // Columns in W/Y
+
+    // Initialize matrices
+    dense_t X = init_rand_dense(M, K);
+    dense_t W_dense = init_rand_sparse(K, N, 16); // 1/16 non-zero elements
+    dense_t B = init_rand_dense(N, 1);  // Bias vector
+    dense_t Y = (dense_t)malloc(M * N * sizeof(dense_elem_t));
+    dense_t Y_ref = (dense_t)malloc(M * N * sizeof(dense_elem_t));
+
+    // Convert dense W to single-stream TCSC format
+    tcsc2_t* W_tcsc2 = tcsc2_from_dense(W_dense, K, N);
+
+    // every -1 entry of a column has to come after the split offset
+    bool layout_ok = true;
+    for (int n = 0; n < N; n++) {
+        for (int k = W_tcsc2->col_ptr[2 * n]; k < W_tcsc2->col_ptr[2 * n + 2]; k++) {
+            bool is_neg = W_tcsc2->row_index[k] & TCSC2_SIGN_BIT;
+            layout_ok = layout_ok && (is_neg == (k >= W_tcsc2->col_ptr[2 * n + 1]));
+        }
+    }
+
+    // Compute reference result using dense GEMM
+    gemm_basic(X, W_dense, B, Y_ref, M, N, K);
+
+    // Compute result using both single-stream kernels
+    tcsc2_sgemm_basic(X, W_tcsc2, B, Y, M, N, K);
+    bool basic_ok = compare(Y, Y_ref, M, N);
+    tcsc2_sgemm(X, W_tcsc2, B, Y, M, N, K);
+    bool simd_ok = compare(Y, Y_ref, M, N);
+
+    // Compare results
+    if (layout_ok && basic_ok && simd_ok) {
+        printf("Test passed! Results match.\n");
+    } else {
+        printf("Test failed! layout=%d basic=%d simd=%d\n", layout_ok, basic_ok, simd_ok);
+    }
+
+    // Free memory
+    free(X);
+    free(W_dense);
+    free(B);
+    free(Y);
+    free(Y_ref);
+    tcsc2_free(W_tcsc2);
+
+    return (layout_ok && basic_ok && simd_ok) ? 0 : 1;
+}
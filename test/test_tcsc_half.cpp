@@ -0,0 +1,75 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <initializer_list>
+#include "../dense/dense.h"
+#include "../sparse/tcsc.h"
+#include "../sparse/tcsc_half.h"
+
+// Runs both half kernels and checks them against the float kernel on the
+// X values after rounding to the half format
+static bool check(int M, int K, int N, tcsc_half_t fmt) {
+    dense_t X = init_rand_dense(M, K);
+    dense_t W_dense = init_rand_sparse(K, N, 4); // 1/4 non-zero elements
+    dense_t B = init_rand_dense(N, 1);  // Bias vector
+    dense_t X_round = (dense_t)malloc(M * K * sizeof(dense_elem_t));
+    dense_t Y = (dense_t)malloc(M * N * sizeof(dense_elem_t));
+    dense_t Y_ref = (dense_t)malloc(M * N * sizeof(dense_elem_t));
+    uint16_t *Xh = (uint16_t*)malloc(M * K * sizeof(uint16_t));
+    uint16_t *Yh = (uint16_t*)malloc(M * N * sizeof(uint16_t));
+
+    tcsc_t* W_tcsc = tcsc_from_dense(W_dense, K, N);
+    tcsc_to_half(X, M * K, fmt, Xh);
+    tcsc_from_half(Xh, M * K, fmt, X_round);
+    tcsc_sgemm_optimized(X_round, W_tcsc, B, Y_ref, M, N, K);
+
+    tcsc_sgemm_half(Xh, fmt, W_tcsc, B, Y, M, N, K);
+    bool passed = compare(Y, Y_ref, M, N);
+
+    // half output within one rounding step of the float result
+    float eps = (fmt == TCSC_BF16) ? 1.0f / 128 : 1.0f / 1024;
+    tcsc_sgemm_half_out(Xh, fmt, W_tcsc, B, Yh, M, N, K);
+    tcsc_from_half(Yh, M * N, fmt, Y);
+    for (int i = 0; i < M * N; ++i) {
+        passed = passed && fabsf(Y[i] - Y_ref[i]) <= eps * fabsf(Y_ref[i]) + 1e-4f;
+    }
+
+    free(X); free(W_dense); free(B); free(X_round); free(Y); free(Y_ref);
+    free(Xh); free(Yh);
+    tcsc_free(W_tcsc);
+    return passed;
+}
+
+int main() {
+    bool passed = true;
+
+    // conversions: exact values, ties to even, overflow and subnormals
+    const float in[] = {1.0f, -2.5f, 65504.0f, 65520.0f, 1.0f + 1.0f / 2048, 1.0f + 3.0f / 2048, 5.9604645e-8f, 0.0f};
+    const uint16_t fp16[] = {0x3c00, 0xc100, 0x7bff, 0x7c00, 0x3c00, 0x3c02, 0x0001, 0x0000};
+    const uint16_t bf16[] = {0x3f80, 0xc020, 0x4780, 0x4780, 0x3f80, 0x3f80, 0x3380, 0x0000};
+    uint16_t h[8];
+    tcsc_to_half(in, 8, TCSC_FP16, h);
+    for (int i = 0; i < 8; ++i) passed = passed && h[i] == fp16[i];
+    tcsc_to_half(in, 8, TCSC_BF16, h);
+    for (int i = 0; i < 8; ++i) passed = passed && h[i] == bf16[i];
+    float back[8];
+    tcsc_from_half(fp16, 8, TCSC_FP16, back);
+    passed = passed && back[0] == 1.0f && back[1] == -2.5f && back[2] == 65504.0f && back[3] > 65504.0f;
+    passed = passed && back[6] == 5.9604645e-8f;
+
+    // scalar kernel (M < 8), the AVX2 and AVX-512 panels with a row tail
+    for (tcsc_half_t fmt : {TCSC_FP16, TCSC_BF16}) {
+        passed = check(3, 517, 131, fmt) && passed;
+        passed = check(13, 517, 131, fmt) && passed;
+        passed = check(40, 517, 131, fmt) && passed;
+    }
+
+    // Compare results
+    if (passed) {
+        printf("Test passed! Results match.\n");
+    } else {
+        printf("Test failed! Results don't match.\n");
+    }
+
+    return passed ? 0 : 1;
+}
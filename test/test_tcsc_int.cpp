@@ -0,0 +1,93 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "../dense/dense.h"
+#include "../sparse/tcsc.h"
+#include "../sparse/tcsc_int.h"
+
+// Quantizes X, runs the integer kernels and checks them against the float
+// TCSC kernel on the dequantized X, which sees exactly the same values
+static bool check(int M, int K, int N, bool scaled) {
+    dense_t X = init_rand_dense(M, K);
+    dense_t W_dense = init_rand_sparse(K, N, 4); // 1/4 non-zero elements
+    dense_t B = init_rand_dense(N, 1);  // Bias vector
+    dense_t col_scale = init_rand_dense(N, 1);
+    dense_t X_deq = (dense_t)malloc(M * K * sizeof(dense_elem_t));
+    dense_t Y = (dense_t)malloc(M * N * sizeof(dense_elem_t));
+    dense_t Y_ref = (dense_t)malloc(M * N * sizeof(dense_elem_t));
+    int8_t *X8 = (int8_t*)malloc(M * K);
+    int16_t *X16 = (int16_t*)malloc(M * K * sizeof(int16_t));
+    int8_t *Q = (int8_t*)malloc(M * N);
+
+    tcsc_t* W_tcsc = tcsc_from_dense(W_dense, K, N);
+    if (scaled) tcsc_set_col_scale(W_tcsc, col_scale);
+    bool passed = true;
+
+    tcsc_qparams_t q8 = tcsc_quant_params(X, M * K, 8);
+    tcsc_quantize_s8(X, M * K, q8, X8);
+    for (int i = 0; i < M * K; ++i) X_deq[i] = q8.scale * (X8[i] - q8.zero_point);
+    tcsc_sgemm_scaled(X_deq, W_tcsc, B, Y_ref, M, N, K);
+    tcsc_gemm_s8(X8, q8, W_tcsc, B, Y, M, N, K);
+    passed = compare(Y, Y_ref, M, N) && passed;
+
+    // requantized output may differ by one step at rounding boundaries
+    tcsc_qparams_t qy = tcsc_quant_params(Y_ref, M * N, 8);
+    tcsc_gemm_s8_q8(X8, q8, W_tcsc, B, qy, Q, M, N, K);
+    for (int i = 0; i < M * N; ++i) {
+        float q = fminf(fmaxf(rintf(Y_ref[i] / qy.scale) + qy.zero_point, -128.0f), 127.0f);
+        passed = passed && fabsf(Q[i] - q) <= 1.0f;
+    }
+
+    tcsc_qparams_t q16 = tcsc_quant_params(X, M * K, 16);
+    tcsc_quantize_s16(X, M * K, q16, X16);
+    for (int i = 0; i < M * K; ++i) X_deq[i] = q16.scale * (X16[i] - q16.zero_point);
+    tcsc_sgemm_scaled(X_deq, W_tcsc, B, Y_ref, M, N, K);
+    tcsc_gemm_s16(X16, q16, W_tcsc, B, Y, M, N, K);
+    passed = compare(Y, Y_ref, M, N) && passed;
+
+    free(X); free(W_dense); free(B); free(col_scale); free(X_deq);
+    free(Y); free(Y_ref); free(X8); free(X16); free(Q);
+    tcsc_free(W_tcsc);
+    return passed;
+}
+
+int main() {
+    bool passed = true;
+
+    // scalar kernel (M < 8), the AVX2 and AVX-512 panels with a row tail
+    passed = check(3, 517, 131, false) && passed;
+    passed = check(19, 517, 131, true) && passed;
+    passed = check(40, 517, 131, true) && passed;
+
+    // one all +1 and one all -1 column of saturated int8 values: the int16
+    // partial sums have to be widened before they overflow
+    int M = 40, K = 2000, N = 2;
+    dense_t W_dense = (dense_t)malloc(K * N * sizeof(dense_elem_t));
+    for (int k = 0; k < K; ++k) {
+        W_dense[k * N] = 1.0f;
+        W_dense[k * N + 1] = -1.0f;
+    }
+    tcsc_t* W_tcsc = tcsc_from_dense(W_dense, K, N);
+    int8_t *X8 = (int8_t*)malloc(M * K);
+    for (int i = 0; i < M * K; ++i) X8[i] = (i % K < K / 2) ? 127 : -128;
+    float B[2] = {0.0f, 0.0f}, Y[40 * 2];
+    tcsc_qparams_t unit = {1.0f, 0};
+    tcsc_gemm_s8(X8, unit, W_tcsc, B, Y, M, N, K);
+    float expected = (K / 2) * 127.0f - (K / 2) * 128.0f;
+    for (int m = 0; m < M; ++m) {
+        passed = passed && Y[m * N] == expected && Y[m * N + 1] == -expected;
+    }
+
+    // Compare results
+    if (passed) {
+        printf("Test passed! Results match.\n");
+    } else {
+        printf("Test failed! Results don't match.\n");
+    }
+
+    free(W_dense);
+    free(X8);
+    tcsc_free(W_tcsc);
+
+    return passed ? 0 : 1;
+}
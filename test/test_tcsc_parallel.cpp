@@ -0,0 +1,85 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "../dense/dense.h"
+#include "../sparse/tcsc.h"
+#include "../sparse/tcsc_parallel.h"
+
+int main() {
+    // Test dimensions, N is not a multiple of the partition alignment
+    int M = 37;    // Number of rows in X, enough for a 2D split
+    int K = 300;   // Columns in X, Rows in W
+    int N = 203;   // Columns in W/Y
+    float a = 0.2f; // PReLU parameter
+
+    // Initialize matrices
+    dense_t X = init_rand_dense(M, K);
+    dense_t W_dense = init_rand_sparse(K, N, 4); // 1/4 non-zero elements
+    dense_t B = init_rand_dense(N, 1);  // Bias vector
+    dense_t Y = (dense_t)malloc(M * N * sizeof(dense_elem_t));
+    dense_t Y_ref = (dense_t)malloc(M * N * sizeof(dense_elem_t));
+    dense_t Y_prelu_ref = (dense_t)malloc(M * N * sizeof(dense_elem_t));
+
+    // Skew the columns: the first third is empty, so equal column counts
+    // would leave some threads without work
+    for (int k = 0; k < K; ++k) {
+        for (int n = 0; n < N / 3; ++n) {
+            W_dense[k * N + n] = 0.0f;
+        }
+    }
+
+    tcsc_t* W_tcsc = tcsc_from_dense(W_dense, K, N);
+
+    // Compute reference results
+    gemm_basic(X, W_dense, B, Y_ref, M, N, K);
+    tcsc_sgemm_prelu_basic(X, W_tcsc, B, a, Y_prelu_ref, M, N, K);
+
+    bool passed = true;
+
+    // Partition boundaries must be monotonic and aligned
+    int bounds[5];
+    tcsc_partition_columns(W_tcsc, 4, TCSC_PAR_ALIGN, bounds);
+    for (int p = 0; p < 4; ++p) {
+        passed = passed && bounds[p] <= bounds[p + 1];
+        passed = passed && (p == 0 || bounds[p] % TCSC_PAR_ALIGN == 0 || bounds[p] == N);
+    }
+    passed = passed && bounds[0] == 0 && bounds[4] == N;
+    printf("partition: %d %d %d %d %d\n", bounds[0], bounds[1], bounds[2], bounds[3], bounds[4]);
+
+    // The result must not depend on the number of threads
+    for (int threads = 1; threads <= 4; ++threads) {
+        tcsc_parallel_set_threads(threads);
+        tcsc_sgemm_parallel(X, W_tcsc, B, Y, M, N, K);
+        passed = compare(Y, Y_ref, M, N) && passed;
+        tcsc_sgemm_prelu_parallel(X, W_tcsc, B, a, Y, 1, N, K);
+        passed = compare(Y, Y_prelu_ref, 1, N) && passed;
+        tcsc_sgemm_prelu_parallel(X, W_tcsc, B, a, Y, M, N, K);
+        passed = compare(Y, Y_prelu_ref, M, N) && passed;
+
+        // Split-K with the tree reduction, also for odd thread counts
+        tcsc_sgemm_parallel_mode(X, W_tcsc, B, Y, M, N, K, TCSC_PAR_SPLIT_K);
+        passed = compare(Y, Y_ref, M, N) && passed;
+        tcsc_sgemm_prelu_parallel_mode(X, W_tcsc, B, a, Y, 1, N, K, TCSC_PAR_SPLIT_K);
+        passed = compare(Y, Y_prelu_ref, 1, N) && passed;
+        tcsc_sgemm_prelu_parallel_mode(X, W_tcsc, B, a, Y, M, N, K, TCSC_PAR_SPLIT_K);
+        passed = compare(Y, Y_prelu_ref, M, N) && passed;
+    }
+    tcsc_parallel_set_threads(0);
+
+    // Compare results
+    if (passed) {
+        printf("Test passed! Results match.\n");
+    } else {
+        printf("Test failed! Results don't match.\n");
+    }
+
+    // Free memory
+    free(X);
+    free(W_dense);
+    free(B);
+    free(Y);
+    free(Y_ref);
+    free(Y_prelu_ref);
+    tcsc_free(W_tcsc);
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,83 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "../dense/dense.h"
+#include "../sparse/tcsc.h"
+
+int main() {
+    // Test dimensions, K is not a multiple of the group size
+    int M = 3;     // Number of rows in X
+    int K = 300;   // Columns in X, Rows in W
+    int N = 67;    // Columns in W/Y
+    int G = 64;    // rows per scale group
+    int n_groups = (K + G - 1) / G;
+
+    // Initialize matrices
+    dense_t X = init_rand_dense(M, K);
+    dense_t W_dense = init_rand_sparse(K, N, 4); // 1/4 non-zero elements
+    dense_t B = init_rand_dense(N, 1);  // Bias vector
+    dense_t alpha = init_rand_dense(N, 1); // per-channel slopes
+    dense_t col_scale = init_rand_dense(N, 1);
+    dense_t group_scale = init_rand_dense(N * n_groups, 1);
+    dense_t W_scaled = (dense_t)malloc(K * N * sizeof(dense_elem_t));
+    dense_t Y = (dense_t)malloc(M * N * sizeof(dense_elem_t));
+    dense_t Y_ref = (dense_t)malloc(M * N * sizeof(dense_elem_t));
+
+    tcsc_t* W_tcsc = tcsc_from_dense(W_dense, K, N);
+    bool passed = true;
+
+    // without scales the kernels reduce to the plain TCSC GEMM
+    gemm_basic(X, W_dense, B, Y_ref, M, N, K);
+    tcsc_sgemm_scaled(X, W_tcsc, B, Y, M, N, K);
+    passed = compare(Y, Y_ref, M, N) && passed;
+
+    // column scales: reference on the dense matrix with scaled columns
+    for (int k = 0; k < K; ++k)
+        for (int n = 0; n < N; ++n)
+            W_scaled[k * N + n] = W_dense[k * N + n] * col_scale[n];
+    gemm_basic(X, W_scaled, B, Y_ref, M, N, K);
+    passed = (tcsc_set_col_scale(W_tcsc, col_scale) == 0) && passed;
+    tcsc_sgemm_scaled(X, W_tcsc, B, Y, M, N, K);
+    passed = compare(Y, Y_ref, M, N) && passed;
+
+    for (int i = 0; i < M * N; ++i) {
+        float v = Y_ref[i];
+        Y_ref[i] = (v < 0.0f) ? alpha[i % N] * v : v;
+    }
+    tcsc_sgemm_prelu_channel(X, W_tcsc, B, alpha, Y, M, N, K);
+    passed = compare(Y, Y_ref, M, N) && passed;
+
+    // group scales replace the column scales
+    for (int k = 0; k < K; ++k)
+        for (int n = 0; n < N; ++n)
+            W_scaled[k * N + n] = W_dense[k * N + n] * group_scale[n * n_groups + k / G];
+    gemm_basic(X, W_scaled, B, Y_ref, M, N, K);
+    for (int i = 0; i < M * N; ++i) {
+        float v = Y_ref[i];
+        Y_ref[i] = (v < 0.0f) ? alpha[i % N] * v : v;
+    }
+    passed = (tcsc_set_group_scale(W_tcsc, G, group_scale) == 0) && passed;
+    passed = (W_tcsc->col_scale == NULL) && passed;
+    tcsc_sgemm_prelu_channel(X, W_tcsc, B, alpha, Y, M, N, K);
+    passed = compare(Y, Y_ref, M, N) && passed;
+
+    // Compare results
+    if (passed) {
+        printf("Test passed! Results match.\n");
+    } else {
+        printf("Test failed! Results don't match.\n");
+    }
+
+    // Free memory
+    free(X);
+    free(W_dense);
+    free(B);
+    free(alpha);
+    free(col_scale);
+    free(group_scale);
+    free(W_scaled);
+    free(Y);
+    free(Y_ref);
+    tcsc_free(W_tcsc);
+
+    return passed ? 0 : 1;
+}
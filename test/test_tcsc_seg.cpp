@@ -0,0 +1,63 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "../dense/dense.h"
+#include "../sparse/tcsc.h"
+#include "../sparse/tcsc_seg.h"
+
+int main() {
+    // Test dimensions, K spans several 256-row panels plus a partial one
+    int M = 11;    // Number of rows in X, one full and one partial 8-row tile
+    int K = 700;   // Columns in X, Rows in W
+    int N = 97;    // Columns in W/Y
+    float a = 0.2f; // PReLU parameter
+
+    // Initialize matrices
+    dense_t X = init_rand_dense(M, K);
+    dense_t W_dense = init_rand_sparse(K, N, 4); // 1/4 non-zero elements
+    dense_t B = init_rand_dense(N, 1);  // Bias vector
+    dense_t Y = (dense_t)malloc(M * N * sizeof(dense_elem_t));
+    dense_t Y_ref = (dense_t)malloc(M * N * sizeof(dense_elem_t));
+    dense_t Y_prelu_ref = (dense_t)malloc(M * N * sizeof(dense_elem_t));
+
+    // Convert dense W to TCSC and then to both segmented variants
+    tcsc_t* W_tcsc = tcsc_from_dense(W_dense, K, N);
+    tcsc_seg_t* W_seg8 = tcsc_seg_from_tcsc(W_tcsc, TCSC_SEG_ROWS_U8);
+    tcsc_seg_t* W_seg16 = tcsc_seg_from_tcsc(W_tcsc, TCSC_SEG_ROWS_U16);
+
+    // Compute reference results
+    gemm_basic(X, W_dense, B, Y_ref, M, N, K);
+    tcsc_sgemm_prelu_basic(X, W_tcsc, B, a, Y_prelu_ref, M, N, K);
+
+    bool passed = true;
+    tcsc_seg_sgemm(X, W_seg8, B, Y, M, N, K);
+    passed = compare(Y, Y_ref, M, N) && passed;
+    tcsc_seg_sgemm(X, W_seg16, B, Y, M, N, K);
+    passed = compare(Y, Y_ref, M, N) && passed;
+    tcsc_seg_sgemm_prelu(X, W_seg8, B, a, Y, M, N, K);
+    passed = compare(Y, Y_prelu_ref, M, N) && passed;
+
+    printf("bytes/nnz: tcsc=%.2f seg8=%.2f seg16=%.2f\n",
+        (double) tcsc_bytes(W_tcsc) / (W_tcsc->n_elem_pos + W_tcsc->n_elem_neg),
+        (double) tcsc_seg_bytes(W_seg8) / (W_tcsc->n_elem_pos + W_tcsc->n_elem_neg),
+        (double) tcsc_seg_bytes(W_seg16) / (W_tcsc->n_elem_pos + W_tcsc->n_elem_neg));
+
+    // Compare results
+    if (passed) {
+        printf("Test passed! Results match.\n");
+    } else {
+        printf("Test failed! Results don't match.\n");
+    }
+
+    // Free memory
+    free(X);
+    free(W_dense);
+    free(B);
+    free(Y);
+    free(Y_ref);
+    free(Y_prelu_ref);
+    tcsc_free(W_tcsc);
+    tcsc_seg_free(W_seg8);
+    tcsc_seg_free(W_seg16);
+
+    return passed ? 0 : 1;
+}
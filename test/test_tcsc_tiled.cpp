@@ -0,0 +1,69 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "../dense/dense.h"
+#include "../sparse/tcsc.h"
+
+int main() {
+    // Test dimensions, two and a bit tiles in every dimension so that each
+    // driver loop ends on a partial tile. nb and kb depend on the detected
+    // cache sizes, so N and K are derived from them.
+    int M = 2 * 32 + 5;  // Number of rows in X
+    tcsc_tiles_t big = tcsc_choose_tiles(M, 1 << 20, 1 << 20);
+    int K = 2 * big.kb + 29;  // Columns in X, Rows in W
+    int N = 2 * big.nb + 13;  // Columns in W/Y
+    float a = 0.2f; // PReLU parameter
+
+    // tiles are clipped to the shape and otherwise whole cache lines of Y
+    // and whole 64-row panels
+    bool tiles_ok = big.mb == 32 && big.nb % 16 == 0 && big.kb % 64 == 0;
+    tcsc_tiles_t tiles = tcsc_choose_tiles(M, N, K);
+    tiles_ok = tiles_ok && tiles.mb == big.mb && tiles.nb == big.nb && tiles.kb == big.kb;
+    tiles_ok = tiles_ok && N % tiles.nb != 0 && K % tiles.kb != 0;
+    tcsc_tiles_t small = tcsc_choose_tiles(3, 10, 50);
+    tiles_ok = tiles_ok && small.mb == 3 && small.nb == 10 && small.kb == 50;
+
+    // Initialize matrices
+    dense_t X = init_rand_dense(M, K);
+    // K spans several panels, a sparse W keeps the column sums (and the
+    // rounding of the different summation orders) within compare()'s
+    // tolerance
+    dense_t W_dense = init_rand_sparse(K, N, 256); // 1/256 non-zero elements
+    dense_t B = init_rand_dense(N, 1);  // Bias vector
+    dense_t Y = (dense_t)malloc((size_t) M * N * sizeof(dense_elem_t));
+    dense_t Y_ref = (dense_t)malloc((size_t) M * N * sizeof(dense_elem_t));
+    dense_t Y_prelu_ref = (dense_t)malloc((size_t) M * N * sizeof(dense_elem_t));
+
+    // Convert dense W to TCSC format
+    tcsc_t* W_tcsc = tcsc_from_dense(W_dense, K, N);
+
+    // Compute reference results using dense GEMM
+    gemm_basic(X, W_dense, B, Y_ref, M, N, K);
+    for (int i = 0; i < M * N; i++) {
+        Y_prelu_ref[i] = (Y_ref[i] < 0.0f) ? a * Y_ref[i] : Y_ref[i];
+    }
+
+    // Compute results using the cache-blocked drivers
+    tcsc_sgemm_tiled(X, W_tcsc, B, Y, M, N, K);
+    bool tiled_ok = compare(Y, Y_ref, M, N);
+    tcsc_sgemm_prelu_tiled(X, W_tcsc, B, a, Y, M, N, K);
+    bool prelu_ok = compare(Y, Y_prelu_ref, M, N);
+
+    // Compare results
+    bool passed = tiles_ok && tiled_ok && prelu_ok;
+    if (passed) {
+        printf("Test passed! Results match.\n");
+    } else {
+        printf("Test failed! tiles=%d tiled=%d prelu=%d\n", tiles_ok, tiled_ok, prelu_ok);
+    }
+
+    // Free memory
+    free(X);
+    free(W_dense);
+    free(B);
+    free(Y);
+    free(Y_ref);
+    free(Y_prelu_ref);
+    tcsc_free(W_tcsc);
+
+    return passed ? 0 : 1;
+}
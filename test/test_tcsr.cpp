@@ -0,0 +1,106 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <initializer_list>
+#include "../dense/dense.h"
+#include "../sparse/tcsc.h"
+#include "../sparse/tcsr.h"
+
+int main() {
+    // Test dimensions
+    int M = 5;     // Number of rows in X
+    int K = 300;   // Columns in X, Rows in W
+    int N = 203;   // Columns in W/Y
+
+    dense_t W_dense = init_rand_sparse(K, N, 4); // 1/4 non-zero elements
+    dense_t B = init_rand_dense(N, 1);  // Bias vector
+    dense_t Y = (dense_t)malloc(M * N * sizeof(dense_elem_t));
+    dense_t Y_ref = (dense_t)malloc(M * N * sizeof(dense_elem_t));
+
+    tcsc_t* W_tcsc = tcsc_from_dense(W_dense, K, N);
+    tcsr_t* W_tcsr = tcsr_from_dense(W_dense, K, N);
+    tcsr_t* W_trans = tcsr_from_tcsc(W_tcsc);
+
+    bool passed = true;
+
+    // Both constructions give the same arrays
+    passed = passed && W_trans->n_elem_pos == W_tcsr->n_elem_pos;
+    passed = passed && W_trans->n_elem_neg == W_tcsr->n_elem_neg;
+    for (int k = 0; passed && k <= K; ++k) {
+        passed = W_trans->row_start_pos[k] == W_tcsr->row_start_pos[k] &&
+                 W_trans->row_start_neg[k] == W_tcsr->row_start_neg[k];
+    }
+    for (int i = 0; passed && i < W_tcsr->n_elem_pos; ++i)
+        passed = W_trans->col_index_pos[i] == W_tcsr->col_index_pos[i];
+    for (int i = 0; passed && i < W_tcsr->n_elem_neg; ++i)
+        passed = W_trans->col_index_neg[i] == W_tcsr->col_index_neg[i];
+
+    // All-zero, sparse and dense activations, forcing both sides of the
+    // automatic selection
+    for (float density : {0.0f, 0.05f, 1.0f}) {
+        dense_t X = init_rand_dense_density(M, K, density);
+        gemm_basic(X, W_dense, B, Y_ref, M, N, K);
+
+        tcsr_sgemm_sparse_x(X, W_trans, B, Y, M, N, K);
+        passed = compare(Y, Y_ref, M, N) && passed;
+
+        for (float threshold : {0.0f, 2.0f}) {
+            tcsr_set_x_density_threshold(threshold);
+            tcsr_sgemm_auto(X, W_tcsc, W_tcsr, B, Y, M, N, K);
+            passed = compare(Y, Y_ref, M, N) && passed;
+        }
+        free(X);
+    }
+
+    // Dense X through the outer-product kernels, M covers the scalar path,
+    // a full AVX2 panel plus tail and AVX-512 panels plus tail
+    float a = 0.2f; // PReLU parameter
+    for (int rows : {M, 11, 37}) {
+        dense_t X = init_rand_dense(rows, K);
+        dense_t Y_big = (dense_t)malloc(rows * N * sizeof(dense_elem_t));
+        dense_t Y_lin = (dense_t)malloc(rows * N * sizeof(dense_elem_t));
+        gemm_basic(X, W_dense, B, Y_lin, rows, N, K);
+
+        tcsr_sgemm_basic(X, W_tcsr, B, Y_big, rows, N, K);
+        passed = compare(Y_big, Y_lin, rows, N) && passed;
+        tcsr_sgemm(X, W_tcsr, B, Y_big, rows, N, K);
+        passed = compare(Y_big, Y_lin, rows, N) && passed;
+#ifdef __x86_64__
+        if (__builtin_cpu_supports("avx2")) {
+            tcsr_sgemm_avx2(X, W_tcsr, B, Y_big, rows, N, K);
+            passed = compare(Y_big, Y_lin, rows, N) && passed;
+        }
+        if (__builtin_cpu_supports("avx512f")) {
+            tcsr_sgemm_avx512(X, W_tcsr, B, Y_big, rows, N, K);
+            passed = compare(Y_big, Y_lin, rows, N) && passed;
+        }
+#endif
+
+        for (int i = 0; i < rows * N; ++i) Y_lin[i] = (Y_lin[i] < 0.0f) ? a * Y_lin[i] : Y_lin[i];
+        tcsr_sgemm_prelu_basic(X, W_tcsr, B, a, Y_big, rows, N, K);
+        passed = compare(Y_big, Y_lin, rows, N) && passed;
+        tcsr_sgemm_prelu(X, W_tcsr, B, a, Y_big, rows, N, K);
+        passed = compare(Y_big, Y_lin, rows, N) && passed;
+
+        free(X);
+        free(Y_big);
+        free(Y_lin);
+    }
+
+    // Compare results
+    if (passed) {
+        printf("Test passed! Results match.\n");
+    } else {
+        printf("Test failed! Results don't match.\n");
+    }
+
+    // Free memory
+    free(W_dense);
+    free(B);
+    free(Y);
+    free(Y_ref);
+    tcsc_free(W_tcsc);
+    tcsr_free(W_tcsr);
+    tcsr_free(W_trans);
+
+    return passed ? 0 : 1;
+}
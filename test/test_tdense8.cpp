@@ -0,0 +1,66 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "../dense/dense.h"
+#include "../sparse/tcsc.h"
+#include "../sparse/tcsc_int.h"
+#include "../sparse/tdense8.h"
+
+int main() {
+    // Test dimensions, K is not a multiple of 4 and M not of 4
+    int M = 5;     // Number of rows in X
+    int K = 517;   // Columns in X, Rows in W
+    int N = 131;   // Columns in W/Y
+
+    // Initialize matrices
+    dense_t X = init_rand_dense(M, K);
+    dense_t W_dense = init_rand_sparse(K, N, 2); // 1/2 non-zero elements
+    dense_t B = init_rand_dense(N, 1);  // Bias vector
+    dense_t Y = (dense_t)malloc(M * N * sizeof(dense_elem_t));
+    dense_t Y_ref = (dense_t)malloc(M * N * sizeof(dense_elem_t));
+    int8_t *X8 = (int8_t*)malloc(M * K);
+
+    tcsc_qparams_t xq = tcsc_quant_params(X, M * K, 8);
+    tcsc_quantize_s8(X, M * K, xq, X8);
+
+    // the int8 TCSC kernel computes the same integer sums
+    tcsc_t* W_tcsc = tcsc_from_dense(W_dense, K, N);
+    tdense8_t* W_dense8 = tdense8_from_dense(W_dense, K, N);
+    tcsc_gemm_s8(X8, xq, W_tcsc, B, Y_ref, M, N, K);
+
+    bool passed = true;
+    tdense8_gemm_s8(X8, xq, W_dense8, B, Y, M, N, K);
+    passed = compare(Y, Y_ref, M, N) && passed;
+#ifdef __x86_64__
+    if (__builtin_cpu_supports("avx2")) {
+        tdense8_gemm_s8_avx2(X8, xq, W_dense8, B, Y, M, N, K);
+        passed = compare(Y, Y_ref, M, N) && passed;
+    }
+    if (__builtin_cpu_supports("avxvnni")) {
+        tdense8_gemm_s8_avxvnni(X8, xq, W_dense8, B, Y, M, N, K);
+        passed = compare(Y, Y_ref, M, N) && passed;
+    }
+    if (__builtin_cpu_supports("avx512vnni")) {
+        tdense8_gemm_s8_avx512vnni(X8, xq, W_dense8, B, Y, M, N, K);
+        passed = compare(Y, Y_ref, M, N) && passed;
+    }
+#endif
+
+    // Compare results
+    if (passed) {
+        printf("Test passed! Results match (%s).\n", tdense8_isa());
+    } else {
+        printf("Test failed! Results don't match.\n");
+    }
+
+    // Free memory
+    free(X);
+    free(W_dense);
+    free(B);
+    free(Y);
+    free(Y_ref);
+    free(X8);
+    tcsc_free(W_tcsc);
+    tdense8_free(W_dense8);
+
+    return passed ? 0 : 1;
+}
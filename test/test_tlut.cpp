@@ -0,0 +1,62 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "../dense/dense.h"
+#include "../sparse/tcsc.h"
+#include "../sparse/tlut.h"
+
+int main() {
+    // Test dimensions, K not a multiple of any group size
+    int M = 2;     // Number of rows in X
+    int K = 301;   // Columns in X, Rows in W
+    int N = 37;    // Columns in W/Y
+
+    // Initialize matrices
+    dense_t X = init_rand_dense(M, K);
+    dense_t W_dense = init_rand_sparse(K, N, 2); // 1/2 non-zero elements
+    dense_t B = init_rand_dense(N, 1);  // Bias vector
+    dense_t Y = (dense_t)malloc(M * N * sizeof(dense_elem_t));
+    dense_t Y_ref = (dense_t)malloc(M * N * sizeof(dense_elem_t));
+
+    tcsc_t* W_tcsc = tcsc_from_dense(W_dense, K, N);
+
+    // Compute reference result using dense GEMM
+    gemm_basic(X, W_dense, B, Y_ref, M, N, K);
+
+    bool passed = true;
+    for (int g = TLUT_MIN_GROUP; g <= TLUT_MAX_GROUP; g++) {
+        // Convert dense W to the packed format, directly and through TCSC
+        tlut_t* W_lut = tlut_from_dense(W_dense, K, N, g);
+        tlut_t* W_lut_tcsc = tlut_from_tcsc(W_tcsc, g);
+        for (size_t i = 0; i < tlut_bytes(W_lut); i++) {
+            passed = passed && W_lut->code[i] == W_lut_tcsc->code[i];
+        }
+        // one byte per group, plus the padding of the last group
+        double bits = tlut_bits_per_weight(W_lut);
+        passed = passed && bits >= 8.0 / g && bits < 8.0 / g + 0.05;
+
+        tlut_sgemm_basic(X, W_lut, B, Y, M, N, K);
+        passed = compare(Y, Y_ref, M, N) && passed;
+        tlut_sgemm(X, W_lut, B, Y, M, N, K);
+        passed = compare(Y, Y_ref, M, N) && passed;
+
+        tlut_free(W_lut);
+        tlut_free(W_lut_tcsc);
+    }
+
+    // Compare results
+    if (passed) {
+        printf("Test passed! Results match.\n");
+    } else {
+        printf("Test failed! Results don't match.\n");
+    }
+
+    // Free memory
+    free(X);
+    free(W_dense);
+    free(B);
+    free(Y);
+    free(Y_ref);
+    tcsc_free(W_tcsc);
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,134 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <atomic>
+#include "../dense/dense.h"
+#include "../sparse/tcsc.h"
+#include "../sparse/tcsc_parallel.h"
+#include "../sparse/bcsr.h"
+#include "../sparse/tpool.h"
+
+// Counts how often every task index ran
+static void count_task(void *arg, int task) {
+    std::atomic<int> *counts = (std::atomic<int>*) arg;
+    counts[task].fetch_add(1);
+}
+
+// Records the pool thread that ran every task
+static void thread_task(void *arg, int task) {
+    ((int*) arg)[task] = tpool_thread_index();
+}
+
+int main() {
+    // Test dimensions
+    int M = 3;     // Number of rows in X
+    int K = 512;   // Columns in X, Rows in W
+    int N = 1024;  // Columns in W/Y
+    float a = 0.2f; // PReLU parameter
+
+    // Initialize matrices
+    dense_t X = init_rand_dense(M, K);
+    dense_t W_dense = init_rand_sparse(K, N, 4); // 1/4 non-zero elements
+    dense_t B = init_rand_dense(N, 1);  // Bias vector
+    dense_t Y = (dense_t)malloc(M * N * sizeof(dense_elem_t));
+    dense_t Y_ref = (dense_t)malloc(M * N * sizeof(dense_elem_t));
+    dense_t Y_prelu_ref = (dense_t)malloc(M * N * sizeof(dense_elem_t));
+
+    tcsc_t* W_tcsc = tcsc_from_dense(W_dense, K, N);
+    bcsr_t* W_bcsr = bcsr_from_dense(W_dense, K, N, 1, 8);
+
+    // Two block columns of 4 x 32 blocks, too few to split between more
+    // than two threads
+    int N_narrow = 40;
+    dense_t W_narrow_dense = init_rand_sparse(K, N_narrow, 4);
+    dense_t Y_narrow = (dense_t)malloc(M * N_narrow * sizeof(dense_elem_t));
+    dense_t Y_narrow_ref = (dense_t)malloc(M * N_narrow * sizeof(dense_elem_t));
+    bcsr_t* W_narrow = bcsr_from_dense(W_narrow_dense, K, N_narrow, 4, 32);
+    gemm_basic(X, W_narrow_dense, B, Y_narrow_ref, M, N_narrow, K);
+
+    // Compute reference results
+    gemm_basic(X, W_dense, B, Y_ref, M, N, K);
+    tcsc_sgemm_prelu_basic(X, W_tcsc, B, a, Y_prelu_ref, M, N, K);
+
+    bool passed = true;
+    for (int threads = 1; threads <= 4; ++threads) {
+        tpool_t *pool = tpool_create(threads, false);
+        passed = passed && pool && tpool_threads(pool) == threads;
+        if (!pool) break;
+
+        // Many back-to-back runs, every task must run exactly once per run
+        const int runs = 2000, ntasks = 7;
+        std::atomic<int> counts[ntasks];
+        for (int t = 0; t < ntasks; ++t) counts[t].store(0);
+        for (int run = 0; run < runs; ++run) {
+            tpool_run(pool, count_task, counts, ntasks);
+        }
+        for (int t = 0; t < ntasks; ++t) {
+            passed = passed && counts[t].load() == runs;
+        }
+        int ran_on[ntasks];
+        tpool_run(pool, thread_task, ran_on, ntasks);
+        for (int t = 0; t < ntasks; ++t) {
+            passed = passed && ran_on[t] >= 0 && ran_on[t] < threads;
+        }
+
+        tcsc_sgemm_pool(pool, X, W_tcsc, B, Y, M, N, K);
+        passed = compare(Y, Y_ref, M, N) && passed;
+        tcsc_sgemm_prelu_pool(pool, X, W_tcsc, B, a, Y, M, N, K);
+        passed = compare(Y, Y_prelu_ref, M, N) && passed;
+        bcsr_sgemm_pool(pool, X, *W_bcsr, B, Y, M, N, K);
+        passed = compare(Y, Y_ref, M, N) && passed;
+
+        // the parallel engine splits wide W by block columns and narrow W
+        // by block rows with private copies of Y
+        bcsr_par_t *P = bcsr_par_create(W_bcsr, pool);
+        passed = passed && P && (threads < 2 || P->mode == BCSR_PAR_COLUMNS);
+        if (P) {
+            // twice, the second run reuses the packed X of the plan
+            for (int run = 0; run < 2; ++run) {
+                bcsr_sgemm_par(pool, P, X, B, Y, M, N, K);
+                passed = compare(Y, Y_ref, M, N) && passed;
+            }
+        }
+        bcsr_par_free(P);
+        P = bcsr_par_create(W_narrow, pool);
+        passed = passed && P && (threads < 3 || P->mode == BCSR_PAR_ROWS);
+        if (P) {
+            for (int run = 0; run < 2; ++run) {
+                bcsr_sgemm_par(pool, P, X, B, Y_narrow, M, N_narrow, K);
+                passed = compare(Y_narrow, Y_narrow_ref, M, N_narrow) && passed;
+            }
+        }
+        bcsr_par_free(P);
+
+        tpool_free(pool);
+    }
+
+    // Compare results
+    if (passed) {
+        printf("Test passed! Results match.\n");
+    } else {
+        printf("Test failed! Results don't match.\n");
+    }
+
+    // Free memory
+    free(X);
+    free(W_dense);
+    free(B);
+    free(Y);
+    free(Y_ref);
+    free(Y_prelu_ref);
+    tcsc_free(W_tcsc);
+    free(W_bcsr->b_values);
+    free(W_bcsr->b_row_start);
+    free(W_bcsr->b_col_idx);
+    free(W_bcsr);
+    free(W_narrow_dense);
+    free(Y_narrow);
+    free(Y_narrow_ref);
+    free(W_narrow->b_values);
+    free(W_narrow->b_row_start);
+    free(W_narrow->b_col_idx);
+    free(W_narrow);
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,80 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <initializer_list>
+#include "../dense/dense.h"
+#include "../sparse/tcsc.h"
+#include "../sparse/tcsc_parallel.h"
+#include "../sparse/bcsr.h"
+#include "../sparse/tpool.h"
+#include "../sparse/tsched.h"
+
+int main() {
+    // Test dimensions, M and N are not multiples of the tile size
+    int M = 45;    // Number of rows in X
+    int K = 256;   // Columns in X, Rows in W
+    int N = 712;   // Columns in W/Y, multiple of the BCSR block width
+
+    // Initialize matrices, column densities follow a heavy tail
+    dense_t X = init_rand_dense(M, K);
+    dense_t W_dense = init_rand_sparse_skewed(K, N, 8, 1.5f);
+    dense_t B = init_rand_dense(N, 1);  // Bias vector
+    dense_t Y = (dense_t)malloc(M * N * sizeof(dense_elem_t));
+    dense_t Y_ref = (dense_t)malloc(M * N * sizeof(dense_elem_t));
+
+    bool passed = true;
+    for (int i = 0; i < K * N; ++i) {
+        passed = passed && (W_dense[i] == 0.0f || W_dense[i] == 1.0f || W_dense[i] == -1.0f);
+    }
+
+    tcsc_t* W_tcsc = tcsc_from_dense(W_dense, K, N);
+    bcsr_t* W_bcsr = bcsr_from_dense(W_dense, K, N, 1, 8);
+
+    // Compute reference result
+    gemm_basic(X, W_dense, B, Y_ref, M, N, K);
+
+    for (int threads = 1; threads <= 4; ++threads) {
+        tpool_t *pool = tpool_create(threads, false);
+        double busy_ns[4];
+
+        for (tsched_mode_t mode : {TSCHED_STATIC, TSCHED_STEAL}) {
+            for (int t = 0; t < threads; ++t) busy_ns[t] = -1.0;
+            tcsc_sgemm_sched(pool, X, W_tcsc, B, Y, M, N, K, mode, busy_ns);
+            passed = compare(Y, Y_ref, M, N) && passed;
+            for (int t = 0; t < threads; ++t) passed = passed && busy_ns[t] >= 0.0;
+
+            // per executing thread, all entries written and some time spent
+            double total = 0.0;
+            for (int t = 0; t < threads; ++t) busy_ns[t] = -1.0;
+            bcsr_sgemm_sched(pool, X, *W_bcsr, B, Y, M, N, K, mode, busy_ns);
+            passed = compare(Y, Y_ref, M, N) && passed;
+            for (int t = 0; t < threads; ++t) {
+                passed = passed && busy_ns[t] >= 0.0;
+                total += busy_ns[t];
+            }
+            passed = passed && total > 0.0;
+        }
+
+        tpool_free(pool);
+    }
+
+    // Compare results
+    if (passed) {
+        printf("Test passed! Results match.\n");
+    } else {
+        printf("Test failed! Results don't match.\n");
+    }
+
+    // Free memory
+    free(X);
+    free(W_dense);
+    free(B);
+    free(Y);
+    free(Y_ref);
+    tcsc_free(W_tcsc);
+    free(W_bcsr->b_values);
+    free(W_bcsr->b_row_start);
+    free(W_bcsr->b_col_idx);
+    free(W_bcsr);
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,61 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <initializer_list>
+#include "../dense/dense.h"
+#include "../sparse/tcsc.h"
+#include "../sparse/tsell.h"
+
+int main() {
+    // Test dimensions, N is not a multiple of 16 for the padded last chunk
+    int M = 3;     // Number of rows in X
+    int K = 256;   // Columns in X, Rows in W
+    int N = 203;   // Columns in W/Y
+
+    // Initialize matrices, skewed columns for uneven chunk lengths
+    dense_t X = init_rand_dense(M, K);
+    dense_t W_dense = init_rand_sparse_skewed(K, N, 4, 1.5f);
+    dense_t B = init_rand_dense(N, 1);  // Bias vector
+    dense_t Y = (dense_t)malloc(M * N * sizeof(dense_elem_t));
+    dense_t Y_ref = (dense_t)malloc(M * N * sizeof(dense_elem_t));
+
+    tcsc_t* W_tcsc = tcsc_from_dense(W_dense, K, N);
+    gemm_basic(X, W_dense, B, Y_ref, M, N, K);
+
+    bool passed = true;
+
+    for (int C : {8, 16}) {
+        // unsorted, sorted windows and one window over all columns
+        for (int sigma : {1, 64, N}) {
+            tsell_t* W_sell = tsell_from_tcsc(W_tcsc, C, sigma);
+            if (!W_sell) return 1;
+
+            tsell_sgemm_basic(X, W_sell, B, Y, M, N, K);
+            passed = compare(Y, Y_ref, M, N) && passed;
+            tsell_sgemm(X, W_sell, B, Y, M, N, K);
+            passed = compare(Y, Y_ref, M, N) && passed;
+
+            // sorting can only remove padding
+            tsell_t* W_unsorted = tsell_from_tcsc(W_tcsc, C, C);
+            passed = passed && tsell_padding_overhead(W_sell) <= tsell_padding_overhead(W_unsorted);
+            tsell_free(W_unsorted);
+            tsell_free(W_sell);
+        }
+    }
+
+    // Compare results
+    if (passed) {
+        printf("Test passed! Results match.\n");
+    } else {
+        printf("Test failed! Results don't match.\n");
+    }
+
+    // Free memory
+    free(X);
+    free(W_dense);
+    free(B);
+    free(Y);
+    free(Y_ref);
+    tcsc_free(W_tcsc);
+
+    return passed ? 0 : 1;
+}